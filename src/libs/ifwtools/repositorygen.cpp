@@ -34,6 +34,7 @@
 #include "errors.h"
 #include "globals.h"
 #include "archivefactory.h"
+#include "binarydelta.h"
 #include "metadata.h"
 #include "settings.h"
 #include "qinstallerglobal.h"
@@ -72,6 +73,8 @@ void QInstallerTools::printRepositoryGenOptions()
     std::cout << "  --ignore-invalid-repositories Ignore all invalid repositories instead of aborting." << std::endl;
     std::cout << "  -s|--sha-update p1,...,pn List of packages which are updated using" <<std::endl;
     std::cout << "                            content sha1 instead of version number." << std::endl;
+    std::cout << "  --delta-from dir          Create binary deltas for changed archives against the" << std::endl;
+    std::cout << "                            repository in dir. This entry can be given multiple times." << std::endl;
 }
 
 QString QInstallerTools::makePathAbsolute(const QString &path)
@@ -364,6 +367,11 @@ void QInstallerTools::copyMetaData(const QString &_targetDir, const QString &met
                 contentSha1Element.appendChild(doc.createTextNode(info.contentSha1));
             }
 
+            if (!info.deltaArchives.isEmpty()) {
+                update.appendChild(doc.createElement(QLatin1String("DeltaArchives"))).appendChild(doc
+                    .createTextNode(info.deltaArchives.join(QChar::fromLatin1(','))));
+            }
+
             root.appendChild(update);
 
             // copy script files
@@ -1085,6 +1093,92 @@ void QInstallerTools::copyComponentData(const QStringList &packageDirs, const QS
     }
 }
 
+static QHash<QString, QString> packageVersions(const QString &repositoryDir)
+{
+    QHash<QString, QString> versions;
+    QDomDocument doc;
+    QFile file(repositoryDir + QLatin1String("/Updates.xml"));
+    if (!file.open(QFile::ReadOnly) || !doc.setContent(&file))
+        return versions;
+
+    const QDomNodeList children = doc.documentElement().childNodes();
+    for (int i = 0; i < children.count(); ++i) {
+        const QDomElement el = children.at(i).toElement();
+        if (el.isNull() || el.tagName() != QLatin1String("PackageUpdate"))
+            continue;
+        versions.insert(el.firstChildElement(scName).text(), el.firstChildElement(scVersion).text());
+    }
+    return versions;
+}
+
+static QByteArray archiveChecksum(const QString &archivePath)
+{
+    QFile hashFile(archivePath + QLatin1String(".sha1"));
+    if (hashFile.open(QIODevice::ReadOnly))
+        return hashFile.readAll().trimmed();
+
+    QFile archiveFile(archivePath);
+    QInstaller::openForRead(&archiveFile);
+    return QInstaller::calculateHash(&archiveFile, QCryptographicHash::Sha1).toHex();
+}
+
+/*
+    Creates a binary delta next to every new archive whose component is also contained in
+    one of the \a previousRepositoryDirs with a different archive. The delta is named after
+    the archive and the SHA-1 checksum of the previous archive, and listed in the
+    DeltaArchives element of the component. Deltas that do not save at least half of the
+    archive size are not kept.
+*/
+void QInstallerTools::createDeltaArchives(const QStringList &previousRepositoryDirs, const QString &repoDir,
+    PackageInfoVector *const infos)
+{
+    foreach (const QString &previousRepoDir, previousRepositoryDirs) {
+        const QHash<QString, QString> previousVersions = packageVersions(previousRepoDir);
+        if (previousVersions.isEmpty()) {
+            throw QInstaller::Error(QString::fromLatin1("Cannot read components of repository \"%1\".")
+                .arg(QDir::toNativeSeparators(previousRepoDir)));
+        }
+
+        for (int i = 0; i < infos->count(); ++i) {
+            const PackageInfo info = infos->at(i);
+            if (!info.metaFile.isEmpty() || !info.metaNode.isEmpty()
+                    || !previousVersions.contains(info.name)) {
+                continue;
+            }
+
+            const QString previousVersion = previousVersions.value(info.name);
+            foreach (const QString &file, info.copiedFiles) {
+                if (file.endsWith(QLatin1String(".sha1"), Qt::CaseInsensitive))
+                    continue;
+
+                const QString fileName = QFileInfo(file).fileName();
+                const QString archive = QString::fromLatin1("%1/%2/%3").arg(repoDir, info.name, fileName);
+                const QString previousArchive = QString::fromLatin1("%1/%2/%3%4").arg(previousRepoDir,
+                    info.name, previousVersion, fileName.mid(info.version.size()));
+                if (!QFileInfo::exists(previousArchive))
+                    continue;
+
+                const QByteArray baseChecksum = archiveChecksum(previousArchive);
+                if (baseChecksum == archiveChecksum(archive))
+                    continue;
+
+                const QString deltaFile = QString::fromLatin1("%1.%2.delta").arg(archive,
+                    QString::fromLatin1(baseChecksum));
+                qDebug() << "Creating binary delta" << deltaFile << "from" << previousArchive;
+                QInstaller::BinaryDelta::create(previousArchive, archive, deltaFile);
+
+                if (QFileInfo(deltaFile).size() > QFileInfo(archive).size() / 2) {
+                    qDebug() << "Discarding binary delta, it is not much smaller than the archive.";
+                    QFile::remove(deltaFile);
+                    continue;
+                }
+                (*infos)[i].deltaArchives.append(QString::fromLatin1("%1:%2")
+                    .arg(fileName.mid(info.version.size()), QString::fromLatin1(baseChecksum)));
+            }
+        }
+    }
+}
+
 void QInstallerTools::filterNewComponents(const QString &repositoryDir, QInstallerTools::PackageInfoVector &packages)
 {
     QDomDocument doc;
@@ -1189,6 +1283,8 @@ void QInstallerTools::createRepository(RepositoryInfo info, PackageInfoVector *p
         }
     }
     QInstallerTools::copyComponentData(directories, info.repositoryDir, packages, archiveSuffix, compression);
+    if (!info.deltaRepositories.isEmpty())
+        QInstallerTools::createDeltaArchives(info.deltaRepositories, info.repositoryDir, packages);
     QInstallerTools::copyMetaData(tmpMetaDir, info.repositoryDir, *packages, QLatin1String("{AnyApplication}"),
         QLatin1String(QUOTE(IFW_REPOSITORY_FORMAT_VERSION)), unite7zFiles);
 
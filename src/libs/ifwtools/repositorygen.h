@@ -52,6 +52,7 @@ struct IFWTOOLS_EXPORT PackageInfo
     QString metaNode;
     QString contentSha1;
     bool createContentSha1Node;
+    QStringList deltaArchives;
 };
 typedef QVector<PackageInfo> PackageInfoVector;
 typedef QInstaller::AbstractArchive::CompressionLevel Compression;
@@ -66,6 +67,7 @@ struct IFWTOOLS_EXPORT RepositoryInfo
     QStringList packages;
     QStringList repositoryPackages;
     QString repositoryDir;
+    QStringList deltaRepositories;
 };
 
 void IFWTOOLS_EXPORT printRepositoryGenOptions();
@@ -96,6 +98,9 @@ void IFWTOOLS_EXPORT copyComponentData(const QStringList &packageDir, const QStr
                                        PackageInfoVector *const infos, const QString &archiveSuffix,
                                        Compression compression = Compression::Normal);
 
+void IFWTOOLS_EXPORT createDeltaArchives(const QStringList &previousRepositoryDirs, const QString &repoDir,
+                                         PackageInfoVector *const infos);
+
 void IFWTOOLS_EXPORT filterNewComponents(const QString &repositoryDir, QInstallerTools::PackageInfoVector &packages);
 
 QString IFWTOOLS_EXPORT existingUniteMeta7z(const QString &repositoryDir);
@@ -0,0 +1,315 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "archivecache.h"
+
+#include "globals.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <algorithm>
+
+#define QUOTE_(x) #x
+#define QUOTE(x) QUOTE_(x)
+
+namespace QInstaller {
+
+static const QLatin1String scLastUsedFile(".lastused");
+
+/*!
+    \inmodule QtInstallerFramework
+    \class QInstaller::ArchiveCacheItem
+    \brief The ArchiveCacheItem class represents a downloaded component archive stored
+    in an ArchiveCache.
+
+    The item is a directory named after the SHA-1 checksum of the archive. It contains the
+    archive with its original file name, and a file recording when the archive was last used.
+*/
+
+/*!
+    Constructs a new empty item.
+*/
+ArchiveCacheItem::ArchiveCacheItem()
+    : CacheableItem()
+{
+}
+
+/*!
+    Constructs an item for the cache directory \a path. The checksum is the name
+    of the directory.
+*/
+ArchiveCacheItem::ArchiveCacheItem(const QString &path)
+    : CacheableItem(path)
+{
+}
+
+/*!
+    Constructs an item for the directory \a path containing an archive with the
+    SHA-1 \a checksum.
+*/
+ArchiveCacheItem::ArchiveCacheItem(const QString &path, const QByteArray &checksum)
+    : CacheableItem(path)
+    , m_checksum(checksum)
+{
+}
+
+/*!
+    Returns the hex encoded SHA-1 checksum of the archive.
+*/
+QByteArray ArchiveCacheItem::checksum() const
+{
+    if (m_checksum.isEmpty())
+        m_checksum = QFileInfo(path()).fileName().toLatin1();
+    return m_checksum;
+}
+
+/*!
+    Returns \c true if the item directory contains an archive. The content of the
+    archive is not verified here, it is hashed when the archive is used.
+*/
+bool ArchiveCacheItem::isValid() const
+{
+    return !archivePath().isEmpty();
+}
+
+/*!
+    Archives are never replaced by other items, they are only evicted by
+    ArchiveCache::evict(). Returns \c true.
+*/
+bool ArchiveCacheItem::isActive() const
+{
+    return true;
+}
+
+/*!
+    Returns \c false, an archive does not obsolete \a other items.
+*/
+bool ArchiveCacheItem::obsoletes(CacheableItem *other)
+{
+    Q_UNUSED(other)
+    return false;
+}
+
+/*!
+    Returns the absolute path of the archive, or an empty string if the item
+    directory does not contain one.
+*/
+QString ArchiveCacheItem::archivePath() const
+{
+    const QDir dir(path());
+    const QStringList files = dir.entryList(QDir::Files | QDir::Hidden);
+    for (const QString &file : files) {
+        if (file != scLastUsedFile)
+            return dir.absoluteFilePath(file);
+    }
+    return QString();
+}
+
+/*!
+    Returns the size of the archive in bytes.
+*/
+qint64 ArchiveCacheItem::size() const
+{
+    return QFileInfo(archivePath()).size();
+}
+
+/*!
+    Returns the time the archive was last used. Falls back to the modification
+    time of the archive if it was never recorded.
+*/
+QDateTime ArchiveCacheItem::lastUsed() const
+{
+    QFile file(path() + QLatin1Char('/') + scLastUsedFile);
+    if (file.open(QIODevice::ReadOnly)) {
+        bool ok = false;
+        const qint64 msecs = file.readAll().trimmed().toLongLong(&ok);
+        if (ok)
+            return QDateTime::fromMSecsSinceEpoch(msecs);
+    }
+    return QFileInfo(archivePath()).lastModified();
+}
+
+/*!
+    Records \a dateTime as the time the archive was last used.
+*/
+void ArchiveCacheItem::setLastUsed(const QDateTime &dateTime)
+{
+    QFile file(path() + QLatin1Char('/') + scLastUsedFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            || file.write(QByteArray::number(dateTime.toMSecsSinceEpoch())) == -1) {
+        qCWarning(QInstaller::lcInstallerInstallLog) << "Cannot update" << file.fileName()
+            << ":" << file.errorString();
+    }
+}
+
+
+/*!
+    \inmodule QtInstallerFramework
+    \class QInstaller::ArchiveCache
+    \brief The ArchiveCache class is a checksum based storage of downloaded component
+    archives on disk.
+
+    Archives are stored by the SHA-1 checksum published with them in the repository, so
+    installing the same component again, into another target directory or by another
+    installer using the same cache path, reuses the archive instead of downloading it.
+    The cache grows until evict() is called, which removes the least recently used
+    archives that were not used by the current session.
+*/
+
+/*!
+    Constructs a new empty cache. The cache is invalid until set with a
+    path and initialized.
+*/
+ArchiveCache::ArchiveCache()
+    : GenericDataCache<ArchiveCacheItem>()
+{
+    setType(QLatin1String("Archive"));
+    setVersion(QLatin1String(QUOTE(IFW_CACHE_FORMAT_VERSION)));
+}
+
+/*!
+    Constructs a cache to \a path. The cache is initialized automatically.
+*/
+ArchiveCache::ArchiveCache(const QString &path)
+    : GenericDataCache(path, QLatin1String("Archive"), QLatin1String(QUOTE(IFW_CACHE_FORMAT_VERSION)))
+{
+}
+
+/*!
+    Returns the path of the cached archive with the SHA-1 \a checksum, or an empty
+    string if there is none. The archive is marked as used by the current session and
+    is not evicted.
+*/
+QString ArchiveCache::archive(const QByteArray &checksum)
+{
+    ArchiveCacheItem *item = itemByChecksum(checksum);
+    if (!item)
+        return QString();
+
+    const QString archivePath = item->archivePath();
+    if (archivePath.isEmpty())
+        return QString();
+
+    item->setLastUsed(QDateTime::currentDateTime());
+    m_usedItems.insert(checksum);
+    return archivePath;
+}
+
+/*!
+    Moves the archive \a filePath with the SHA-1 \a checksum to the cache. On success,
+    \a cachedPath is set to the new location of the archive and \c true is returned.
+    On failure the archive is left at, or moved back to, \a filePath and \c false
+    is returned.
+*/
+bool ArchiveCache::insertArchive(const QString &filePath, const QByteArray &checksum,
+    QString *cachedPath)
+{
+    if (!isValid() || checksum.isEmpty())
+        return false;
+
+    const QString stagingPath = path() + QLatin1String("/staging-") + QString::fromLatin1(checksum);
+    const QString stagedFile = stagingPath + QLatin1Char('/') + QFileInfo(filePath).fileName();
+    if (!QDir().mkpath(stagingPath) || !QFile::rename(filePath, stagedFile)) {
+        qCWarning(QInstaller::lcInstallerInstallLog) << "Cannot move" << filePath
+            << "to archive cache" << path();
+        QDir().rmdir(stagingPath);
+        return false;
+    }
+
+    ArchiveCacheItem *item = new ArchiveCacheItem(stagingPath, checksum);
+    item->setLastUsed(QDateTime::currentDateTime());
+    if (!registerItem(item, true, GenericDataCache::Move)) {
+        qCWarning(QInstaller::lcInstallerInstallLog) << "Cannot register archive" << filePath
+            << "to cache:" << errorString();
+        // The item may have been moved already before the registration failed.
+        QFile::rename(item->path() + QLatin1Char('/') + QFileInfo(filePath).fileName(), filePath);
+        QDir().rmdir(item->path());
+        QDir().rmdir(stagingPath);
+        delete item;
+        return false;
+    }
+
+    m_usedItems.insert(checksum);
+    if (cachedPath)
+        *cachedPath = item->archivePath();
+    return true;
+}
+
+/*!
+    Returns the total size of the cached archives in bytes.
+*/
+qint64 ArchiveCache::size() const
+{
+    qint64 total = 0;
+    const QList<ArchiveCacheItem *> cachedItems = items();
+    for (const ArchiveCacheItem *item : cachedItems)
+        total += item->size();
+    return total;
+}
+
+/*!
+    Removes the least recently used archives until the cache is not larger than
+    \a maximumSize bytes. Archives used by the current session are kept, even if
+    the limit cannot be reached without them.
+*/
+void ArchiveCache::evict(qint64 maximumSize)
+{
+    struct Entry {
+        QByteArray checksum;
+        QDateTime lastUsed;
+        qint64 size;
+    };
+
+    QList<Entry> entries;
+    qint64 total = 0;
+    const QList<ArchiveCacheItem *> cachedItems = items();
+    for (const ArchiveCacheItem *item : cachedItems) {
+        const Entry entry { item->checksum(), item->lastUsed(), item->size() };
+        total += entry.size;
+        if (!m_usedItems.contains(entry.checksum))
+            entries.append(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs) {
+        return lhs.lastUsed < rhs.lastUsed;
+    });
+
+    for (const Entry &entry : std::as_const(entries)) {
+        if (total <= maximumSize)
+            break;
+        if (removeItem(entry.checksum)) {
+            qCDebug(QInstaller::lcInstallerInstallLog) << "Evicted archive" << entry.checksum
+                << "from cache.";
+            total -= entry.size;
+        }
+    }
+}
+
+} // namespace QInstaller
@@ -0,0 +1,80 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#ifndef ARCHIVECACHE_H
+#define ARCHIVECACHE_H
+
+#include "genericdatacache.h"
+
+#include <QDateTime>
+#include <QSet>
+
+namespace QInstaller {
+
+class INSTALLER_EXPORT ArchiveCacheItem : public CacheableItem
+{
+public:
+    ArchiveCacheItem();
+    explicit ArchiveCacheItem(const QString &path);
+    ArchiveCacheItem(const QString &path, const QByteArray &checksum);
+    ~ArchiveCacheItem() {}
+
+    QByteArray checksum() const override;
+    bool isValid() const override;
+    bool isActive() const override;
+    bool obsoletes(CacheableItem *other) override;
+
+    QString archivePath() const;
+    qint64 size() const;
+
+    QDateTime lastUsed() const;
+    void setLastUsed(const QDateTime &dateTime);
+
+private:
+    mutable QByteArray m_checksum;
+};
+
+class INSTALLER_EXPORT ArchiveCache : public GenericDataCache<ArchiveCacheItem>
+{
+public:
+    ArchiveCache();
+    explicit ArchiveCache(const QString &path);
+
+    QString archive(const QByteArray &checksum);
+    bool insertArchive(const QString &filePath, const QByteArray &checksum, QString *cachedPath);
+
+    qint64 size() const;
+    void evict(qint64 maximumSize);
+
+private:
+    QSet<QByteArray> m_usedItems;
+};
+
+} // namespace QInstaller
+
+#endif // ARCHIVECACHE_H
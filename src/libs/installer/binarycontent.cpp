@@ -203,6 +203,7 @@ void BinaryContent::readBinaryContent(QFile *file, QList<OperationBlob> *operati
         }
         // read the operations count
         qint64 operationsCount = QInstaller::retrieveInt64(file);
+        const qsizetype firstOperation = operations->count();
         // read the operations
         for (int i = 0; i < operationsCount; ++i) {
             const QString name = QInstaller::retrieveString(file);
@@ -211,6 +212,13 @@ void BinaryContent::readBinaryContent(QFile *file, QList<OperationBlob> *operati
         }
         // operations count
         Q_UNUSED(QInstaller::retrieveInt64(file)) // read it, but deliberately not used
+
+        // the optional operation index, not present in files written by older versions
+        if (file->pos() < layout.operationsSegment.end()
+                && QInstaller::retrieveInt64(file) == MagicOperationIndexMarker) {
+            for (qsizetype i = firstOperation; i < operations->count(); ++i)
+                (*operations)[i].component = QInstaller::retrieveString(file);
+        }
     }
 
     if (manager) {    // read the collection index and data
@@ -233,7 +241,8 @@ void BinaryContent::readBinaryContent(QFile *file, QList<OperationBlob> *operati
 
     \list
         \li Meta resources \a manager
-        \li Operations \a operations
+        \li Operations \a operations, followed by an index of the components that
+            performed them
         \li Resource collections \a manager
         \li Magic marker \a magicMarker
         \li Magic cookie \a magicCookie
@@ -275,6 +284,9 @@ void BinaryContent::writeBinaryContent(QFile *out, const QList<OperationBlob> &o
         QInstaller::appendString(out, operation.xml);
     }
     QInstaller::appendInt64(out, operations.count());
+    QInstaller::appendInt64(out, MagicOperationIndexMarker);
+    foreach (const OperationBlob &operation, operations)
+        QInstaller::appendString(out, operation.component);
     const Range<qint64> operationsSegment = Range<qint64>::fromStartAndEnd(pos, out->pos());
 
     // resource collections data and index
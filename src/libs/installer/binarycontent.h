@@ -47,6 +47,7 @@ public:
 
     static const qint64 MagicUpdaterMarker = 0x12023235UL;
     static const qint64 MagicPackageManagerMarker = 0x12023236UL;
+    static const qint64 MagicOperationIndexMarker = 0x12023237UL;
 
     // additional distinguishers only used at runtime, not written to the binary itself
     enum MagicMarkerSupplement {
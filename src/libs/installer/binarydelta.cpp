@@ -0,0 +1,365 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "binarydelta.h"
+
+#include "errors.h"
+#include "fileio.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QMultiHash>
+
+#include <array>
+#include <cstring>
+
+namespace QInstaller {
+
+static const QByteArray scDeltaMagic("IFWDELTA");
+static const qint64 scDeltaFormatVersion = 1;
+
+static const qint64 scMinChunkSize = 2 * 1024;
+static const qint64 scMaxChunkSize = 64 * 1024;
+// 13 bits of the rolling hash, chunks are about 8 KiB large on average
+static const quint64 scChunkMask = Q_UINT64_C(0x1FFF) << 51;
+// Files are read, written and hashed in blocks of at most this size.
+static const qint64 scBlockSize = 1024 * 1024;
+
+enum DeltaOperation : char {
+    EndOperation = 0,
+    CopyOperation = 1,
+    InsertOperation = 2
+};
+
+struct Chunk
+{
+    qint64 offset;
+    qint64 size;
+};
+
+static const std::array<quint64, 256> &gearTable()
+{
+    static const std::array<quint64, 256> table = [] {
+        // splitmix64, the table must be the same for every delta producer and consumer
+        std::array<quint64, 256> values;
+        quint64 state = 0;
+        for (quint64 &value : values) {
+            state += Q_UINT64_C(0x9E3779B97F4A7C15);
+            quint64 z = state;
+            z = (z ^ (z >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+            z = (z ^ (z >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+            value = z ^ (z >> 31);
+        }
+        return values;
+    }();
+    return table;
+}
+
+/*
+    Returns the size of the chunk starting at \a data. Chunk boundaries depend on
+    the content only, so an insertion shifts the data without changing the chunks
+    following it.
+*/
+static qint64 nextChunkSize(const uchar *data, qint64 size)
+{
+    if (size <= scMinChunkSize)
+        return size;
+
+    const std::array<quint64, 256> &gear = gearTable();
+    const qint64 maximum = qMin(size, scMaxChunkSize);
+    quint64 hash = 0;
+    for (qint64 i = 0; i < maximum; ++i) {
+        hash = (hash << 1) + gear[data[i]];
+        if (i >= scMinChunkSize && !(hash & scChunkMask))
+            return i + 1;
+    }
+    return maximum;
+}
+
+static void seekFile(QFile *file, qint64 offset)
+{
+    if (!file->seek(offset)) {
+        throw Error(QCoreApplication::translate("BinaryDelta", "Cannot seek in file \"%1\": %2")
+            .arg(file->fileName(), file->errorString()));
+    }
+}
+
+/*
+    Splits a file into content defined chunks. The file is read in blocks, only the
+    current block and the remainder of the previous one are kept in memory.
+*/
+class ChunkReader
+{
+public:
+    explicit ChunkReader(QFile *file)
+        : m_file(file)
+        , m_size(file->size())
+        , m_read(0)
+        , m_position(0)
+    {}
+
+    /*
+        Returns the next chunk of the file and sets \a data to its content, which stays
+        valid until the next call. Returns a chunk of size 0 at the end of the file.
+    */
+    Chunk next(const char **data)
+    {
+        // A chunk can only be split at the same position as in the whole file if the
+        // maximum chunk size is available, or the end of the file is in the buffer.
+        if (m_buffer.size() - m_position < scMaxChunkSize && m_read < m_size) {
+            m_buffer.remove(0, int(m_position));
+            m_position = 0;
+            const qint64 size = qMin(scBlockSize, m_size - m_read);
+            m_buffer += QInstaller::retrieveData(m_file, size);
+            m_read += size;
+        }
+
+        const qint64 available = m_buffer.size() - m_position;
+        *data = m_buffer.constData() + m_position;
+        const Chunk chunk { m_read - available,
+            nextChunkSize(reinterpret_cast<const uchar *>(*data), available) };
+        m_position += chunk.size;
+        return chunk;
+    }
+
+private:
+    QFile *const m_file;
+    const qint64 m_size;
+    qint64 m_read;
+    qint64 m_position;
+    QByteArray m_buffer;
+};
+
+/*!
+    \inmodule QtInstallerFramework
+    \class QInstaller::BinaryDelta
+    \brief The BinaryDelta class creates and applies binary differences between two files.
+
+    A delta describes the target file as a sequence of ranges copied from the base file
+    and of literal data. Both files are split into content defined chunks, and every
+    chunk of the target that also exists in the base is copied from there. This keeps
+    deltas small for archives where only a few of the contained files changed, as long
+    as the archive is not compressed as a single solid block.
+
+    The delta contains the size and SHA-1 checksum of the target file, which are verified
+    when the delta is applied.
+*/
+
+/*!
+    Creates a delta from \a baseFileName to \a targetFileName and writes it to
+    \a deltaFileName. Throws QInstaller::Error on failure.
+*/
+void BinaryDelta::create(const QString &baseFileName, const QString &targetFileName,
+    const QString &deltaFileName)
+{
+    QFile base(baseFileName);
+    QInstaller::openForRead(&base);
+    QFile target(targetFileName);
+    QInstaller::openForRead(&target);
+    const qint64 baseSize = base.size();
+    const qint64 targetSize = target.size();
+
+    QMultiHash<size_t, Chunk> chunks;
+    const char *data = nullptr;
+    ChunkReader baseChunks(&base);
+    for (Chunk chunk = baseChunks.next(&data); chunk.size > 0; chunk = baseChunks.next(&data))
+        chunks.insert(qHashBits(data, size_t(chunk.size)), chunk);
+
+    QFile delta(deltaFileName);
+    QInstaller::openForWrite(&delta);
+    QInstaller::blockingWrite(&delta, scDeltaMagic);
+    QInstaller::appendInt64(&delta, scDeltaFormatVersion);
+    QInstaller::appendInt64(&delta, baseSize);
+    QInstaller::appendInt64(&delta, targetSize);
+    // The checksum of the target is written once the whole target has been read.
+    const qint64 checksumPosition = delta.pos();
+    QInstaller::blockingWrite(&delta, QByteArray(20, '\0'));
+
+    Chunk pendingCopy { 0, 0 };
+    QByteArray pendingInsert;
+    pendingInsert.reserve(int(scBlockSize + scMaxChunkSize));
+    auto flushCopy = [&]() {
+        if (pendingCopy.size == 0)
+            return;
+        const char operation = CopyOperation;
+        QInstaller::blockingWrite(&delta, &operation, 1);
+        QInstaller::appendInt64(&delta, pendingCopy.offset);
+        QInstaller::appendInt64(&delta, pendingCopy.size);
+        pendingCopy.size = 0;
+    };
+    auto flushInsert = [&]() {
+        if (pendingInsert.isEmpty())
+            return;
+        const char operation = InsertOperation;
+        QInstaller::blockingWrite(&delta, &operation, 1);
+        QInstaller::appendInt64(&delta, pendingInsert.size());
+        QInstaller::blockingWrite(&delta, pendingInsert);
+        pendingInsert.resize(0);
+    };
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    QByteArray baseChunk;
+    ChunkReader targetChunks(&target);
+    for (Chunk chunk = targetChunks.next(&data); chunk.size > 0; chunk = targetChunks.next(&data)) {
+        hash.addData(QByteArray::fromRawData(data, int(chunk.size)));
+
+        // Chunks with the same hash are compared, they can still differ.
+        qint64 baseOffset = -1;
+        const size_t key = qHashBits(data, size_t(chunk.size));
+        for (auto it = chunks.constFind(key); it != chunks.cend() && it.key() == key; ++it) {
+            if (it->size != chunk.size)
+                continue;
+            seekFile(&base, it->offset);
+            baseChunk.resize(int(it->size));
+            QInstaller::blockingRead(&base, baseChunk.data(), it->size);
+            if (std::memcmp(baseChunk.constData(), data, size_t(chunk.size)) == 0) {
+                baseOffset = it->offset;
+                break;
+            }
+        }
+
+        if (baseOffset < 0) {
+            flushCopy();
+            // Consecutive insert operations keep the memory for literal data bounded.
+            pendingInsert.append(data, int(chunk.size));
+            if (pendingInsert.size() >= scBlockSize)
+                flushInsert();
+        } else {
+            flushInsert();
+            if (pendingCopy.size > 0 && pendingCopy.offset + pendingCopy.size != baseOffset)
+                flushCopy();
+            if (pendingCopy.size == 0)
+                pendingCopy.offset = baseOffset;
+            pendingCopy.size += chunk.size;
+        }
+    }
+    flushCopy();
+    flushInsert();
+
+    const char operation = EndOperation;
+    QInstaller::blockingWrite(&delta, &operation, 1);
+
+    seekFile(&delta, checksumPosition);
+    QInstaller::blockingWrite(&delta, hash.result());
+}
+
+/*!
+    Reconstructs \a targetFileName from \a baseFileName and the delta \a deltaFileName.
+    Returns the hex encoded SHA-1 checksum of the reconstructed file. Throws
+    QInstaller::Error if the delta is invalid, was not created for \a baseFileName,
+    or the result does not match the checksum stored in the delta.
+*/
+QByteArray BinaryDelta::apply(const QString &baseFileName, const QString &deltaFileName,
+    const QString &targetFileName)
+{
+    QFile delta(deltaFileName);
+    QInstaller::openForRead(&delta);
+    if (QInstaller::retrieveData(&delta, scDeltaMagic.size()) != scDeltaMagic
+            || QInstaller::retrieveInt64(&delta) != scDeltaFormatVersion) {
+        throw Error(QCoreApplication::translate("BinaryDelta",
+            "File \"%1\" is not a supported binary delta.").arg(deltaFileName));
+    }
+
+    QFile base(baseFileName);
+    QInstaller::openForRead(&base);
+    const qint64 baseSize = QInstaller::retrieveInt64(&delta);
+    if (base.size() != baseSize) {
+        throw Error(QCoreApplication::translate("BinaryDelta",
+            "Binary delta \"%1\" was not created for \"%2\".").arg(deltaFileName, baseFileName));
+    }
+    const qint64 targetSize = QInstaller::retrieveInt64(&delta);
+    const QByteArray expectedChecksum = QInstaller::retrieveData(&delta, 20);
+
+    QFile target(targetFileName);
+    QInstaller::openForWrite(&target);
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    qint64 written = 0;
+    // Writes a block of at most scBlockSize bytes to the target.
+    auto write = [&](const char *data, qint64 size) {
+        if (size < 0 || written + size > targetSize) {
+            throw Error(QCoreApplication::translate("BinaryDelta",
+                "Binary delta \"%1\" is corrupt.").arg(deltaFileName));
+        }
+        QInstaller::blockingWrite(&target, data, size);
+        hash.addData(QByteArray::fromRawData(data, int(size)));
+        written += size;
+    };
+
+    QByteArray buffer;
+
+    for (bool finished = false; !finished;) {
+        char operation = EndOperation;
+        QInstaller::blockingRead(&delta, &operation, 1);
+        switch (operation) {
+        case EndOperation:
+            finished = true;
+            break;
+        case CopyOperation: {
+            const qint64 offset = QInstaller::retrieveInt64(&delta);
+            const qint64 size = QInstaller::retrieveInt64(&delta);
+            if (offset < 0 || size < 0 || offset > baseSize - size || size > targetSize - written) {
+                throw Error(QCoreApplication::translate("BinaryDelta",
+                    "Binary delta \"%1\" is corrupt.").arg(deltaFileName));
+            }
+            seekFile(&base, offset);
+            for (qint64 remaining = size; remaining > 0;) {
+                const qint64 blockSize = qMin(remaining, scBlockSize);
+                buffer.resize(int(blockSize));
+                QInstaller::blockingRead(&base, buffer.data(), blockSize);
+                write(buffer.constData(), blockSize);
+                remaining -= blockSize;
+            }
+            break;
+        }
+        case InsertOperation: {
+            qint64 remaining = QInstaller::retrieveInt64(&delta);
+            while (remaining > 0) {
+                const QByteArray data = QInstaller::retrieveData(&delta,
+                    qMin(remaining, scBlockSize));
+                write(data.constData(), data.size());
+                remaining -= data.size();
+            }
+            break;
+        }
+        default:
+            throw Error(QCoreApplication::translate("BinaryDelta",
+                "Binary delta \"%1\" is corrupt.").arg(deltaFileName));
+        }
+    }
+
+    const QByteArray checksum = hash.result();
+    if (written != targetSize || checksum != expectedChecksum) {
+        throw Error(QCoreApplication::translate("BinaryDelta",
+            "Checksum mismatch after applying binary delta \"%1\".").arg(deltaFileName));
+    }
+    return checksum.toHex();
+}
+
+} // namespace QInstaller
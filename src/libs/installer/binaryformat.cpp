@@ -45,10 +45,11 @@ namespace QInstaller {
 */
 
 /*!
-    \fn QInstaller::OperationBlob::OperationBlob(const QString &n, const QString &x)
+    \fn QInstaller::OperationBlob::OperationBlob(const QString &n, const QString &x, const QString &c)
 
-    Constructs the operation blob with the given arguments, while \a n stands for the name part and
-    \a x for the XML representation of the operation.
+    Constructs the operation blob with the given arguments, while \a n stands for the name part,
+    \a x for the XML representation of the operation, and \a c for the name of the component
+    that performed the operation.
 */
 
 /*!
@@ -61,6 +62,14 @@ namespace QInstaller {
     \brief The XML representation of the operation.
 */
 
+/*!
+    \variable QInstaller::OperationBlob::component
+    \brief The name of the component that performed the operation.
+
+    The value is read from the operation index and can be empty if the binary
+    content does not contain one.
+*/
+
 /*!
     \class QInstaller::Resource
     \inmodule QtInstallerFramework
@@ -149,6 +158,16 @@ void Resource::setName(const QByteArray &name)
     m_name = name;
 }
 
+/*!
+    Returns the name of the file that contains the data of the resource.
+
+    \sa segment()
+*/
+QString Resource::fileName() const
+{
+    return m_file.fileName();
+}
+
 /*!
     Opens a resource in QIODevice::ReadOnly mode. The function returns \c true
     if successful. Optionally, \a permissions can be given.
@@ -40,10 +40,11 @@
 namespace QInstaller {
 
 struct OperationBlob {
-    OperationBlob(const QString &n, const QString &x)
-        : name(n), xml(x) {}
+    OperationBlob(const QString &n, const QString &x, const QString &c = QString())
+        : name(n), xml(x), component(c) {}
     QString name;
     QString xml;
+    QString component;
 };
 
 
@@ -71,6 +72,8 @@ public:
     QByteArray name() const;
     void setName(const QByteArray &name);
 
+    QString fileName() const;
+
     Range<qint64> segment() const { return m_segment; }
     void setSegment(const Range<qint64> &segment) { m_segment = segment; }
 
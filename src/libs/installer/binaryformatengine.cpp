@@ -27,67 +27,10 @@
 **************************************************************************/
 
 #include "binaryformatengine.h"
+#include "stringlistiterator_p.h"
 
 #include <QRegularExpression>
 
-namespace {
-
-class StringListIterator : public QAbstractFileEngineIterator
-{
-public:
-    StringListIterator(const QString &path, const QStringList &list, QDir::Filters filters, const QStringList &nameFilters)
-#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
-        : QAbstractFileEngineIterator(path, filters, nameFilters)
-#else
-        : QAbstractFileEngineIterator(filters, nameFilters)
-#endif
-        , list(list)
-        , index(-1)
-    {
-    }
-#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
-    StringListIterator(const QString &path, const QStringList &list, QDirListing::IteratorFlags filters, const QStringList &nameFilters)
-
-        : QAbstractFileEngineIterator(path, filters, nameFilters)
-        , list(list)
-        , index(-1)
-    {
-    }
-
-    bool advance() override
-    {
-        if (index < list.size() - 1) {
-            ++index;
-            return true;
-        }
-        return false;
-    }
-#else
-    bool hasNext() const override
-    {
-        return index < list.size() - 1;
-    }
-
-    QString next() override
-    {
-        if(!hasNext())
-            return QString();
-        ++index;
-        return currentFilePath();
-    }
-#endif
-    QString currentFileName() const override
-    {
-        return index < 0 ? QString() : list[index];
-    }
-
-private:
-    const QStringList list;
-    int index;
-};
-
-} // anon namespace
-
 namespace QInstaller {
 
 /*!
@@ -247,6 +247,19 @@ CommandLineParser::CommandLineParser()
                       "to let the application determine the ideal thread count from the amount of logical "
                       "processor cores in the system."),
         QLatin1String("threads")));
+    addOption(QCommandLineOption(QStringList() << CommandLineOptions::scScriptProfileLong,
+        QLatin1String("Measures the time spent in component and control script functions and "
+                      "writes it to the given file in the Chrome trace event format on exit."),
+        QLatin1String("file")));
+    addOption(QCommandLineOption(QStringList() << CommandLineOptions::scScriptProfileThresholdLong,
+        QLatin1String("Logs a warning for every script function call that takes longer than the "
+                      "given time in milliseconds."),
+        QLatin1String("msecs")));
+    addOption(QCommandLineOption(QStringList() << CommandLineOptions::scTraceFileLong,
+        QLatin1String("Records the time spent in the major phases of the installation, like reading "
+                      "the metadata, downloading, unpacking and installing, and writes it to the given "
+                      "file in the Chrome trace event format on exit."),
+        QLatin1String("file")));
 
     QCommandLineOption cleanupUpdate(CommandLineOptions::scCleanupUpdate);
     cleanupUpdate.setValueName(QLatin1String("path"));
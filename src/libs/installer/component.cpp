@@ -27,12 +27,14 @@
 **************************************************************************/
 #include "component.h"
 #include "scriptengine.h"
+#include "scriptprofiler.h"
 
 #include "errors.h"
 #include "fileutils.h"
 #include "globals.h"
 #include "archivefactory.h"
 #include "messageboxhandler.h"
+#include "metaarchiveenginehandler.h"
 #include "packagemanagercore.h"
 #include "remoteclient.h"
 #include "settings.h"
@@ -72,6 +74,12 @@
 
 using namespace QInstaller;
 
+// The install plan sums up the sizes and admin rights of the components.
+static bool isInstallPlanValue(const QString &key)
+{
+    return key == scUncompressedSize || key == scCompressedSize || key == scRequiresAdminRights;
+}
+
 /*!
     \enum QInstaller::Component::UnstableError
 
@@ -359,6 +367,7 @@ void Component::loadDataFromPackage(const Package &package)
     setValue(scForcedInstallation, forced);
     setValue(scContentSha1, package.data(scContentSha1).toString());
     setValue(scCheckSha1CheckSum, package.data(scCheckSha1CheckSum, scTrue).toString().toLower());
+    setValue(scDeltaArchives, package.data(scDeltaArchives).toString());
 
     const auto treeNamePair = package.data(scTreeName).value<QPair<QString, bool>>();
     setValue(scTreeName, treeNamePair.first);
@@ -369,21 +378,65 @@ void Component::loadDataFromPackage(const Package &package)
 
     setLocalTempPath(QInstaller::pathFromUrl(package.packageSource().url));
 
-    const QStringList uiList = QInstaller::splitStringWithComma(package.data(scUserInterfaces).toString());
-    if (!uiList.isEmpty())
-        loadUserInterfaces(QDir(scTwoArgs.arg(localTempPath(), name())), uiList);
-
+    d->m_userInterfaceFilters = QInstaller::splitStringWithComma(package.data(scUserInterfaces).toString());
 #ifndef IFW_DISABLE_TRANSLATIONS
-    const QStringList qms = QInstaller::splitStringWithComma(package.data(scTranslations).toString());
-    if (!qms.isEmpty())
-        loadTranslations(QDir(scTwoArgs.arg(localTempPath(), name())), qms);
+    d->m_translationFilters = QInstaller::splitStringWithComma(package.data(scTranslations).toString());
 #endif
-    QHash<QString, QVariant> licenseHash = package.data(scLicenses).toHash();
-    if (!licenseHash.isEmpty())
-        loadLicenses(scTwoArgs.arg(localTempPath(), name()), licenseHash);
+    d->m_licenseHash = package.data(scLicenses).toHash();
     QVariant operationsVariant = package.data(scOperations);
     if (operationsVariant.canConvert<QList<QPair<QString, QVariant>>>())
         m_operationsList = operationsVariant.value<QList<QPair<QString, QVariant>>>();
+
+    // The meta data directory is missing if the meta data archive of the component
+    // is fetched on demand, see loadDeferredMetaData().
+    const bool hasMetaFiles = !d->m_scriptHash.isEmpty() || !d->m_userInterfaceFilters.isEmpty()
+        || !d->m_translationFilters.isEmpty() || !d->m_licenseHash.isEmpty();
+    updateMetaDirectory();
+    d->m_metaDataDeferred = hasMetaFiles && !QFileInfo::exists(metaDirectory());
+    if (!d->m_metaDataDeferred)
+        loadMetaFiles();
+}
+
+/*!
+    \internal
+    Returns the meta data directory of the component, ending with a forward slash. If the
+    meta data of the component is packed in the cache, the virtual directory of the meta
+    data archive is returned.
+*/
+QString Component::metaDirectory() const
+{
+    if (d->m_metaDirectory.isEmpty())
+        return scTwoArgs.arg(localTempPath(), name());
+    return d->m_metaDirectory;
+}
+
+/*!
+    \internal
+    Looks up the meta data directory of the component after its meta data is loaded to
+    the cache. If the meta data is packed, the meta data archive is registered with
+    MetaArchiveEngineHandler.
+*/
+void Component::updateMetaDirectory()
+{
+    const QString archivePath = MetaArchiveEngineHandler::archivePath(localTempPath(), name());
+    d->m_metaDirectory = QFileInfo::exists(archivePath)
+        ? MetaArchiveEngineHandler::instance()->registerArchive(archivePath) : QString();
+}
+
+/*!
+    \internal
+    Loads the user interfaces, translations, and licenses referenced in the package.xml
+    from the meta data directory of the component.
+*/
+void Component::loadMetaFiles()
+{
+    const QString directory = metaDirectory();
+    if (!d->m_userInterfaceFilters.isEmpty())
+        loadUserInterfaces(QDir(directory), d->m_userInterfaceFilters);
+    if (!d->m_translationFilters.isEmpty())
+        loadTranslations(QDir(directory), d->m_translationFilters);
+    if (!d->m_licenseHash.isEmpty())
+        loadLicenses(directory, d->m_licenseHash);
 }
 
 /*!
@@ -397,7 +450,7 @@ quint64 Component::updateUncompressedSize()
         || installAction() == ComponentModelHelper::KeepInstalled);
 
     if (installOrKeepInstalled)
-        size = d->m_vars.value(scUncompressedSize).toLongLong();
+        size = d->m_uncompressedSize;
 
     foreach (Component* comp, d->m_allChildComponents)
         size += comp->updateUncompressedSize();
@@ -411,6 +464,30 @@ quint64 Component::updateUncompressedSize()
     return size;
 }
 
+/*!
+    Returns the sorting priority of the component.
+*/
+int Component::sortingPriority() const
+{
+    return d->m_sortingPriority;
+}
+
+/*!
+    Returns the size of the compressed archives of the component.
+*/
+quint64 Component::compressedSize() const
+{
+    return d->m_compressedSize;
+}
+
+/*!
+    Returns the size of the component content after extraction.
+*/
+quint64 Component::uncompressedSize() const
+{
+    return d->m_uncompressedSize;
+}
+
 /*!
     Marks the component as installed.
 */
@@ -448,7 +525,10 @@ QString Component::value(const QString &key, const QString &defaultValue) const
 */
 int Component::removeValue(const QString &key)
 {
-    return d->m_vars.remove(key);
+    const int removed = d->removeVariable(key);
+    if (removed && isInstallPlanValue(key))
+        d->m_core->clearInstallPlan();
+    return removed;
 }
 
 /*!
@@ -484,7 +564,9 @@ void Component::setValue(const QString &key, const QString &value)
     if (key == scLocalDependencies)
         packageManagerCore()->createLocalDependencyHash(name(), normalizedValue);
 
-    d->m_vars[key] = normalizedValue;
+    d->setVariable(key, normalizedValue);
+    if (isInstallPlanValue(key))
+        d->m_core->clearInstallPlan();
     emit valueChanged(key, normalizedValue);
 }
 
@@ -571,6 +653,15 @@ QString Component::name() const
     return d->m_componentName;
 }
 
+/*!
+    Returns the version of this component, split into its components once when the
+    version is set.
+*/
+KDUpdater::VersionKey Component::versionKey() const
+{
+    return d->m_versionKey;
+}
+
 /*!
     Contains this component's display name as visible to the user.
 */
@@ -605,16 +696,110 @@ bool Component::treeNameMoveChildren() const
     \a postLoad \c true to a list of components that are updated or installed
     to improve performance if the amount of components is huge and there are no script
     functions that need to be called before the installation starts.
+
+    A script that is evaluated on demand is not evaluated here, but only marked to be
+    evaluated by loadDeferredScript().
+
+    \sa isScriptOnDemand()
 */
 void Component::loadComponentScript(const bool postLoad)
+{
+    if (!postLoad && isScriptOnDemand()) {
+        d->m_scriptDeferred = !componentScriptPath().isEmpty();
+        return;
+    }
+
+    const QString scriptPath = componentScriptPath(postLoad);
+    if (!scriptPath.isEmpty())
+        evaluateComponentScript(scriptPath, postLoad);
+}
+
+/*!
+    Returns \c true if the meta data archive of the component is fetched on demand and
+    has not been loaded yet. The component script, user interfaces, translations, and
+    licenses of the component are not available until loadDeferredMetaData() is called.
+*/
+bool Component::isMetaDataDeferred() const
+{
+    return d->m_metaDataDeferred;
+}
+
+/*!
+    Loads the user interfaces, translations, and licenses of a component whose meta data
+    archive was fetched on demand, and loads the component script. Does nothing if the
+    meta data of the component is not deferred.
+
+    Throws QInstaller::Error if the meta data directory is missing or its files cannot
+    be loaded.
+*/
+void Component::loadDeferredMetaData()
+{
+    if (!d->m_metaDataDeferred)
+        return;
+    d->m_metaDataDeferred = false;
+
+    updateMetaDirectory();
+    const QString directory = metaDirectory();
+    if (!QFileInfo::exists(directory)) {
+        throw Error(tr("Missing meta data of component \"%1\" in \"%2\".\n\n%3 \"%4\"").arg(name(),
+            QDir::toNativeSeparators(directory), tr(scClearCacheHint),
+            packageManagerCore()->settings().localCachePath()));
+    }
+    loadMetaFiles();
+    loadComponentScript();
+}
+
+/*!
+    Returns \c true if the component script is evaluated on demand, as set with the
+    \c onDemand attribute of the \c <Script> element. Such a script is evaluated only
+    when the component is selected for installation or update, or when its default
+    state is decided by the script.
+
+    \sa isScriptDeferred(), loadDeferredScript()
+*/
+bool Component::isScriptOnDemand() const
+{
+    return d->m_scriptHash.value(scOnDemandScript).toBool();
+}
+
+/*!
+    Returns \c true if the component script is evaluated on demand and has not been
+    evaluated yet.
+*/
+bool Component::isScriptDeferred() const
+{
+    return d->m_scriptDeferred;
+}
+
+/*!
+    Evaluates the component script if it is evaluated on demand and has not been
+    evaluated yet. Does nothing otherwise.
+
+    Throws QInstaller::Error if the script cannot be evaluated and unstable components
+    are not allowed.
+*/
+void Component::loadDeferredScript()
+{
+    if (!d->m_scriptDeferred)
+        return;
+    d->m_scriptDeferred = false;
+    evaluateComponentScript(componentScriptPath());
+}
+
+/*!
+    \internal
+    Returns the path of the component script that is loaded if \a postLoad is \c false, or
+    of the script that is loaded before the installation if \a postLoad is \c true. Returns
+    an empty string if the component has no such script.
+*/
+QString Component::componentScriptPath(const bool postLoad) const
 {
     const QString installScript(!postLoad ? d->m_scriptHash.value(scInstallScript).toString()
                                       : d->m_scriptHash.value(scPostLoadScript).toString());
 
-    if (!localTempPath().isEmpty() && !installScript.isEmpty()) {
-        evaluateComponentScript(scThreeArgs.arg(localTempPath(), name()
-                        , installScript), postLoad);
-    }
+    if (localTempPath().isEmpty() || installScript.isEmpty())
+        return QString();
+    return metaDirectory() + installScript;
 }
 
 /*!
@@ -625,6 +810,8 @@ void Component::evaluateComponentScript(const QString &fileName, const bool post
     // introduce the component object as javascript value and call the name to check that it
     // was successful
     try {
+        ScriptProfiler::Scope profile(name(), postScriptContent ? QLatin1String("<load postLoad script>")
+            : QLatin1String("<load script>"));
         if (postScriptContent) {
             d->m_postScriptContext = d->scriptEngine()->loadInContext(scComponent, fileName,
                 scComponentScriptTest.arg(name()));
@@ -999,6 +1186,7 @@ void Component::addDownloadableArchive(const QString &path)
     Q_ASSERT(isFromOnlineRepository());
     qCDebug(QInstaller::lcDeveloperBuild) << "addDownloadable" << path;
     d->m_downloadableArchives.append(d->m_vars.value(scVersion) + path);
+    d->m_core->clearInstallPlan();
 }
 
 /*!
@@ -1020,17 +1208,20 @@ void Component::addDownloadableArchives(const QString& archives)
 void Component::removeDownloadableArchive(const QString &path)
 {
     Q_ASSERT(isFromOnlineRepository());
-    d->m_downloadableArchives.removeAll(path);
+    if (d->m_downloadableArchives.removeAll(path) > 0)
+        d->m_core->clearInstallPlan();
 }
 
 /*!
     Returns the archives to be downloaded from the online repository before installation.
-    Should be called only once when the installation starts.
+    The archives listed in the package information are added on the first call.
 */
 QStringList Component::downloadableArchives()
 {
     const QStringList downloadableArchives = d->m_downloadableArchivesVariable
                 .split(QInstaller::commaRegExp(), Qt::SkipEmptyParts);
+    // The install plan is calculated again whenever the selection changes.
+    d->m_downloadableArchivesVariable.clear();
     foreach (const QString downloadableArchive, downloadableArchives)
         addDownloadableArchive(downloadableArchive);
 
@@ -1234,8 +1425,13 @@ QJSValue Component::callScriptMethod(const QString &methodName, const QJSValueLi
         scriptContext = d->m_postScriptContext;
     else
         scriptContext = d->m_scriptContext;
-    return d->scriptEngine()->callScriptMethod(scriptContext,
+
+    ScriptProfiler::Scope profile(name(), methodName);
+    const QJSValue result = d->scriptEngine()->callScriptMethod(scriptContext,
             methodName, arguments);
+    if (result.isUndefined())
+        profile.discard(); // not implemented by the script
+    return result;
 }
 
 namespace {
@@ -1352,7 +1548,7 @@ void Component::setAutoCreateOperations(bool autoCreateOperations)
 */
 bool Component::isVirtual() const
 {
-    return d->m_vars.value(scVirtual, scFalse).toLower() == scTrue;
+    return d->testAttributeFlag(ComponentPrivate::VirtualFlag);
 }
 
 /*!
@@ -1368,7 +1564,7 @@ bool Component::isSelected() const
 */
 bool Component::forcedInstallation() const
 {
-    return d->m_vars.value(scForcedInstallation, scFalse).toLower() == scTrue;
+    return d->testAttributeFlag(ComponentPrivate::ForcedInstallationFlag);
 }
 
 /*!
@@ -1377,7 +1573,15 @@ bool Component::forcedInstallation() const
 */
 bool Component::isEssential() const
 {
-    return d->m_vars.value(scEssential, scFalse).toLower() == scTrue;
+    return d->testAttributeFlag(ComponentPrivate::EssentialFlag);
+}
+
+/*!
+    Returns whether this component requires admin rights to be installed.
+*/
+bool Component::requiresAdminRights() const
+{
+    return d->testAttributeFlag(ComponentPrivate::RequiresAdminRightsFlag);
 }
 
 /*!
@@ -1506,7 +1710,7 @@ bool Component::isAutoDependOn(const QSet<QString> &componentsToInstall) const
         if (componentsToInstall.contains(autoDependOnSet)) {
             foreach (const QString &autoDep, autoDependOnSet) {
                 Component *component = packageManagerCore()->componentByName(autoDep);
-                if ((component->value(scEssential, scFalse).toLower() == scTrue)
+                if (component->isEssential()
                         || component->isForcedUpdate()) {
                     return true;
                 }
@@ -1770,7 +1974,7 @@ void Component::updateModelData(const QString &key, const QString &data)
         setData(data, ReleaseDate);
 
     if (key == scUncompressedSize) {
-        quint64 size = d->m_vars.value(scUncompressedSizeSum).toLongLong();
+        quint64 size = d->m_uncompressedSizeSum;
         setData(humanReadableSize(size), UncompressedSize);
     }
 
@@ -83,8 +83,8 @@ public:
     {
         bool operator() (const Component *lhs, const Component *rhs) const
         {
-            const int lhsPriority = lhs->value(scSortingPriority).toInt();
-            const int rhsPriority = rhs->value(scSortingPriority).toInt();
+            const int lhsPriority = lhs->sortingPriority();
+            const int rhsPriority = rhs->sortingPriority();
             if (lhsPriority == rhsPriority)
                 return lhs->displayName() > rhs->displayName();
             return lhsPriority < rhsPriority;
@@ -95,8 +95,8 @@ public:
     {
         bool operator() (const Component *lhs, const Component *rhs) const
         {
-            const int lhsPriority = lhs->value(scSortingPriority).toInt();
-            const int rhsPriority = rhs->value(scSortingPriority).toInt();
+            const int lhsPriority = lhs->sortingPriority();
+            const int rhsPriority = rhs->sortingPriority();
             if (lhsPriority == rhsPriority)
                 return lhs->displayName() < rhs->displayName();
             return lhsPriority > rhsPriority;
@@ -119,7 +119,13 @@ public:
     void removeComponent(Component *component);
     QList<Component*> descendantComponents() const;
 
+    QString componentScriptPath(const bool postLoad = false) const;
     void loadComponentScript(const bool postLoad = false);
+    bool isMetaDataDeferred() const;
+    void loadDeferredMetaData();
+    bool isScriptOnDemand() const;
+    bool isScriptDeferred() const;
+    void loadDeferredScript();
     void evaluateComponentScript(const QString &fileName, const bool postScriptContext = false);
 
     void loadTranslations(const QDir &directory, const QStringList &qms);
@@ -161,10 +167,14 @@ public:
     Q_INVOKABLE void setStopProcessForUpdateRequest(const QString &process, bool requested);
 
     QString name() const;
+    KDUpdater::VersionKey versionKey() const;
     QString displayName() const;
     QString treeName() const;
     bool treeNameMoveChildren() const;
     quint64 updateUncompressedSize();
+    int sortingPriority() const;
+    quint64 compressedSize() const;
+    quint64 uncompressedSize() const;
 
     QUrl repositoryUrl() const;
     void setRepositoryUrl(const QUrl &url);
@@ -210,6 +220,7 @@ public:
     bool isSelected() const;
     bool forcedInstallation() const;
     bool isEssential() const;
+    bool requiresAdminRights() const;
 
     void setValidatorCallbackName(const QString &name);
 
@@ -228,6 +239,9 @@ private Q_SLOTS:
 
 private:
     void setLocalTempPath(const QString &tempPath);
+    QString metaDirectory() const;
+    void updateMetaDirectory();
+    void loadMetaFiles();
 
     Operation *createOperation(const QString &operationName, const QString &parameter1 = QString(),
         const QString &parameter2 = QString(), const QString &parameter3 = QString(),
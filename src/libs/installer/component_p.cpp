@@ -57,8 +57,15 @@ ComponentPrivate::ComponentPrivate(PackageManagerCore *core, Component *qq)
     , m_updateIsAvailable(false)
     , m_treeNameMoveChildren(false)
     , m_postLoadScript(false)
+    , m_metaDataDeferred(false)
+    , m_scriptDeferred(false)
     , m_scriptContext(QJSValue::UndefinedValue)
     , m_postScriptContext(QJSValue::UndefinedValue)
+    , m_compressedSize(0)
+    , m_uncompressedSize(0)
+    , m_uncompressedSizeSum(0)
+    , m_sortingPriority(0)
+    , m_attributeFlags(0)
 {
 }
 
@@ -82,6 +89,134 @@ ScriptEngine *ComponentPrivate::scriptEngine() const
     return m_core->componentScriptEngine();
 }
 
+/*
+    Returns the interned keys of the component variables that are set for
+    (nearly) every component. Storing the shared key instead of the caller's
+    copy avoids one string allocation per key and component.
+*/
+static const QHash<QString, ComponentPrivate::Attribute> &internedKeys()
+{
+    static const QHash<QString, ComponentPrivate::Attribute> keys = {
+        { scName, ComponentPrivate::OtherAttribute },
+        { scDisplayName, ComponentPrivate::OtherAttribute },
+        { scDescription, ComponentPrivate::OtherAttribute },
+        { scDefault, ComponentPrivate::OtherAttribute },
+        { scAutoDependOn, ComponentPrivate::OtherAttribute },
+        { scVersion, ComponentPrivate::VersionAttribute },
+        { scInheritVersion, ComponentPrivate::OtherAttribute },
+        { scInstalledVersion, ComponentPrivate::OtherAttribute },
+        { scLastUpdateDate, ComponentPrivate::OtherAttribute },
+        { scInstallDate, ComponentPrivate::OtherAttribute },
+        { scDependencies, ComponentPrivate::OtherAttribute },
+        { scLocalDependencies, ComponentPrivate::OtherAttribute },
+        { scDownloadableArchives, ComponentPrivate::OtherAttribute },
+        { scForcedUpdate, ComponentPrivate::OtherAttribute },
+        { scUpdateText, ComponentPrivate::OtherAttribute },
+        { scNewComponent, ComponentPrivate::OtherAttribute },
+        { scReplaces, ComponentPrivate::OtherAttribute },
+        { scReleaseDate, ComponentPrivate::OtherAttribute },
+        { scCheckable, ComponentPrivate::OtherAttribute },
+        { scExpandedByDefault, ComponentPrivate::OtherAttribute },
+        { scContentSha1, ComponentPrivate::OtherAttribute },
+        { scCheckSha1CheckSum, ComponentPrivate::OtherAttribute },
+        { scTreeName, ComponentPrivate::OtherAttribute },
+        { scAutoTreeName, ComponentPrivate::OtherAttribute },
+        { scUnstable, ComponentPrivate::OtherAttribute },
+        { scSortingPriority, ComponentPrivate::SortingPriorityAttribute },
+        { scCompressedSize, ComponentPrivate::CompressedSizeAttribute },
+        { scUncompressedSize, ComponentPrivate::UncompressedSizeAttribute },
+        { scUncompressedSizeSum, ComponentPrivate::UncompressedSizeSumAttribute },
+        { scVirtual, ComponentPrivate::VirtualAttribute },
+        { scForcedInstallation, ComponentPrivate::ForcedInstallationAttribute },
+        { scEssential, ComponentPrivate::EssentialAttribute },
+        { scRequiresAdminRights, ComponentPrivate::RequiresAdminRightsAttribute }
+    };
+    return keys;
+}
+
+/*
+    Sets the variable \a key to \a value and updates the typed copy of the
+    value if \a key is one of the well-known attributes.
+*/
+void ComponentPrivate::setVariable(const QString &key, const QString &value)
+{
+    const QHash<QString, Attribute> &keys = internedKeys();
+    const auto it = keys.constFind(key);
+    if (it == keys.constEnd()) {
+        m_vars.insert(key, value);
+        return;
+    }
+    m_vars.insert(it.key(), value);
+    updateAttribute(it.value(), value, false);
+}
+
+/*
+    Removes the variable \a key and resets the typed copy of the value.
+    Returns the number of removed variables.
+*/
+int ComponentPrivate::removeVariable(const QString &key)
+{
+    const int removed = m_vars.remove(key);
+    const Attribute attribute = internedKeys().value(key, OtherAttribute);
+    if (removed && attribute != OtherAttribute)
+        updateAttribute(attribute, QString(), true);
+    return removed;
+}
+
+bool ComponentPrivate::testAttributeFlag(AttributeFlag flag) const
+{
+    return m_attributeFlags & flag;
+}
+
+void ComponentPrivate::updateAttribute(Attribute attribute, const QString &value, bool removed)
+{
+    // Boolean attributes follow the semantics of the former string comparisons
+    const bool isTrue = !removed && value.compare(scTrue, Qt::CaseInsensitive) == 0;
+    quint8 flag = 0;
+    bool enabled = false;
+
+    switch (attribute) {
+    case SortingPriorityAttribute:
+        m_sortingPriority = value.toInt();
+        return;
+    case CompressedSizeAttribute:
+        m_compressedSize = value.toULongLong();
+        return;
+    case UncompressedSizeAttribute:
+        m_uncompressedSize = value.toULongLong();
+        return;
+    case UncompressedSizeSumAttribute:
+        m_uncompressedSizeSum = value.toULongLong();
+        return;
+    case VersionAttribute:
+        m_versionKey = removed ? KDUpdater::VersionKey() : KDUpdater::VersionKey(value);
+        return;
+    case VirtualAttribute:
+        flag = VirtualFlag;
+        enabled = isTrue;
+        break;
+    case ForcedInstallationAttribute:
+        flag = ForcedInstallationFlag;
+        enabled = isTrue;
+        break;
+    case EssentialAttribute:
+        flag = EssentialFlag;
+        enabled = isTrue;
+        break;
+    case RequiresAdminRightsAttribute:
+        flag = RequiresAdminRightsFlag;
+        enabled = !removed && value != scFalse;
+        break;
+    default:
+        return;
+    }
+
+    if (enabled)
+        m_attributeFlags |= flag;
+    else
+        m_attributeFlags &= ~flag;
+}
+
 // -- ComponentModelHelper
 
 ComponentModelHelper::ComponentModelHelper()
@@ -189,7 +324,7 @@ void ComponentModelHelper::setCheckable(bool checkable)
             setData(Qt::Unchecked, Qt::CheckStateRole);
     }
     changeFlags(checkable, Qt::ItemIsUserCheckable);
-    m_componentPrivate->m_vars[scCheckable] = checkable ? scTrue : scFalse;
+    m_componentPrivate->setVariable(scCheckable, checkable ? scTrue : scFalse);
 }
 
 /*!
@@ -30,6 +30,7 @@
 #define COMPONENT_P_H
 
 #include "qinstallerglobal.h"
+#include "versionkey.h"
 
 #include <QJSValue>
 #include <QPointer>
@@ -52,11 +53,35 @@ public:
         Installed = 1
     };
 
+    enum Attribute {
+        OtherAttribute = 0,
+        SortingPriorityAttribute,
+        CompressedSizeAttribute,
+        UncompressedSizeAttribute,
+        UncompressedSizeSumAttribute,
+        VirtualAttribute,
+        ForcedInstallationAttribute,
+        EssentialAttribute,
+        RequiresAdminRightsAttribute,
+        VersionAttribute
+    };
+
+    enum AttributeFlag {
+        VirtualFlag = 0x01,
+        ForcedInstallationFlag = 0x02,
+        EssentialFlag = 0x04,
+        RequiresAdminRightsFlag = 0x08
+    };
+
     explicit ComponentPrivate(PackageManagerCore *core, Component *qq);
     ~ComponentPrivate();
 
     ScriptEngine *scriptEngine() const;
 
+    void setVariable(const QString &key, const QString &value);
+    int removeVariable(const QString &key);
+    bool testAttributeFlag(AttributeFlag flag) const;
+
     PackageManagerCore *m_core;
     Component *m_parentComponent;
     OperationList m_operations;
@@ -71,13 +96,24 @@ public:
     bool m_updateIsAvailable;
     bool m_treeNameMoveChildren;
     bool m_postLoadScript;
+    bool m_metaDataDeferred;
+    bool m_scriptDeferred;
 
     QString m_componentName;
     QUrl m_repositoryUrl;
     QString m_localTempPath;
+    QString m_metaDirectory;
     QJSValue m_scriptContext;
     QJSValue m_postScriptContext;
     QHash<QString, QString> m_vars;
+
+    // Typed copies of the well-known entries in m_vars, kept in sync by setVariable()
+    quint64 m_compressedSize;
+    quint64 m_uncompressedSize;
+    quint64 m_uncompressedSizeSum;
+    int m_sortingPriority;
+    quint8 m_attributeFlags;
+    KDUpdater::VersionKey m_versionKey;
     QList<Component*> m_childComponents;
     QList<Component*> m_allChildComponents;
     QStringList m_downloadableArchives;
@@ -86,9 +122,17 @@ public:
     QHash<QString, QPointer<QWidget> > m_userInterfaces;
     QHash<QString, QVariant> m_scriptHash;
 
+    // Meta files referenced in the package.xml, loaded from the meta data directory
+    QStringList m_userInterfaceFilters;
+    QStringList m_translationFilters;
+    QHash<QString, QVariant> m_licenseHash;
+
     // < display name, < file name, file content > >
     QHash<QString, QVariantMap> m_licenses;
     QList<QPair<QString, bool> > m_pathsForUninstallation;
+
+private:
+    void updateAttribute(Attribute attribute, const QString &value, bool removed);
 };
 
 
@@ -0,0 +1,207 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "componentdependencygraph.h"
+
+#include "component.h"
+#include "constants.h"
+#include "errors.h"
+#include "packagemanagercore.h"
+
+namespace QInstaller {
+
+/*!
+    \class QInstaller::ComponentDependencyGraph
+    \inmodule QtInstallerFramework
+    \brief The ComponentDependencyGraph class holds the dependency order of components.
+
+    The graph indexes components by integers and resolves the order in which components
+    depend on each other once, when it is built. The result is kept until the components
+    or their dependencies change, which can be checked with isUpToDate().
+*/
+
+/*!
+    Constructs an empty component dependency graph.
+*/
+ComponentDependencyGraph::ComponentDependencyGraph()
+    : m_hasCycle(false)
+{
+}
+
+/*!
+    Removes all components from the graph.
+*/
+void ComponentDependencyGraph::clear()
+{
+    m_components.clear();
+    m_componentNames.clear();
+    m_dependencyValues.clear();
+    m_names.clear();
+    m_edges.clear();
+    m_sortedNames.clear();
+    m_cycle = qMakePair(QString(), QString());
+    m_hasCycle = false;
+}
+
+/*!
+    Returns \c true if the graph was built from \a components and neither their names
+    nor their dependencies have changed since then.
+*/
+bool ComponentDependencyGraph::isUpToDate(const QList<Component *> &components) const
+{
+    if (components.count() != m_components.count())
+        return false;
+
+    for (int i = 0; i < components.count(); ++i) {
+        const Component *component = components.at(i);
+        if (component != m_components.at(i) || component->name() != m_componentNames.at(i)
+                || component->value(scDependencies) != m_dependencyValues.at(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+    Builds the graph from \a components and their dependencies.
+*/
+void ComponentDependencyGraph::build(const QList<Component *> &components)
+{
+    QStringList names;
+    QList<QStringList> dependencies;
+    names.reserve(components.count());
+    dependencies.reserve(components.count());
+    foreach (const Component *component, components) {
+        names.append(component->name());
+        dependencies.append(PackageManagerCore::parseNames(component->dependencies()));
+    }
+    build(names, dependencies);
+
+    m_components.reserve(components.count());
+    m_dependencyValues.reserve(components.count());
+    foreach (const Component *component, components) {
+        m_components.append(component);
+        m_dependencyValues.append(component->value(scDependencies));
+    }
+    m_componentNames = names;
+}
+
+/*!
+    Builds the graph from the component \a names and the names of the components each
+    of them depends on in \a dependencies. Dependencies on unknown components are added
+    as nodes without dependencies of their own.
+*/
+void ComponentDependencyGraph::build(const QStringList &names,
+    const QList<QStringList> &dependencies)
+{
+    Q_ASSERT(names.count() == dependencies.count());
+    clear();
+
+    QHash<QString, int> indexes;
+    indexes.reserve(names.count());
+    foreach (const QString &name, names) {
+        if (indexes.contains(name))
+            continue;
+        indexes.insert(name, m_names.count());
+        m_names.append(name);
+    }
+
+    m_edges.resize(m_names.count());
+    for (int i = 0; i < names.count(); ++i) {
+        const int node = indexes.value(names.at(i));
+        foreach (const QString &dependency, dependencies.at(i)) {
+            int index = indexes.value(dependency, -1);
+            if (index < 0) {
+                index = m_names.count();
+                indexes.insert(dependency, index);
+                m_names.append(dependency);
+                m_edges.append(QList<int>());
+            }
+            if (!m_edges.at(node).contains(index))
+                m_edges[node].append(index);
+        }
+    }
+    sort();
+}
+
+/*!
+    Returns the component names ordered so that every component follows the components it
+    depends on. Throws Error if the dependencies contain a cycle.
+*/
+QStringList ComponentDependencyGraph::sortedNames() const
+{
+    if (m_hasCycle) {
+        throw Error(tr("Dependency cycle between components \"%1\" and \"%2\" detected.")
+            .arg(m_cycle.first, m_cycle.second));
+    }
+    return m_sortedNames;
+}
+
+/*!
+    \internal
+
+    Sorts the graph with an iterative depth-first search.
+*/
+void ComponentDependencyGraph::sort()
+{
+    enum State { Unvisited, Visiting, Resolved };
+    QList<State> states(m_names.count(), Unvisited);
+    QList<QPair<int, int>> stack;   // node and index of the next edge to visit
+
+    m_sortedNames.reserve(m_names.count());
+    for (int root = 0; root < m_names.count(); ++root) {
+        if (states.at(root) != Unvisited)
+            continue;
+
+        states[root] = Visiting;
+        stack.append(qMakePair(root, 0));
+        while (!stack.isEmpty()) {
+            const int node = stack.last().first;
+            const QList<int> &edges = m_edges.at(node);
+            if (stack.last().second < edges.count()) {
+                const int next = edges.at(stack.last().second++);
+                if (states.at(next) == Visiting) {
+                    m_hasCycle = true;
+                    m_cycle = qMakePair(m_names.at(node), m_names.at(next));
+                    m_sortedNames.clear();
+                    return;
+                }
+                if (states.at(next) == Unvisited) {
+                    states[next] = Visiting;
+                    stack.append(qMakePair(next, 0));
+                }
+            } else {
+                states[node] = Resolved;
+                m_sortedNames.append(m_names.at(node));
+                stack.removeLast();
+            }
+        }
+    }
+}
+
+} // namespace QInstaller
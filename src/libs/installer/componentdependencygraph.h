@@ -0,0 +1,76 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#ifndef COMPONENTDEPENDENCYGRAPH_H
+#define COMPONENTDEPENDENCYGRAPH_H
+
+#include "installer_global.h"
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QStringList>
+
+namespace QInstaller {
+
+class Component;
+
+class INSTALLER_EXPORT ComponentDependencyGraph
+{
+    Q_DECLARE_TR_FUNCTIONS(ComponentDependencyGraph)
+
+public:
+    ComponentDependencyGraph();
+
+    void clear();
+    bool isUpToDate(const QList<Component *> &components) const;
+
+    void build(const QList<Component *> &components);
+    void build(const QStringList &names, const QList<QStringList> &dependencies);
+
+    QStringList sortedNames() const;
+
+private:
+    void sort();
+
+private:
+    QList<const Component *> m_components;
+    QStringList m_componentNames;
+    QStringList m_dependencyValues;
+
+    QStringList m_names;
+    QList<QList<int>> m_edges;
+    QStringList m_sortedNames;
+    QPair<QString, QString> m_cycle;
+    bool m_hasCycle;
+};
+
+} // namespace QInstaller
+
+#endif // COMPONENTDEPENDENCYGRAPH_H
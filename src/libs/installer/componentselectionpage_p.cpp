@@ -229,6 +229,8 @@ ComponentSelectionPagePrivate::ComponentSelectionPagePrivate(ComponentSelectionP
     m_stackedLayout->addWidget(progressStackedWidget);
     m_stackedLayout->setCurrentIndex(0);
 
+    connect(m_treeView, &QTreeView::expanded,
+            this, &ComponentSelectionPagePrivate::prefetchChildComponents);
     connect(m_allModel, &ComponentModel::checkStateChanged,
             this, &ComponentSelectionPagePrivate::onModelStateChanged);
     connect(m_updaterModel, &ComponentModel::checkStateChanged,
@@ -309,6 +311,7 @@ void ComponentSelectionPagePrivate::updateTreeView()
     m_currentModel = m_core->isUpdater() ? m_updaterModel : m_allModel;
     m_proxyModel->setSourceModel(m_currentModel);
     m_treeView->setModel(m_proxyModel);
+    prefetchChildComponents(QModelIndex());
     expandDefault();
 
     const bool installActionColumnVisible = m_core->settings().installActionColumnVisible();
@@ -414,6 +417,9 @@ void ComponentSelectionPagePrivate::currentSelectedChanged(const QModelIndex &cu
     m_descriptionLabel->setText(description);
     if (m_spaceWidget)
         m_spaceWidget->updateSpaceRequiredText();
+
+    if (Component *component = m_currentModel->componentFromIndex(m_proxyModel->mapToSource(current)))
+        m_core->prefetchComponentMetaData(QList<Component *>() << component);
 }
 
 void ComponentSelectionPagePrivate::selectAll()
@@ -531,6 +537,9 @@ void ComponentSelectionPagePrivate::onModelStateChanged(QInstaller::ComponentMod
             ? m_core->componentsToInstallError() : m_core->componentsToUninstallError();
         MessageBoxHandler::critical(MessageBoxHandler::currentBestSuitParent(),
             QLatin1String("CalculateComponentsError"), tr("Error"), error);
+    } else {
+        // Have the meta data of the components to install ready when the page is left.
+        m_core->prefetchComponentMetaData(m_core->orderedComponentsToInstall());
     }
 
     q->setModified(state.testFlag(ComponentModel::DefaultChecked) == false);
@@ -575,6 +584,23 @@ void ComponentSelectionPagePrivate::setSearchPattern(const QString &text)
         m_searchLineEdit->addAction(m_searchAction, QLineEdit::TrailingPosition);
 }
 
+/*!
+    Starts fetching the meta data of the child components of \a index in the background,
+    as they become visible when \a index is expanded. Does nothing unless the meta data
+    of components is fetched on demand.
+*/
+void ComponentSelectionPagePrivate::prefetchChildComponents(const QModelIndex &index)
+{
+    QList<Component *> components;
+    const int rowCount = m_proxyModel->rowCount(index);
+    for (int row = 0; row < rowCount; ++row) {
+        const QModelIndex childIndex = m_proxyModel->mapToSource(m_proxyModel->index(row, 0, index));
+        if (Component *component = m_currentModel->componentFromIndex(childIndex))
+            components.append(component);
+    }
+    m_core->prefetchComponentMetaData(components);
+}
+
 /*!
     Stores the current resize modes of the tree view header's columns, and sets
     the new resize modes to \c QHeaderView::Fixed.
@@ -94,6 +94,7 @@ public slots:
     void selectDefault();
     void onModelStateChanged(QInstaller::ComponentModel::ModelState state);
     void setSearchPattern(const QString &text);
+    void prefetchChildComponents(const QModelIndex &index);
 
 private:
     void storeHeaderResizeModes();
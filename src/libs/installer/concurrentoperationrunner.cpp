@@ -30,6 +30,7 @@
 
 #include "errors.h"
 #include "operationtracer.h"
+#include "phasetracer.h"
 
 #include <QtConcurrent>
 
@@ -248,6 +249,10 @@ void ConcurrentOperationRunner::onOperationfinished()
 */
 bool ConcurrentOperationRunner::runOperation(Operation *const operation)
 {
+    static const char *const phaseNames[] = { "Backup operation", "Perform operation", "Undo operation" };
+    PhaseTracer::Scope trace(phaseNames[m_type], PhaseTracer::instance().isEnabled()
+        ? operation->name() + QLatin1Char(' ') + operation->arguments().value(0) : QString());
+
     emit operationStarted(operation);
 
     switch (m_type) {
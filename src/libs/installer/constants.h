@@ -51,6 +51,7 @@ static const QLatin1String scRemoteDisplayVersion("RemoteDisplayVersion");
 static const QLatin1String scInheritVersion("inheritVersionFrom");
 static const QLatin1String scReplaces("Replaces");
 static const QLatin1String scDownloadableArchives("DownloadableArchives");
+static const QLatin1String scDeltaArchives("DeltaArchives");
 static const QLatin1String scEssential("Essential");
 static const QLatin1String scForcedUpdate("ForcedUpdate");
 static const QLatin1String scTargetDir("TargetDir");
@@ -109,6 +110,7 @@ static const QLatin1String scLicense("License");
 static const QLatin1String scOperations("Operations");
 static const QLatin1String scInstallScript("installScript");
 static const QLatin1String scPostLoadScript("postLoadScript");
+static const QLatin1String scOnDemandScript("onDemand");
 static const QLatin1String scComponent("Component");
 static const QLatin1String scComponentSmall("component");
 static const QLatin1String scRetranslateUi("retranslateUi");
@@ -170,6 +172,11 @@ static const QLatin1String scAllUsers("AllUsers");
 static const QLatin1String scSupportsModify("SupportsModify");
 static const QLatin1String scAllowUnstableComponents("AllowUnstableComponents");
 static const QLatin1String scSaveDefaultRepositories("SaveDefaultRepositories");
+static const QLatin1String scAllowHttp2("AllowHttp2");
+static const QLatin1String scMaxConnectionsPerHost("MaxConnectionsPerHost");
+static const QLatin1String scArchiveCacheSize("ArchiveCacheSize");
+static const QLatin1String scFetchMetadataOnDemand("FetchMetadataOnDemand");
+static const QLatin1String scPackMetadataInCache("PackMetadataInCache");
 static const QLatin1String scRepositoryCategoryDisplayName("RepositoryCategoryDisplayName");
 static const QLatin1String scHighDpi("@2x.");
 static const QLatin1String scWatermark("Watermark");
@@ -295,6 +302,9 @@ static const QLatin1String scSquishPortShort("q");
 static const QLatin1String scSquishPortLong("squish-port");
 static const QLatin1String scMaxConcurrentOperationsShort("mco");
 static const QLatin1String scMaxConcurrentOperationsLong("max-concurrent-operations");
+static const QLatin1String scScriptProfileLong("script-profile");
+static const QLatin1String scScriptProfileThresholdLong("script-profile-threshold");
+static const QLatin1String scTraceFileLong("trace-file");
 static const QLatin1String scCleanupUpdate("cleanup-update");
 static const QLatin1String scCleanupUpdateOnly("cleanup-update-only");
 
@@ -27,8 +27,12 @@
 **************************************************************************/
 #include "downloadarchivesjob.h"
 
+#include "archivecache.h"
+#include "binarydelta.h"
 #include "binaryformatenginehandler.h"
 #include "component.h"
+#include "errors.h"
+#include "globals.h"
 #include "messageboxhandler.h"
 #include "packagemanagercore.h"
 #include "utils.h"
@@ -37,14 +41,21 @@
 #include "filedownloader.h"
 #include "filedownloaderfactory.h"
 
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QTimerEvent>
 
+#include <utility>
+
 using namespace QInstaller;
 using namespace KDUpdater;
 
 
 static constexpr uint scMaxRetries = 5;
+static constexpr qint64 scMaxPartialDownloadAge = 7 * 24 * 60 * 60;    // seconds
+static constexpr qint64 scMaxPartialDownloadsSize = 1024 * 1024 * 1024;
 
 /*!
     Creates a new DownloadArchivesJob with parent \a core.
@@ -53,6 +64,9 @@ DownloadArchivesJob::DownloadArchivesJob(PackageManagerCore *core, const QString
     : Job(core)
     , m_core(core)
     , m_downloader(nullptr)
+    , m_archiveCache(nullptr)
+    , m_usingCachedArchive(false)
+    , m_deltaFailed(false)
     , m_archivesDownloaded(0)
     , m_archivesToDownloadCount(0)
     , m_canceled(false)
@@ -93,6 +107,72 @@ void DownloadArchivesJob::setExpectedTotalSize(quint64 total)
     m_totalSizeToDownload = total;
 }
 
+/*!
+    Sets the \a cache to look up archives from before downloading them, and to
+    store verified downloads to. Only archives with a published SHA-1 checksum
+    are cached. The job does not take ownership of \a cache.
+*/
+void DownloadArchivesJob::setArchiveCache(ArchiveCache *cache)
+{
+    m_archiveCache = cache;
+}
+
+/*!
+    Sets the \a directory to keep the partial files of interrupted downloads in. Downloads
+    of archives with a published SHA-1 checksum that fail, are canceled, or are interrupted
+    by the installer exiting are continued from their partial file by a later job, also
+    in another installer run. A partial file is removed once its download has finished, or
+    with the downloaded archive if the checksum does not match. Partial files that were not
+    continued for a week are removed when the job starts, as are the oldest ones if all of
+    them together take more than 1 GiB.
+
+    By default, no directory is set and interrupted downloads start over.
+*/
+void DownloadArchivesJob::setPartialDownloadDirectory(const QString &directory)
+{
+    m_partialDownloadDirectory = directory;
+}
+
+/*!
+    Removes the partial files of interrupted downloads in \a directory that were last
+    written more than \a maximumAge seconds ago. Then removes the least recently written
+    remaining ones until all of them together are not larger than \a maximumSize bytes.
+*/
+void DownloadArchivesJob::removeStalePartialDownloads(const QString &directory, qint64 maximumAge,
+    qint64 maximumSize)
+{
+    const QDir dir(directory);
+    if (!dir.exists())
+        return;
+
+    const auto removePartialFile = [](const QFileInfo &fi) {
+        QFile::remove(fi.absoluteFilePath());
+        QFile::remove(fi.absoluteFilePath() + QLatin1String(".info"));
+    };
+
+    const QDateTime now = QDateTime::currentDateTime();
+    qint64 totalSize = 0;
+    QFileInfoList partialFiles;
+    const QFileInfoList entries = dir.entryInfoList(QStringList(QLatin1String("*.part")),
+        QDir::Files | QDir::Hidden, QDir::Time | QDir::Reversed);
+    for (const QFileInfo &fi : entries) {
+        if (fi.lastModified().secsTo(now) > maximumAge) {
+            removePartialFile(fi);
+        } else {
+            totalSize += fi.size();
+            partialFiles.append(fi);
+        }
+    }
+
+    // The list is sorted from the least to the most recently written file.
+    for (const QFileInfo &fi : std::as_const(partialFiles)) {
+        if (totalSize <= maximumSize)
+            break;
+        totalSize -= fi.size();
+        removePartialFile(fi);
+    }
+}
+
 /*!
     \reimp
 */
@@ -100,6 +180,10 @@ void DownloadArchivesJob::doStart()
 {
     m_totalDownloadSpeedTimer.start();
     m_archivesDownloaded = 0;
+    if (!m_partialDownloadDirectory.isEmpty()) {
+        removeStalePartialDownloads(m_partialDownloadDirectory, scMaxPartialDownloadAge,
+            scMaxPartialDownloadsSize);
+    }
     fetchNextArchiveHash();
 }
 
@@ -115,6 +199,7 @@ void DownloadArchivesJob::doCancel()
 
 void DownloadArchivesJob::fetchNextArchiveHash()
 {
+    m_deltaFailed = false;
     if (m_archivesToDownload.isEmpty()) {
         emitFinished();
         return;
@@ -176,13 +261,47 @@ void DownloadArchivesJob::fetchNextArchive()
     if (m_downloader != nullptr)
         m_downloader->deleteLater();
 
-    m_downloader = setupDownloader(QString(), m_core->value(scUrlQueryString));
+    QString cachedArchive;
+    if (m_archiveCache && m_archivesToDownload.first().checkSha1CheckSum)
+        cachedArchive = m_archiveCache->archive(m_currentHash);
+    m_usingCachedArchive = !cachedArchive.isEmpty();
+
+    // Rebuild the archive from a binary delta to a previous version of it when that
+    // version is still in the cache. Archives in local repositories are read directly.
+    QString deltaSuffix;
+    m_deltaBase.clear();
+    const PackageManagerCore::DownloadItem &nextItem = m_archivesToDownload.first();
+    if (!m_usingCachedArchive && m_archiveCache && nextItem.checkSha1CheckSum && !m_deltaFailed
+            && !QUrl(nextItem.sourceUrl).isLocalFile()) {
+        for (const QByteArray &base : nextItem.deltaBases) {
+            m_deltaBase = m_archiveCache->archive(base);
+            if (!m_deltaBase.isEmpty()) {
+                deltaSuffix = QLatin1Char('.') + QString::fromLatin1(base) + QLatin1String(".delta");
+                break;
+            }
+        }
+    }
+
+    m_downloader = setupDownloader(deltaSuffix, m_core->value(scUrlQueryString), cachedArchive);
     if (!m_downloader) {
         m_archivesToDownload.removeFirst();
         QMetaObject::invokeMethod(this, "fetchNextArchiveHash", Qt::QueuedConnection);
         return;
     }
 
+    // Archives from local repositories are extracted from where they are, the downloader
+    // only verifies their checksum instead of copying them to the temporary directory.
+    m_downloader->setAllowInPlaceDownload(true);
+
+    // Interrupted downloads are continued by retries and later jobs. The partial file is
+    // identified by the source and the expected checksum, so that it is never continued
+    // with the content of another archive.
+    if (!m_partialDownloadDirectory.isEmpty() && m_archivesToDownload.first().checkSha1CheckSum) {
+        m_downloader->setPartialDownloadKey((m_archivesToDownload.first().sourceUrl + deltaSuffix)
+            .toUtf8() + ' ' + m_currentHash);
+        m_downloader->setPartialDownloadDirectory(m_partialDownloadDirectory);
+    }
+
     emit progressChanged(double(m_archivesDownloaded) / m_archivesToDownloadCount);
     connect(m_downloader, SIGNAL(downloadProgress(double)), this, SLOT(emitDownloadProgress(double)));
     connect(m_downloader, &FileDownloader::downloadCompleted,
@@ -288,6 +407,21 @@ void DownloadArchivesJob::registerFile()
     if (m_canceled || m_archivesToDownload.isEmpty())
         return;
 
+    if (m_usingCachedArchive && m_currentHash != m_downloader->sha1Sum().toHex()) {
+        // The cached copy was modified on disk, drop it and download the archive again.
+        qCWarning(QInstaller::lcInstallerInstallLog) << "Removing corrupt archive"
+            << m_downloader->downloadedFileName() << "from cache.";
+        m_archiveCache->removeItem(m_currentHash);
+        m_usingCachedArchive = false;
+        fetchNextArchive();
+        return;
+    }
+
+    if (!m_deltaBase.isEmpty()) {
+        registerDeltaArchive();
+        return;
+    }
+
     if (m_archivesToDownload.first().checkSha1CheckSum && m_currentHash != m_downloader->sha1Sum().toHex()) {
         //TODO: Maybe we should try to download the file again automatically
         const QMessageBox::Button res =
@@ -297,6 +431,10 @@ void DownloadArchivesJob::registerFile()
             "Expected: %1 \nDownloaded: %2").arg(QString::fromLatin1(m_currentHash), QString::fromLatin1(m_downloader->sha1Sum().toHex())),
             QMessageBox::Retry | QMessageBox::Cancel, QMessageBox::Retry);
 
+        // Do not let a retry continue from the corrupt file.
+        if (!m_downloader->isDownloadedInPlace())
+            QFile::remove(m_downloader->downloadedFileName());
+
         if (res == QMessageBox::Cancel) {
             finishWithError(tr("Cannot verify Hash\nExpected: %1 \nDownloaded: %2")
                 .arg(QString::fromLatin1(m_currentHash), QString::fromLatin1(m_downloader->sha1Sum().toHex())));
@@ -309,22 +447,70 @@ void DownloadArchivesJob::registerFile()
            return;
         }
     } else {
-        m_retryCount = scMaxRetries;
-
-        ++m_archivesDownloaded;
-        m_totalSizeDownloaded += QFile(m_downloader->downloadedFileName()).size();
-        if (m_progressChangedTimerId) {
-            killTimer(m_progressChangedTimerId);
-            m_progressChangedTimerId = 0;
-            emit progressChanged(double(m_archivesDownloaded) / m_archivesToDownloadCount);
-        }
+        registerArchive(m_downloader->downloadedFileName(),
+            m_usingCachedArchive || m_downloader->isDownloadedInPlace());
+    }
+    fetchNextArchiveHash();
+}
 
-        const PackageManagerCore::DownloadItem item = m_archivesToDownload.takeFirst();
-        BinaryFormatEngineHandler::instance()->registerResource(item.fileName,
-            m_downloader->downloadedFileName());
+/*!
+    Registers \a archivePath as the archive of the current download item. Unless
+    \a keepArchive is \c true, the archive is moved to the archive cache or
+    scheduled for deletion.
+*/
+void DownloadArchivesJob::registerArchive(QString archivePath, bool keepArchive)
+{
+    m_retryCount = scMaxRetries;
 
-        emit fileDownloadReady(m_downloader->downloadedFileName());
+    ++m_archivesDownloaded;
+    m_totalSizeDownloaded += QFile(archivePath).size();
+    if (m_progressChangedTimerId) {
+        killTimer(m_progressChangedTimerId);
+        m_progressChangedTimerId = 0;
+        emit progressChanged(double(m_archivesDownloaded) / m_archivesToDownloadCount);
     }
+
+    const PackageManagerCore::DownloadItem item = m_archivesToDownload.takeFirst();
+    if (!keepArchive && m_archiveCache && item.checkSha1CheckSum)
+        keepArchive = m_archiveCache->insertArchive(archivePath, m_currentHash, &archivePath);
+
+    BinaryFormatEngineHandler::instance()->registerResource(item.fileName, archivePath);
+
+    // Never schedule cached archives or the source of an in place download for deletion.
+    if (!keepArchive)
+        emit fileDownloadReady(archivePath);
+}
+
+/*!
+    Reconstructs the archive of the current download item from the just downloaded
+    binary delta and the cached previous version of the archive. Falls back to
+    downloading the full archive if that fails.
+*/
+void DownloadArchivesJob::registerDeltaArchive()
+{
+    const QString deltaFile = m_downloader->downloadedFileName();
+    const QString archivePath = QFileInfo(deltaFile).absolutePath() + QLatin1Char('/')
+        + QFileInfo(m_archivesToDownload.first().fileName).fileName();
+    const QString basePath = std::exchange(m_deltaBase, QString());
+
+    QByteArray checksum;
+    try {
+        checksum = BinaryDelta::apply(basePath, deltaFile, archivePath);
+    } catch (const Error &e) {
+        qCWarning(QInstaller::lcInstallerInstallLog).noquote() << e.message();
+    }
+    QFile::remove(deltaFile);
+
+    if (checksum != m_currentHash) {
+        qCWarning(QInstaller::lcInstallerInstallLog) << "Cannot rebuild archive from binary delta,"
+            << "downloading" << m_archivesToDownload.first().sourceUrl;
+        QFile::remove(archivePath);
+        m_deltaFailed = true;
+        fetchNextArchive();
+        return;
+    }
+
+    registerArchive(archivePath, false);
     fetchNextArchiveHash();
 }
 
@@ -338,6 +524,14 @@ void DownloadArchivesJob::downloadFailed(const QString &error)
     if (m_canceled)
         return;
 
+    if (!m_deltaBase.isEmpty()) {
+        qCWarning(QInstaller::lcInstallerInstallLog) << "Cannot download binary delta:" << error;
+        m_deltaBase.clear();
+        m_deltaFailed = true;
+        fetchNextArchive();
+        return;
+    }
+
     const QMessageBox::StandardButton b =
         MessageBoxHandler::critical(MessageBoxHandler::currentBestSuitParent(),
         QLatin1String("archiveDownloadError"), tr("Download Error"), tr("Cannot download archive %1: %2")
@@ -368,7 +562,8 @@ void DownloadArchivesJob::finishWithError(const QString &error)
         emitFinishedWithError(QInstaller::DownloadError, msg.arg(error, m_downloader->url().toString()));
 }
 
-KDUpdater::FileDownloader *DownloadArchivesJob::setupDownloader(const QString &suffix, const QString &queryString)
+KDUpdater::FileDownloader *DownloadArchivesJob::setupDownloader(const QString &suffix, const QString &queryString,
+    const QString &cachedArchive)
 {
     KDUpdater::FileDownloader *downloader = nullptr;
     const QFileInfo fi = QFileInfo(m_archivesToDownload.first().fileName);
@@ -377,7 +572,9 @@ KDUpdater::FileDownloader *DownloadArchivesJob::setupDownloader(const QString &s
         QString fullQueryString;
         if (!queryString.isEmpty())
             fullQueryString = QLatin1String("?") + queryString;
-        const QUrl url(m_archivesToDownload.first().sourceUrl + suffix + fullQueryString);
+        const QUrl url = cachedArchive.isEmpty()
+            ? QUrl(m_archivesToDownload.first().sourceUrl + suffix + fullQueryString)
+            : QUrl::fromLocalFile(cachedArchive);
         const QString &scheme = url.scheme();
         downloader = FileDownloaderFactory::instance().create(scheme, this);
 
@@ -400,8 +597,13 @@ KDUpdater::FileDownloader *DownloadArchivesJob::setupDownloader(const QString &s
                     + component->name() + QLatin1Char('/') + fi.fileName() + suffix);
             }
 
-            emit outputTextChanged(tr("Downloading archive \"%1\" for component %2.")
-                .arg(fi.fileName() + suffix, component->displayName()));
+            if (cachedArchive.isEmpty()) {
+                emit outputTextChanged(tr("Downloading archive \"%1\" for component %2.")
+                    .arg(fi.fileName() + suffix, component->displayName()));
+            } else {
+                emit outputTextChanged(tr("Using cached archive \"%1\" for component %2.")
+                    .arg(fi.fileName() + suffix, component->displayName()));
+            }
         } else {
             emit outputTextChanged(tr("Scheme %1 not supported (URL: %2).").arg(scheme, url.toString()));
         }
@@ -44,6 +44,7 @@ namespace KDUpdater {
 
 namespace QInstaller {
 
+class ArchiveCache;
 class MessageBoxHandler;
 
 class DownloadArchivesJob : public Job
@@ -57,6 +58,11 @@ public:
     int numberOfDownloads() const { return m_archivesDownloaded; }
     void setArchivesToDownload(const QList<PackageManagerCore::DownloadItem> &archives);
     void setExpectedTotalSize(quint64 total);
+    void setArchiveCache(ArchiveCache *cache);
+    void setPartialDownloadDirectory(const QString &directory);
+
+    static void removeStalePartialDownloads(const QString &directory, qint64 maximumAge,
+        qint64 maximumSize);
 
 Q_SIGNALS:
     void progressChanged(double progress);
@@ -85,11 +91,19 @@ protected Q_SLOTS:
     void emitDownloadProgress(double progress);
 
 private:
-    KDUpdater::FileDownloader *setupDownloader(const QString &suffix = QString(), const QString &queryString = QString());
+    void registerArchive(QString archivePath, bool keepArchive);
+    void registerDeltaArchive();
+    KDUpdater::FileDownloader *setupDownloader(const QString &suffix = QString(), const QString &queryString = QString(),
+        const QString &cachedArchive = QString());
 
 private:
     PackageManagerCore *m_core;
     KDUpdater::FileDownloader *m_downloader;
+    ArchiveCache *m_archiveCache;
+    QString m_partialDownloadDirectory;
+    bool m_usingCachedArchive;
+    QString m_deltaBase;
+    bool m_deltaFailed;
 
     int m_archivesDownloaded;
     int m_archivesToDownloadCount;
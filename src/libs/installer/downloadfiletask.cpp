@@ -74,18 +74,22 @@ AuthenticationRequiredException::AuthenticationRequiredException(Type type, cons
 
 Downloader::Downloader()
     : m_finished(0)
+    , m_nam(KDUpdater::FileDownloaderFactory::networkAccessManager())
+    , m_maxDownloads(0)
+    , m_maxDownloadsPerHost(0)
 {
     connect(&m_timer, &QTimer::timeout, this, &Downloader::onTimeout);
-    connect(&m_nam, &QNetworkAccessManager::finished, this, &Downloader::onFinished);
 }
 
 Downloader::~Downloader()
 {
-    m_nam.disconnect();
+    m_nam->disconnect(this);
+    // The shared network access manager outlives the downloader, delete the pending replies
+    // right away instead of leaving them to an event loop that might not run again.
     for (const auto &pair : m_downloads) {
         pair.first->disconnect();
         pair.first->abort();
-        pair.first->deleteLater();
+        delete pair.first;
     }
 }
 
@@ -98,22 +102,48 @@ void Downloader::download(QFutureInterface<FileTaskResult> &fi, const QList<File
     fi.reportStarted();
     fi.setExpectedResultCount(items.count());
 
-    m_nam.setProxyFactory(networkProxyFactory);
-    connect(&m_nam, &QNetworkAccessManager::authenticationRequired, this,
+    // The shared manager uses the proxy factory of the file downloader factory. A task with
+    // a proxy factory of its own gets its own manager, the shared one is not changed for the
+    // other downloads of the thread.
+    if (networkProxyFactory) {
+        m_taskNam.reset(new QNetworkAccessManager);
+        m_taskNam->setProxyFactory(networkProxyFactory);
+        m_nam = m_taskNam.get();
+    }
+    connect(m_nam, &QNetworkAccessManager::finished, this, &Downloader::onFinished);
+    connect(m_nam, &QNetworkAccessManager::authenticationRequired, this,
         &Downloader::onAuthenticationRequired);
-    connect(&m_nam, &QNetworkAccessManager::proxyAuthenticationRequired, this,
+    connect(m_nam, &QNetworkAccessManager::proxyAuthenticationRequired, this,
             &Downloader::onProxyAuthenticationRequired);
     QTimer::singleShot(0, this, &Downloader::doDownload);
 }
 
+/*!
+    Limits the number of transfers that run at the same time to \a maxDownloads in total
+    and to \a maxDownloadsPerHost for each host. The remaining items are queued and started
+    as soon as running transfers finish. A value of \c 0 means no limit.
+*/
+void Downloader::setConcurrencyLimits(int maxDownloads, int maxDownloadsPerHost)
+{
+    m_maxDownloads = maxDownloads;
+    m_maxDownloadsPerHost = maxDownloadsPerHost;
+}
+
 void Downloader::doDownload()
 {
     m_timer.start(1000); // Use a timer to check for canceled downloads.
 
-    foreach (const FileTaskItem &item, m_items) {
-        if (!startDownload(item))
-            break;
+    // Queue the items per host, so that saturated hosts can be skipped as a whole.
+    for (const FileTaskItem &item : std::as_const(m_items)) {
+        const QString host = QUrl(item.source()).host();
+        auto it = m_pendingItems.find(host);
+        if (it == m_pendingItems.end()) {
+            m_pendingHosts.enqueue(host);
+            it = m_pendingItems.insert(host, QQueue<FileTaskItem>());
+        }
+        it->enqueue(item);
     }
+    startPendingDownloads();
 
     if (m_items.isEmpty() || m_futureInterface->isCanceled()) {
         m_futureInterface->reportFinished();
@@ -212,6 +242,10 @@ void Downloader::onReadyRead()
 
 void Downloader::onFinished(QNetworkReply *reply)
 {
+    // The network access manager is shared by all downloads of the current thread.
+    if (m_downloads.find(reply) == m_downloads.cend())
+        return;
+
     Data &data = *m_downloads[reply];
     const QString filename = data.file ? data.file->fileName() : QString();
     if (!m_futureInterface->isCanceled()) {
@@ -231,9 +265,7 @@ void Downloader::onFinished(QNetworkReply *reply)
                     m_redirects.insert(redirectReply, redirect);
                 m_redirects.insert(redirectReply, url);
 
-                m_downloads.erase(reply);
-                m_redirects.remove(reply);
-                reply->deleteLater();
+                removeDownload(reply);
                 return;
             } else {
                 m_futureInterface->reportException(TaskException(tr("Redirect loop detected for \"%1\".")
@@ -259,12 +291,13 @@ void Downloader::onFinished(QNetworkReply *reply)
     m_futureInterface->reportResult(FileTaskResult(filename, data.observer->checkSum(), data.taskItem,
                                                   checksumMismatch));
 
-    m_downloads.erase(reply);
-    m_redirects.remove(reply);
-    reply->deleteLater();
+    removeDownload(reply);
 
     m_finished++;
-    if (m_downloads.empty() || m_futureInterface->isCanceled()) {
+    if (!m_futureInterface->isCanceled())
+        startPendingDownloads();
+
+    if ((m_downloads.empty() && m_pendingItems.isEmpty()) || m_futureInterface->isCanceled()) {
         m_futureInterface->reportFinished();
         emit finished();    // emit finished, so the event loop can shutdown
     }
@@ -402,10 +435,12 @@ QNetworkReply *Downloader::startDownload(const FileTaskItem &item)
     }
     QNetworkRequest request(source);
     request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::ManualRedirectPolicy);
-    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    KDUpdater::FileDownloaderFactory::configureRequest(&request);
 
-    QNetworkReply *reply = m_nam.get(request);
+    QNetworkReply *reply = m_nam->get(request);
     std::unique_ptr<Data> data(new Data(item));
+    data->host = source.host();
+    ++m_activeDownloadsPerHost[data->host];
     m_downloads[reply] = std::move(data);
 
     connect(reply, &QIODevice::readyRead, this, &Downloader::onReadyRead);
@@ -418,6 +453,54 @@ QNetworkReply *Downloader::startDownload(const FileTaskItem &item)
     return reply;
 }
 
+/*!
+    \internal
+
+    Starts queued items as long as the total and per host concurrency limits allow it. Each
+    host with queued items is visited once, the queue of a host that is already saturated
+    is kept as a whole. Returns \c false if a download could not be started; the remaining
+    items are dropped in that case.
+*/
+bool Downloader::startPendingDownloads()
+{
+    for (int count = m_pendingHosts.count(); count > 0; --count) {
+        if (m_maxDownloads > 0 && int(m_downloads.size()) >= m_maxDownloads)
+            break;
+
+        const QString host = m_pendingHosts.dequeue();
+        QQueue<FileTaskItem> &queue = m_pendingItems[host];
+        while (!queue.isEmpty()
+                && (m_maxDownloads <= 0 || int(m_downloads.size()) < m_maxDownloads)
+                && (m_maxDownloadsPerHost <= 0
+                    || m_activeDownloadsPerHost.value(host) < m_maxDownloadsPerHost)) {
+            if (!startDownload(queue.dequeue())) {
+                m_pendingItems.clear();
+                m_pendingHosts.clear();
+                return false;
+            }
+        }
+
+        if (queue.isEmpty())
+            m_pendingItems.remove(host);
+        else
+            m_pendingHosts.enqueue(host);
+    }
+    return true;
+}
+
+void Downloader::removeDownload(QNetworkReply *reply)
+{
+    const auto it = m_downloads.find(reply);
+    if (it != m_downloads.end()) {
+        const QString host = it->second->host;
+        if (--m_activeDownloadsPerHost[host] <= 0)
+            m_activeDownloadsPerHost.remove(host);
+        m_downloads.erase(it);
+    }
+    m_redirects.remove(reply);
+    reply->deleteLater();
+}
+
 
 // -- DownloadFileTask
 
@@ -452,11 +535,29 @@ void DownloadFileTask::setAuthenticator(const QAuthenticator &authenticator)
     m_authenticator = authenticator;
 }
 
+/*!
+    Sets the proxy \a factory for the downloads of this task. By default, the downloads use
+    the network access manager shared by the thread, with the proxy factory set on
+    KDUpdater::FileDownloaderFactory. With a factory of its own, the task uses a separate
+    network access manager and does not reuse the connections of other downloads.
+*/
 void DownloadFileTask::setProxyFactory(KDUpdater::FileDownloaderProxyFactory *factory)
 {
     m_proxyFactory.reset(factory);
 }
 
+/*!
+    Runs at most \a maxDownloads transfers at the same time, and at most
+    \a maxDownloadsPerHost transfers against the same host. Results are reported as each
+    transfer finishes, so callers can start processing them while the remaining items are
+    still downloading. A value of \c 0 means no limit, which is the default.
+*/
+void DownloadFileTask::setConcurrencyLimits(int maxDownloads, int maxDownloadsPerHost)
+{
+    m_maxDownloads = maxDownloads;
+    m_maxDownloadsPerHost = maxDownloadsPerHost;
+}
+
 void DownloadFileTask::doTask(QFutureInterface<FileTaskResult> &fi)
 {
     QEventLoop el;
@@ -470,6 +571,7 @@ void DownloadFileTask::doTask(QFutureInterface<FileTaskResult> &fi)
                 items[i].insert(TaskRole::Authenticator, QVariant::fromValue(m_authenticator));
         }
     }
+    downloader.setConcurrencyLimits(m_maxDownloads, m_maxDownloadsPerHost);
     downloader.download(fi, items, (m_proxyFactory.isNull() ? 0 : m_proxyFactory->clone()));
     el.exec();  // That's tricky here, we need to run our own event loop to keep QNAM working.
 }
@@ -97,6 +97,7 @@ public:
 
     void setAuthenticator(const QAuthenticator &authenticator);
     void setProxyFactory(KDUpdater::FileDownloaderProxyFactory *factory);
+    void setConcurrencyLimits(int maxDownloads, int maxDownloadsPerHost);
 
     void doTask(QFutureInterface<FileTaskResult> &fi) override;
 
@@ -104,6 +105,8 @@ private:
     friend class Downloader;
     QAuthenticator m_authenticator;
     QScopedPointer<KDUpdater::FileDownloaderProxyFactory> m_proxyFactory;
+    int m_maxDownloads = 0;
+    int m_maxDownloadsPerHost = 0;
 };
 
 }   // namespace QInstaller
@@ -36,6 +36,7 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
+#include <QQueue>
 #include <QTimer>
 
 #include <memory>
@@ -63,6 +64,7 @@ struct Data
     {}
 
     FileTaskItem taskItem;
+    QString host;
     std::unique_ptr<QFile> file;
     std::unique_ptr<FileTaskObserver> observer;
 };
@@ -78,6 +80,7 @@ public:
 
     void download(QFutureInterface<FileTaskResult> &fi, const QList<FileTaskItem> &items,
         QNetworkProxyFactory *networkProxyFactory);
+    void setConcurrencyLimits(int maxDownloads, int maxDownloadsPerHost);
 
 signals:
     void finished();
@@ -96,14 +99,22 @@ private slots:
 private:
     bool testCanceled();
     QNetworkReply *startDownload(const FileTaskItem &item);
+    bool startPendingDownloads();
+    void removeDownload(QNetworkReply *reply);
 
 private:
     QFutureInterface<FileTaskResult> *m_futureInterface;
 
     QTimer m_timer;
     int m_finished;
-    QNetworkAccessManager m_nam;
+    std::unique_ptr<QNetworkAccessManager> m_taskNam;
+    QNetworkAccessManager *m_nam;
     QList<FileTaskItem> m_items;
+    QHash<QString, QQueue<FileTaskItem>> m_pendingItems;
+    QQueue<QString> m_pendingHosts;
+    int m_maxDownloads;
+    int m_maxDownloadsPerHost;
+    QHash<QString, int> m_activeDownloadsPerHost;
     QMultiHash<QNetworkReply*, QUrl> m_redirects;
     std::unordered_map<QNetworkReply*, std::unique_ptr<Data>> m_downloads;
 };
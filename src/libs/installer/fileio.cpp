@@ -37,6 +37,16 @@
 #include <QFileDevice>
 #include <QString>
 
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+// copy_file_range() is declared by glibc since version 2.27.
+#if defined(__GLIBC_PREREQ)
+#if __GLIBC_PREREQ(2, 27)
+#define IFW_HAVE_COPY_FILE_RANGE
+#endif
+#endif
+#endif
+
 /*!
     \internal
 */
@@ -193,8 +203,30 @@ qint64 QInstaller::blockingRead(QFileDevice *in, char *buffer, qint64 size)
 */
 qint64 QInstaller::blockingCopy(QFileDevice *in, QFileDevice *out, qint64 size)
 {
-    static const qint64 blockSize = 4096;
-    QByteArray ba(blockSize, '\0');
+#ifdef IFW_HAVE_COPY_FILE_RANGE
+    // Let the kernel copy the data, this avoids the round trip through user space and
+    // allows file systems that support it to share the blocks instead of copying them.
+    if (size > 0 && in->handle() != -1 && out->handle() != -1 && out->flush()) {
+        loff_t inOffset = in->pos();
+        loff_t outOffset = out->pos();
+        while (size > 0) {
+            const ssize_t n = ::copy_file_range(in->handle(), &inOffset, out->handle(),
+                &outOffset, size_t(size), 0);
+            // Any error, e.g. ENOSYS on older kernels or EXDEV across file systems, and an
+            // unexpected end of the input file are handled by the block wise copy below.
+            if (n <= 0)
+                break;
+            size -= n;
+        }
+        if (!in->seek(inOffset) || !out->seek(outOffset)) {
+            throw Error(QCoreApplication::translate("QInstaller", "Copy failed: %1")
+                .arg(QCoreApplication::translate("QInstaller", "Cannot seek in file.")));
+        }
+    }
+#endif
+
+    static const qint64 blockSize = 1024 * 1024;
+    QByteArray ba(qMin(blockSize, size), '\0');
     qint64 actual = qMin(blockSize, size);
     while (actual > 0) {
         try {
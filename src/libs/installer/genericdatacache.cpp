@@ -28,6 +28,7 @@
 
 #include "genericdatacache.h"
 
+#include "archivecache.h"
 #include "errors.h"
 #include "fileutils.h"
 #include "globals.h"
@@ -539,6 +540,24 @@ QList<T *> GenericDataCache<T>::obsoleteItems() const
     return obsoletes;
 }
 
+/*!
+    \fn template <typename T> QInstaller::GenericDataCache<T>::invalidItems() const
+
+    Returns items from the cache that are not valid. The items are
+    verified concurrently using the global thread pool.
+*/
+template<typename T>
+QList<T *> GenericDataCache<T>::invalidItems() const
+{
+    QMutexLocker _(&m_mutex);
+    const QList<T *> invalids = QtConcurrent::blockingFiltered(m_items.values(),
+        [](T *item) {
+            return !item->isValid();
+        }
+    );
+    return invalids;
+}
+
 /*!
    \internal
 
@@ -691,5 +710,6 @@ bool GenericDataCache<T>::remove(const QByteArray &checksum)
 }
 
 template class GenericDataCache<Metadata>;
+template class GenericDataCache<ArchiveCacheItem>;
 
 } // namespace QInstaller
@@ -94,6 +94,7 @@ public:
     bool removeItem(const QByteArray &checksum);
 
     QList<T *> obsoleteItems() const;
+    QList<T *> invalidItems() const;
 
 private:
     void invalidate();
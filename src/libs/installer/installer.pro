@@ -51,6 +51,7 @@ HEADERS += packagemanagercore.h \
     componentsortfilterproxymodel.h \
     concurrentoperationrunner.h \
     genericdatacache.h \
+    archivecache.h \
     loggingutils.h \
     metadata.h \
     metadatacache.h \
@@ -59,12 +60,17 @@ HEADERS += packagemanagercore.h \
     binaryformat.h \
     binaryformatengine.h \
     binaryformatenginehandler.h \
+    metaarchiveengine.h \
+    metaarchiveenginehandler.h \
+    stringlistiterator_p.h \
     fileguard.h \
     repository.h \
     utils.h \
     errors.h \
     component.h \
     scriptengine.h \
+    scriptprofiler.h \
+    phasetracer.h \
     componentmodel.h \
     qinstallerglobal.h \
     qtpatch.h \
@@ -131,9 +137,12 @@ HEADERS += packagemanagercore.h \
     fileio.h \
     binarycontent.h \
     binarylayout.h \
+    binarydelta.h \
     installercalculator.h \
+    installplan.h \
     uninstallercalculator.h \
     componentchecker.h \
+    componentdependencygraph.h \
     proxycredentialsdialog.h \
     serverauthenticationdialog.h \
     keepaliveobject.h \
@@ -164,6 +173,7 @@ SOURCES += packagemanagercore.cpp \
     fileguard.cpp \
     componentsortfilterproxymodel.cpp \
     genericdatacache.cpp \
+    archivecache.cpp \
     loggingutils.cpp \
     metadata.cpp \
     metadatacache.cpp \
@@ -173,11 +183,15 @@ SOURCES += packagemanagercore.cpp \
     binaryformat.cpp \
     binaryformatengine.cpp \
     binaryformatenginehandler.cpp \
+    metaarchiveengine.cpp \
+    metaarchiveenginehandler.cpp \
     repository.cpp \
     fileutils.cpp \
     utils.cpp \
     component.cpp \
     scriptengine.cpp \
+    scriptprofiler.cpp \
+    phasetracer.cpp \
     componentmodel.cpp \
     qtpatch.cpp \
     consumeoutputoperation.cpp \
@@ -230,9 +244,12 @@ SOURCES += packagemanagercore.cpp \
     fileio.cpp \
     binarycontent.cpp \
     binarylayout.cpp \
+    binarydelta.cpp \
     installercalculator.cpp \
+    installplan.cpp \
     uninstallercalculator.cpp \
     componentchecker.cpp \
+    componentdependencygraph.cpp \
     proxycredentialsdialog.cpp \
     serverauthenticationdialog.cpp \
     keepaliveobject.cpp \
@@ -32,6 +32,7 @@
 #include "componentalias.h"
 #include "componentmodel.h"
 #include "packagemanagercore.h"
+#include "phasetracer.h"
 #include "settings.h"
 #include <globals.h>
 
@@ -55,6 +56,7 @@ InstallerCalculator::~InstallerCalculator()
 
 bool InstallerCalculator::solve()
 {
+    PhaseTracer::Scope trace("Solve installation");
     if (!solve(m_core->aliasesMarkedForInstallation()))
         return false;
 
@@ -96,6 +98,8 @@ bool InstallerCalculator::solve(const QList<Component *> &components)
     if (components.isEmpty())
         return true;
 
+    PhaseTracer::Scope trace("Resolve dependencies");
+
     QList<Component*> notAppendedComponents; // for example components with unresolved dependencies
     for (Component *component : std::as_const(components)){
         if (!component)
@@ -0,0 +1,178 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+
+#include "installplan.h"
+
+#include "component.h"
+#include "constants.h"
+#include "globals.h"
+
+namespace QInstaller {
+
+/*!
+    \inmodule QtInstallerFramework
+    \class QInstaller::InstallPlan
+    \internal
+    \brief The InstallPlan class holds the results derived from an installer calculation.
+
+    The plan is created once from the ordered list of components resolved by the
+    InstallerCalculator and is not modified afterwards. It caches the archives that
+    need to be downloaded, the byte totals used for disk space checks, and whether
+    any of the components requires admin rights. PackageManagerCore discards the
+    plan whenever the components to install are recalculated.
+*/
+
+/*!
+    Creates an install plan for the ordered list of \a components.
+*/
+InstallPlan::InstallPlan(const QList<Component *> &components)
+    : m_components(components)
+    , m_uncompressedSize(0)
+    , m_compressedSize(0)
+    , m_temporarySize(0)
+    , m_downloadSize(0)
+    , m_requiresAdminRights(false)
+{
+    for (Component *component : components) {
+        const quint64 compressedSize = component->compressedSize();
+        if (component->installAction() == ComponentModelHelper::Install) {
+            m_uncompressedSize += component->uncompressedSize();
+            m_compressedSize += compressedSize;
+            if (component->isFromOnlineRepository())
+                m_temporarySize += compressedSize;
+        }
+
+        if (component->requiresAdminRights())
+            m_requiresAdminRights = true;
+
+        const QStringList toDownload = component->downloadableArchives();
+        const bool checkSha1CheckSum = (component->value(scCheckSha1CheckSum).toLower() == scTrue);
+        const QStringList deltaArchives = splitStringWithComma(component->value(scDeltaArchives));
+        for (const QString &versionFreeString : toDownload) {
+            PackageManagerCore::DownloadItem item;
+            item.checkSha1CheckSum = checkSha1CheckSum;
+            item.fileName = scInstallerPrefixWithTwoArgs.arg(component->name(), versionFreeString);
+            item.sourceUrl = scThreeArgs.arg(component->repositoryUrl().toString(), component->name(),
+                versionFreeString);
+            // Entries have the form <archive>:<SHA-1 of the archive the delta applies to>
+            for (const QString &deltaArchive : deltaArchives) {
+                const int separator = deltaArchive.lastIndexOf(QLatin1Char(':'));
+                if (separator > 0 && versionFreeString
+                        == component->value(scVersion) + deltaArchive.left(separator)) {
+                    item.deltaBases.append(deltaArchive.mid(separator + 1).toLatin1());
+                }
+            }
+            m_archivesToDownload.append(item);
+        }
+        m_downloadSize += compressedSize;
+    }
+}
+
+/*!
+    Returns the ordered list of components to install.
+*/
+QList<Component *> InstallPlan::components() const
+{
+    return m_components;
+}
+
+/*!
+    Returns the archives that need to be downloaded before the installation.
+*/
+QList<PackageManagerCore::DownloadItem> InstallPlan::archivesToDownload() const
+{
+    return m_archivesToDownload;
+}
+
+/*!
+    Returns the sum of the uncompressed sizes of the components marked for installation.
+*/
+quint64 InstallPlan::uncompressedSize() const
+{
+    return m_uncompressedSize;
+}
+
+/*!
+    Returns the sum of the compressed sizes of the components marked for installation.
+*/
+quint64 InstallPlan::compressedSize() const
+{
+    return m_compressedSize;
+}
+
+/*!
+    Returns the sum of the compressed sizes of the components marked for installation
+    that are fetched from an online repository.
+*/
+quint64 InstallPlan::temporarySize() const
+{
+    return m_temporarySize;
+}
+
+/*!
+    Returns the expected total size of the archives to download.
+*/
+quint64 InstallPlan::downloadSize() const
+{
+    return m_downloadSize;
+}
+
+/*!
+    Returns \c true if at least one of the components requires admin rights to install.
+*/
+bool InstallPlan::requiresAdminRights() const
+{
+    return m_requiresAdminRights;
+}
+
+/*!
+    Returns the plan as a variant map suitable for scripts and command line output.
+*/
+QVariantMap InstallPlan::toVariantMap() const
+{
+    QStringList componentNames;
+    for (const Component *component : m_components)
+        componentNames.append(component->name());
+
+    QStringList archives;
+    for (const PackageManagerCore::DownloadItem &item : m_archivesToDownload)
+        archives.append(item.sourceUrl);
+
+    QVariantMap map;
+    map.insert(QLatin1String("components"), componentNames);
+    map.insert(QLatin1String("archives"), archives);
+    map.insert(QLatin1String("uncompressedSize"), m_uncompressedSize);
+    map.insert(QLatin1String("compressedSize"), m_compressedSize);
+    map.insert(QLatin1String("temporarySize"), m_temporarySize);
+    map.insert(QLatin1String("downloadSize"), m_downloadSize);
+    map.insert(QLatin1String("requiresAdminRights"), m_requiresAdminRights);
+    return map;
+}
+
+} // namespace QInstaller
@@ -0,0 +1,70 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#ifndef INSTALLPLAN_H
+#define INSTALLPLAN_H
+
+#include "installer_global.h"
+#include "packagemanagercore.h"
+
+#include <QList>
+#include <QVariantMap>
+
+namespace QInstaller {
+
+class Component;
+
+class INSTALLER_EXPORT InstallPlan
+{
+public:
+    explicit InstallPlan(const QList<Component *> &components);
+
+    QList<Component *> components() const;
+    QList<PackageManagerCore::DownloadItem> archivesToDownload() const;
+
+    quint64 uncompressedSize() const;
+    quint64 compressedSize() const;
+    quint64 temporarySize() const;
+    quint64 downloadSize() const;
+    bool requiresAdminRights() const;
+
+    QVariantMap toVariantMap() const;
+
+private:
+    QList<Component *> m_components;
+    QList<PackageManagerCore::DownloadItem> m_archivesToDownload;
+    quint64 m_uncompressedSize;
+    quint64 m_compressedSize;
+    quint64 m_temporarySize;
+    quint64 m_downloadSize;
+    bool m_requiresAdminRights;
+};
+
+} // namespace QInstaller
+
+#endif // INSTALLPLAN_H
@@ -142,10 +142,6 @@ bool LibArchiveWrapperPrivate::extract(const QString &dirPath, const quint64 tot
 {
     const quint64 total = totalFiles ? totalFiles : m_archive.totalFiles();
     if (connectToServer()) {
-        QTimer timer;
-        connect(&timer, &QTimer::timeout, this, &LibArchiveWrapperPrivate::processSignals);
-        timer.start();
-
         m_lock.lockForWrite();
         callRemoteMethodDefaultReply(QLatin1String(Protocol::AbstractArchiveExtract), dirPath, total);
         m_lock.unlock();
@@ -154,7 +150,6 @@ bool LibArchiveWrapperPrivate::extract(const QString &dirPath, const quint64 tot
             connect(this, &LibArchiveWrapperPrivate::remoteWorkerFinished, &loop, &QEventLoop::quit);
             loop.exec();
         }
-        timer.stop();
         return (workerStatus() == ExtractWorker::Success);
     }
     return m_archive.extract(dirPath, total);
@@ -229,21 +224,12 @@ void LibArchiveWrapperPrivate::cancel()
 }
 
 /*!
-    Calls a remote method to get the associated queued signals from the server.
-    Signals are then processed and emitted client-side.
+    Emits the signals in \a signalList of the archive handled by the server,
+    as pushed by the server.
 */
-void LibArchiveWrapperPrivate::processSignals()
+void LibArchiveWrapperPrivate::processSignals(const QVariantList &signalList)
 {
-    if (!isConnectedToServer())
-        return;
-
-    if (!m_lock.tryLockForRead())
-        return;
-
-    QList<QVariant> receivedSignals =
-        callRemoteMethod<QList<QVariant>>(QString::fromLatin1(Protocol::GetAbstractArchiveSignals));
-
-    m_lock.unlock();
+    QVariantList receivedSignals = signalList;
     while (!receivedSignals.isEmpty()) {
         const QString name = receivedSignals.takeFirst().toString();
         if (name == QLatin1String(Protocol::AbstractArchiveSignalCurrentEntryChanged)) {
@@ -33,7 +33,7 @@
 #include "remoteobject.h"
 #include "libarchivearchive.h"
 
-#include <QTimer>
+#include <QEventLoop>
 #include <QReadWriteLock>
 
 namespace QInstaller {
@@ -71,8 +71,10 @@ Q_SIGNALS:
 public Q_SLOTS:
     void cancel();
 
+protected:
+    void processSignals(const QVariantList &signalList) override;
+
 private Q_SLOTS:
-    void processSignals();
     void onDataBlockRequested();
     void onSeekRequested(qint64 offset, int whence);
 
@@ -37,7 +37,9 @@
 #include "remotefileengine.h"
 
 #include <QXmlStreamWriter>
+#include <QDir>
 #include <QElapsedTimer>
+#include <QThread>
 
 #include <iostream>
 #if defined(Q_OS_UNIX)
@@ -135,15 +137,15 @@ LoggingHandler::~LoggingHandler()
 */
 void LoggingHandler::messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
 {
-    QMutexLocker _(&m_mutex);
-
     // suppress warning from QPA minimal plugin
     if (msg.contains(QLatin1String("This plugin does not support propagateSizeHints")))
         return;
 
     if (context.category == lcProgressIndicator().categoryName()) {
-        if (!outputRedirected())
+        if (!outputRedirected()) {
+            QMutexLocker _(&m_mutex);
             std::cout << msg.toStdString() << "\r" << std::flush;
+        }
         return;
     }
 
@@ -158,11 +160,14 @@ void LoggingHandler::messageHandler(QtMsgType type, const QMessageLogContext &co
                     QString::fromLatin1(context.function));
     }
 
+    // the log writer queues the line without blocking on file I/O
     if (VerboseWriter *log = VerboseWriter::instance())
         log->appendLine(ba);
 
-    if (type != QtDebugMsg || isVerbose())
+    if (type != QtDebugMsg || isVerbose()) {
+        QMutexLocker _(&m_mutex);
         std::cout << qPrintable(ba) << std::endl;
+    }
 
     if (type == QtFatalMsg) {
         QtMessageHandler oldMsgHandler = qInstallMessageHandler(nullptr);
@@ -405,14 +410,53 @@ void LoggingHandler::printAliasInformation(const QList<ComponentAlias *> &aliase
     std::cout << qPrintable(output);
 }
 
+// Number of queued lines after which the writer thread is woken up immediately
+static const int scMaxPendingLines = 1024;
+// Maximum time the queued lines wait for the writer thread
+static const int scWriterInterval = 100;
+// Size of the chunks in which the spooled log is copied to the log file
+static const qint64 scCopyBlockSize = 1024 * 1024;
+
+/*!
+    \internal
+
+    Renames the log \a file to \a backup if it has grown larger than
+    VerboseWriter::MaxLogFileSize, replacing an older backup.
+*/
+static void rotateLogFile(QAbstractFileEngine *file, QAbstractFileEngine *backup)
+{
+    if (file->size() < VerboseWriter::MaxLogFileSize)
+        return;
+
+    backup->remove();
+    file->rename(backup->fileName());
+}
+
 /*!
     \internal
+
+    Log lines are queued by the calling threads and written by a background thread to
+    a temporary spool file, so the memory used does not grow with the size of the log.
+    The spooled log is appended to the log file in flush(), once its location is known.
 */
 VerboseWriter::VerboseWriter()
+    : m_stopped(false)
+    , m_closed(false)
+    , m_spool(&m_spoolFile)
 {
-    m_preFileBuffer.open(QIODevice::ReadWrite);
-    m_stream.setDevice(&m_preFileBuffer);
     m_currentDateTimeAsString = QDateTime::currentDateTime().toString();
+
+    m_spoolFile.setFileTemplate(QDir::tempPath() + QLatin1String("/ifwlog-XXXXXX"));
+    if (!m_spoolFile.open()) {
+        // keep the log in memory as a last resort
+        m_spoolBuffer.open(QIODevice::ReadWrite);
+        m_spool = &m_spoolBuffer;
+    }
+    m_spool->write(QByteArray("************************************* Invoked: ")
+        + m_currentDateTimeAsString.toLocal8Bit() + '\n');
+
+    m_writerThread.reset(QThread::create([this] { run(); }));
+    m_writerThread->start(QThread::LowPriority);
 }
 
 /*!
@@ -420,10 +464,11 @@ VerboseWriter::VerboseWriter()
 */
 VerboseWriter::~VerboseWriter()
 {
-    if (m_preFileBuffer.isOpen()) {
+    if (!m_closed) {
         PlainVerboseWriterOutput output;
         (void)flush(&output);
     }
+    stopWriterThread();
 }
 
 /*!
@@ -431,31 +476,32 @@ VerboseWriter::~VerboseWriter()
 */
 bool VerboseWriter::flush(VerboseWriterOutput *output)
 {
-    m_stream.flush();
-    if (m_logFileName.isEmpty()) // binarycreator
+    QMutexLocker locker(&m_spoolMutex);
+    if (m_closed)
         return true;
-    if (!m_preFileBuffer.isOpen())
+    writePendingLines();
+
+    if (m_logFileName.isEmpty()) // binarycreator
         return true;
     //if the installer installed nothing - there is no target directory - where the logfile can be saved
     if (!QFileInfo(m_logFileName).absoluteDir().exists())
         return true;
 
-    QString logInfo;
-    logInfo += QLatin1String("************************************* Invoked: ");
-    logInfo += m_currentDateTimeAsString;
-    logInfo += QLatin1String("\n");
+    if (!m_spool->seek(0))
+        return false;
 
-    QBuffer buffer;
-    buffer.open(QIODevice::WriteOnly);
-    buffer.write(logInfo.toLocal8Bit());
-    buffer.write(m_preFileBuffer.data());
-    buffer.close();
-
-    if (output->write(m_logFileName, QIODevice::ReadWrite | QIODevice::Append | QIODevice::Text, buffer.data())) {
-        m_preFileBuffer.close();
-        m_stream.setDevice(nullptr);
+    if (output->write(m_logFileName, QIODevice::ReadWrite | QIODevice::Append | QIODevice::Text, m_spool)) {
+        {
+            QMutexLocker _(&m_queueMutex);
+            m_closed = true;
+            m_pendingLines.clear();
+        }
+        m_spool->close();
+        locker.unlock();
+        stopWriterThread();
         return true;
     }
+    m_spool->seek(m_spool->size());
     return false;
 }
 
@@ -482,7 +528,76 @@ VerboseWriter *VerboseWriter::instance()
 */
 void VerboseWriter::appendLine(const QString &msg)
 {
-    m_stream << msg << Qt::endl;
+    QMutexLocker _(&m_queueMutex);
+    if (m_closed)
+        return;
+
+    m_pendingLines.append(msg);
+    if (m_pendingLines.count() >= scMaxPendingLines)
+        m_queueCondition.wakeOne();
+}
+
+/*!
+    \internal
+
+    Writes the queued lines to the spool file until the writer thread is stopped.
+*/
+void VerboseWriter::run()
+{
+    forever {
+        {
+            QMutexLocker _(&m_queueMutex);
+            if (m_stopped)
+                return;
+            if (m_pendingLines.isEmpty())
+                m_queueCondition.wait(&m_queueMutex, scWriterInterval);
+            if (m_stopped)
+                return;
+        }
+        QMutexLocker _(&m_spoolMutex);
+        writePendingLines();
+    }
+}
+
+/*!
+    \internal
+*/
+void VerboseWriter::stopWriterThread()
+{
+    if (!m_writerThread)
+        return;
+
+    {
+        QMutexLocker _(&m_queueMutex);
+        m_stopped = true;
+        m_queueCondition.wakeOne();
+    }
+    m_writerThread->wait();
+    m_writerThread.reset();
+}
+
+/*!
+    \internal
+
+    Appends the queued lines to the spool. Must be called with the spool mutex locked, so
+    that lines taken from the queue are written in order.
+*/
+void VerboseWriter::writePendingLines()
+{
+    QStringList lines;
+    {
+        QMutexLocker _(&m_queueMutex);
+        lines.swap(m_pendingLines);
+    }
+    if (lines.isEmpty() || !m_spool->isOpen())
+        return;
+
+    QByteArray data;
+    for (const QString &line : std::as_const(lines)) {
+        data += line.toUtf8();
+        data += '\n';
+    }
+    m_spool->write(data);
 }
 
 /*!
@@ -495,11 +610,21 @@ VerboseWriterOutput::~VerboseWriterOutput()
 /*!
     \internal
 */
-bool PlainVerboseWriterOutput::write(const QString &fileName, QIODevice::OpenMode openMode, const QByteArray &data)
+bool PlainVerboseWriterOutput::write(const QString &fileName, QIODevice::OpenMode openMode, QIODevice *data)
 {
+    {
+        QFSFileEngine file(fileName);
+        QFSFileEngine backup(fileName + QLatin1String(".1"));
+        rotateLogFile(&file, &backup);
+    }
+
     QFile output(fileName);
     if (output.open(openMode)) {
-        output.write(data);
+        while (!data->atEnd()) {
+            const QByteArray block = data->read(scCopyBlockSize);
+            if (block.isEmpty() || output.write(block) != block.size())
+                return false;
+        }
         setDefaultFilePermissions(&output, DefaultFilePermissions::NonExecutable);
         return true;
     }
@@ -509,7 +634,7 @@ bool PlainVerboseWriterOutput::write(const QString &fileName, QIODevice::OpenMod
 /*!
     \internal
 */
-bool VerboseWriterAdminOutput::write(const QString &fileName, QIODevice::OpenMode openMode, const QByteArray &data)
+bool VerboseWriterAdminOutput::write(const QString &fileName, QIODevice::OpenMode openMode, QIODevice *data)
 {
     bool gainedAdminRights = false;
 
@@ -518,20 +643,30 @@ bool VerboseWriterAdminOutput::write(const QString &fileName, QIODevice::OpenMod
         gainedAdminRights = true;
     }
 
+    {
+        RemoteFileEngine file;
+        file.setFileName(fileName);
+        RemoteFileEngine backup;
+        backup.setFileName(fileName + QLatin1String(".1"));
+        rotateLogFile(&file, &backup);
+    }
+
+    bool success = false;
     RemoteFileEngine file;
     file.setFileName(fileName);
     if (file.open(openMode)) {
-        file.write(data.constData(), data.size());
+        success = true;
+        while (success && !data->atEnd()) {
+            const QByteArray block = data->read(scCopyBlockSize);
+            success = !block.isEmpty() && file.write(block.constData(), block.size()) == block.size();
+        }
         file.close();
-        if (gainedAdminRights)
-            m_core->dropAdminRights();
-        return true;
     }
 
     if (gainedAdminRights)
         m_core->dropAdminRights();
 
-    return false;
+    return success;
 }
 
 /*!
@@ -37,6 +37,12 @@
 #include <QTextStream>
 #include <QBuffer>
 #include <QMutex>
+#include <QTemporaryFile>
+#include <QWaitCondition>
+
+#include <memory>
+
+QT_FORWARD_DECLARE_CLASS(QThread)
 
 namespace QInstaller {
 
@@ -89,7 +95,7 @@ private:
 class INSTALLER_EXPORT VerboseWriterOutput
 {
 public:
-    virtual bool write(const QString &fileName, QIODevice::OpenMode openMode, const QByteArray &data) = 0;
+    virtual bool write(const QString &fileName, QIODevice::OpenMode openMode, QIODevice *data) = 0;
 
 protected:
     ~VerboseWriterOutput();
@@ -98,7 +104,7 @@ protected:
 class INSTALLER_EXPORT PlainVerboseWriterOutput : public VerboseWriterOutput
 {
 public:
-    virtual bool write(const QString &fileName, QIODevice::OpenMode openMode, const QByteArray &data) override;
+    virtual bool write(const QString &fileName, QIODevice::OpenMode openMode, QIODevice *data) override;
 };
 
 class INSTALLER_EXPORT VerboseWriterAdminOutput : public VerboseWriterOutput
@@ -106,7 +112,7 @@ class INSTALLER_EXPORT VerboseWriterAdminOutput : public VerboseWriterOutput
 public:
     VerboseWriterAdminOutput(PackageManagerCore *core) : m_core(core) {}
 
-    virtual bool write(const QString &fileName, QIODevice::OpenMode openMode, const QByteArray &data) override;
+    virtual bool write(const QString &fileName, QIODevice::OpenMode openMode, QIODevice *data) override;
 
 private:
     PackageManagerCore *m_core;
@@ -125,9 +131,26 @@ public:
     void appendLine(const QString &msg);
     void setFileName(const QString &fileName);
 
+    static constexpr qint64 MaxLogFileSize = 16 * 1024 * 1024;
+
+private:
+    void run();
+    void stopWriterThread();
+    void writePendingLines();
+
 private:
-    QTextStream m_stream;
-    QBuffer m_preFileBuffer;
+    QMutex m_queueMutex;
+    QWaitCondition m_queueCondition;
+    QStringList m_pendingLines;
+    bool m_stopped;
+    bool m_closed;
+
+    QMutex m_spoolMutex;
+    QIODevice *m_spool;
+    QTemporaryFile m_spoolFile;
+    QBuffer m_spoolBuffer;
+
+    std::unique_ptr<QThread> m_writerThread;
     QString m_logFileName;
     QString m_currentDateTimeAsString;
 };
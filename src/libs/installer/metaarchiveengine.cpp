@@ -0,0 +1,337 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "metaarchiveengine.h"
+#include "stringlistiterator_p.h"
+
+#include "errors.h"
+
+#include <QRegularExpression>
+
+namespace QInstaller {
+
+/*!
+    \class QInstaller::MetaArchiveEngine
+    \inmodule QtInstallerFramework
+    \brief The MetaArchiveEngine class is the read-only file engine for accessing the files
+        of meta data archives registered with MetaArchiveEngineHandler.
+*/
+
+/*!
+    Constructs a new meta archive engine with \a fileName.
+*/
+MetaArchiveEngine::MetaArchiveEngine(const QString &fileName)
+    : m_registered(false)
+{
+    setFileName(fileName);
+}
+
+/*!
+    \internal
+
+    Sets the file engine's file name to \a file. This is the file that the rest of the virtual
+    functions will operate on.
+*/
+void MetaArchiveEngine::setFileName(const QString &file)
+{
+    static const QChar sep = QLatin1Char('/');
+    static const QString prefix = QLatin1String("metadata://");
+    Q_ASSERT(file.toLower().startsWith(prefix));
+
+    // cut the prefix and normalize the path, it starts with the path of the archive
+    const QString path = file.mid(prefix.length()).split(sep, Qt::SkipEmptyParts).join(sep);
+    m_fileNamePath = prefix + path;
+
+    m_archivePath.clear();
+    m_entryPath.clear();
+    m_entries.clear();
+    m_resource.reset();
+    m_registered = MetaArchiveEngineHandler::instance()->archive(path, &m_archivePath,
+        &m_entryPath, &m_entries);
+}
+
+/*!
+    \internal
+*/
+bool MetaArchiveEngine::close()
+{
+    if (m_resource.isNull())
+        return false;
+
+    const bool result = m_resource->isOpen();
+    m_resource.reset();
+    return result;
+}
+
+/*!
+    \internal
+*/
+#if QT_VERSION < QT_VERSION_CHECK(6, 3, 0)
+bool MetaArchiveEngine::open(QIODevice::OpenMode mode)
+#else
+bool MetaArchiveEngine::open(QIODevice::OpenMode mode, std::optional<QFile::Permissions> permissions)
+#endif
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+    Q_UNUSED(permissions)
+#endif
+    if (mode & (QIODevice::WriteOnly | QIODevice::Append | QIODevice::Truncate)) {
+        setError(QFile::OpenError, QLatin1String("Meta data archives are read-only."));
+        return false;
+    }
+
+    const auto it = m_entries.constFind(m_entryPath);
+    if (it == m_entries.constEnd()) {
+        setError(QFile::OpenError, QLatin1String("No such file in meta data archive."));
+        return false;
+    }
+
+    m_resource.reset(new Resource(m_archivePath, it.value()));
+    if (!m_resource->open()) {
+        setError(QFile::OpenError, m_resource->errorString());
+        m_resource.reset();
+        return false;
+    }
+    return true;
+}
+
+/*!
+    \internal
+*/
+qint64 MetaArchiveEngine::pos() const
+{
+    return m_resource.isNull() ? 0 : m_resource->pos();
+}
+
+/*!
+    \internal
+*/
+qint64 MetaArchiveEngine::read(char *data, qint64 maxlen)
+{
+    return m_resource.isNull() ? -1 : m_resource->read(data, maxlen);
+}
+
+/*!
+    \internal
+*/
+bool MetaArchiveEngine::seek(qint64 offset)
+{
+    return m_resource.isNull() ? false : m_resource->seek(offset);
+}
+
+/*!
+    \internal
+*/
+qint64 MetaArchiveEngine::size() const
+{
+    return m_entries.value(m_entryPath).length();
+}
+
+/*!
+    \internal
+*/
+QString MetaArchiveEngine::fileName(FileName file) const
+{
+    static const QChar sep = QLatin1Char('/');
+    switch(file) {
+        case BaseName:
+            return m_fileNamePath.section(sep, -1, -1, QString::SectionSkipEmpty);
+        case PathName:
+        case AbsolutePathName:
+        case CanonicalPathName: {
+            if (m_entryPath.isEmpty())
+                return m_fileNamePath;
+            return m_fileNamePath.left(m_fileNamePath.lastIndexOf(sep));
+        }
+        case DefaultName:
+        case AbsoluteName:
+        case CanonicalName:
+            return m_fileNamePath;
+        default:
+            return QString();
+    }
+}
+
+/*!
+    \internal
+*/
+bool MetaArchiveEngine::copy(const QString &newName)
+{
+    const auto it = m_entries.constFind(m_entryPath);
+    if (it == m_entries.constEnd() || QFile::exists(newName))
+        return false;
+
+    Resource resource(m_archivePath, it.value());
+    QFile target(newName);
+    if (!resource.open() || !target.open(QIODevice::WriteOnly))
+        return false;
+
+    try {
+        resource.copyData(&target);
+    } catch (const Error &error) {
+        setError(QFile::CopyError, error.message());
+        return false;
+    }
+    return true;
+}
+
+/*!
+    \internal
+*/
+QAbstractFileEngine::FileFlags MetaArchiveEngine::fileFlags(FileFlags type) const
+{
+    static const FileFlags readPermissions = ReadOwnerPerm | ReadUserPerm | ReadGroupPerm
+        | ReadOtherPerm;
+
+    FileFlags result;
+    if (m_entries.contains(m_entryPath))
+        result |= FileType | ExistsFlag | readPermissions;
+    else if (isDirectory())
+        result |= DirectoryType | ExistsFlag | readPermissions;
+
+    return result & type;
+}
+
+/*!
+    \internal
+*/
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+QAbstractFileEngine::IteratorUniquePtr
+MetaArchiveEngine::beginEntryList(const QString &path, QDir::Filters filters,
+                                  const QStringList &filterNames)
+{
+    const QStringList entries = entryList(filters, filterNames);
+    return std::make_unique<StringListIterator>(path, entries, filters, filterNames);
+}
+
+QAbstractFileEngine::IteratorUniquePtr
+MetaArchiveEngine::beginEntryList(const QString &path, QDirListing::IteratorFlags filters,
+                                  const QStringList &filterNames)
+{
+    const QStringList entries = entryList(filters, filterNames);
+    return std::make_unique<StringListIterator>(path, entries, filters, filterNames);
+}
+
+/*!
+    \internal
+*/
+QStringList MetaArchiveEngine::entryList(QDirListing::IteratorFlags filters,
+    const QStringList &filterNames) const
+{
+    const bool all = filters.testFlag(QDirListing::IteratorFlag::Default);
+    return children(all || filters.testFlag(QDirListing::IteratorFlag::FilesOnly),
+        all || filters.testFlag(QDirListing::IteratorFlag::DirsOnly), filterNames);
+}
+#else
+QAbstractFileEngineIterator *MetaArchiveEngine::beginEntryList(QDir::Filters filters,
+    const QStringList &filterNames)
+{
+    const QStringList entries = entryList(filters, filterNames);
+    return new StringListIterator(QString(), entries, filters, filterNames);
+}
+#endif
+
+/*!
+    \internal
+*/
+QStringList MetaArchiveEngine::entryList(QDir::Filters filters, const QStringList &filterNames) const
+{
+    return children(filters.testFlag(QDir::Files),
+        filters.testFlag(QDir::Dirs) || filters.testFlag(QDir::AllDirs), filterNames);
+}
+
+/*!
+    \internal
+
+    Returns \c true if the file name of the engine refers to the root directory of a
+    registered archive, or to a directory inside the archive.
+*/
+bool MetaArchiveEngine::isDirectory() const
+{
+    if (!m_registered)
+        return false;
+    if (m_entryPath.isEmpty())
+        return true;
+
+    const QString directory = m_entryPath + QLatin1Char('/');
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (it.key().startsWith(directory))
+            return true;
+    }
+    return false;
+}
+
+/*!
+    \internal
+
+    Returns the names of the \a files and \a directories directly inside the directory
+    of the engine that match one of the wildcard patterns in \a filterNames.
+*/
+QStringList MetaArchiveEngine::children(bool files, bool directories,
+    const QStringList &filterNames) const
+{
+    if (!isDirectory())
+        return QStringList();
+
+    const QString directory = m_entryPath.isEmpty() ? QString() : m_entryPath + QLatin1Char('/');
+    QStringList result;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (!it.key().startsWith(directory))
+            continue;
+
+        const QString child = it.key().mid(directory.length());
+        const int index = child.indexOf(QLatin1Char('/'));
+        if (index == -1 && files)
+            result.append(child);
+        else if (index > 0 && directories)
+            result.append(child.left(index));
+    }
+    result.removeDuplicates();
+
+    if (filterNames.isEmpty())
+        return result;
+
+    QList<QRegularExpression> regexps;
+    for (const QString &i : filterNames) {
+        regexps.append(QRegularExpression(QRegularExpression::wildcardToRegularExpression(i),
+                                          QRegularExpression::CaseInsensitiveOption));
+    }
+
+    QStringList entries;
+    for (const QString &i : std::as_const(result)) {
+        for (const QRegularExpression &reg : std::as_const(regexps)) {
+            if (reg.match(i).hasMatch()) {
+                entries.append(i);
+                break;
+            }
+        }
+    }
+    return entries;
+}
+
+} // namespace QInstaller
@@ -0,0 +1,279 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "metaarchiveengine.h"
+#include "metaarchiveenginehandler.h"
+
+#include "binaryformat.h"
+#include "errors.h"
+#include "fileio.h"
+#include "globals.h"
+
+#include <QDirIterator>
+#include <QSaveFile>
+
+namespace QInstaller {
+
+static const QLatin1String scMetaArchivePrefix("metadata://");
+static const QLatin1String scMetaArchiveSuffix(".meta");
+static const quint64 scMetaArchiveMagicCookie = 0xc2630a1c99d66f3aLL;
+
+/*!
+    \class QInstaller::MetaArchiveEngineHandler
+    \inmodule QtInstallerFramework
+    \brief The MetaArchiveEngineHandler class provides read-only access to the meta data
+        archives of components stored in the local cache.
+
+    A meta data archive holds the meta files of a single component, such as the component
+    script, user interfaces, translations, and licenses. The files are stored uncompressed
+    after an index of their names and locations, so that reading a single file requires
+    neither extracting the archive nor opening more than one file in the cache.
+
+    The files of a registered archive can be accessed with file names prefixed with
+    \c {metadata://}, followed by the path of the archive and the path of the file inside
+    the archive, for example \c {metadata://cache/1a2b/componentName.meta/installscript.qs}.
+    Components with the same name from different repositories therefore do not share
+    their meta files.
+*/
+
+/*!
+    Creates a file engine for the file specified by \a fileName. To be able to create a file
+    engine, the file name needs to be prefixed with \c {metadata://}.
+
+    Returns 0 if the engine cannot handle \a fileName.
+*/
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+std::unique_ptr<QAbstractFileEngine> MetaArchiveEngineHandler::create(const QString &fileName) const
+{
+    return fileName.startsWith(scMetaArchivePrefix, Qt::CaseInsensitive)
+        ? std::make_unique<MetaArchiveEngine>(fileName) : nullptr;
+}
+#else
+QAbstractFileEngine *MetaArchiveEngineHandler::create(const QString &fileName) const
+{
+    return fileName.startsWith(scMetaArchivePrefix, Qt::CaseInsensitive)
+        ? new MetaArchiveEngine(fileName) : nullptr;
+}
+#endif
+
+/*!
+    Forgets all registered meta data archives.
+*/
+void MetaArchiveEngineHandler::clear()
+{
+    QMutexLocker _(&m_mutex);
+    m_archives.clear();
+}
+
+/*!
+    Returns the active instance of the engine.
+*/
+MetaArchiveEngineHandler *MetaArchiveEngineHandler::instance()
+{
+    static MetaArchiveEngineHandler instance;
+    return &instance;
+}
+
+/*!
+    Registers the meta data archive at \a archivePath and reads its index to memory,
+    replacing the index read when the archive was registered before. Returns the path
+    of the virtual directory that holds the files of the archive, ending with a forward
+    slash.
+*/
+QString MetaArchiveEngineHandler::registerArchive(const QString &archivePath)
+{
+    Archive archive;
+    archive.path = archivePath;
+    try {
+        archive.entries = readArchive(archivePath);
+    } catch (const Error &error) {
+        qCWarning(QInstaller::lcInstallerInstallLog) << error.message();
+    }
+
+    const QString key = archiveKey(archivePath);
+    QMutexLocker _(&m_mutex);
+    m_archives.insert(key, archive);
+    return scMetaArchivePrefix + key + QLatin1Char('/');
+}
+
+/*!
+    Looks up the registered meta data archive whose virtual directory contains the
+    normalized \a path, which is a file name without the \c {metadata://} prefix.
+    Retrieves the path and the index of the archive to \a archivePath and \a entries,
+    and the path of the file inside the archive to \a entryPath. Returns \c false if
+    \a path is not inside a registered archive.
+*/
+bool MetaArchiveEngineHandler::archive(const QString &path, QString *archivePath,
+    QString *entryPath, MetaArchiveEntries *entries) const
+{
+    Q_ASSERT(archivePath);
+    Q_ASSERT(entryPath);
+    Q_ASSERT(entries);
+
+    // The path of a file inside the archive is short, try the longest keys first.
+    QMutexLocker _(&m_mutex);
+    for (int end = path.length(); end > 0; end = path.lastIndexOf(QLatin1Char('/'), end - 1)) {
+        const auto it = m_archives.constFind(path.left(end));
+        if (it == m_archives.constEnd())
+            continue;
+
+        *archivePath = it->path;
+        *entryPath = path.mid(end + 1);
+        *entries = it->entries;
+        return true;
+    }
+    return false;
+}
+
+/*!
+    Returns the path of the meta data archive of the component \a name inside the
+    metadata \a directory.
+*/
+QString MetaArchiveEngineHandler::archivePath(const QString &directory, const QString &name)
+{
+    return directory + QLatin1Char('/') + name + scMetaArchiveSuffix;
+}
+
+/*!
+    \internal
+
+    Returns the key of the archive at \a archivePath in the registry, which is the
+    normalized path of the archive without leading slashes.
+*/
+QString MetaArchiveEngineHandler::archiveKey(const QString &archivePath)
+{
+    return QDir::fromNativeSeparators(archivePath).split(QLatin1Char('/'), Qt::SkipEmptyParts)
+        .join(QLatin1Char('/'));
+}
+
+/*!
+    Creates the meta data archive \a archivePath from the files inside \a directory,
+    including files in subdirectories. Throws QInstaller::Error on failure.
+*/
+void MetaArchiveEngineHandler::createArchive(const QString &archivePath, const QString &directory)
+{
+    const QDir dir(directory);
+    ResourceCollection collection(dir.dirName().toUtf8());
+    QDirIterator it(directory, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot,
+        QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString filePath = it.next();
+        collection.appendResource(QSharedPointer<Resource>(new Resource(filePath,
+            dir.relativeFilePath(filePath).toUtf8())));
+    }
+
+    ResourceCollectionManager manager;
+    manager.insertCollection(collection);
+
+    QSaveFile file(archivePath);
+    QInstaller::openForWrite(&file);
+    QInstaller::appendInt64Range(&file, manager.write(&file, 0));
+    QInstaller::appendInt64(&file, qint64(scMetaArchiveMagicCookie));
+    if (!file.commit()) {
+        throw Error(tr("Cannot write meta data archive \"%1\": %2")
+            .arg(QDir::toNativeSeparators(archivePath), file.errorString()));
+    }
+}
+
+/*!
+    Reads the index of the meta data archive \a archivePath and returns the locations of
+    the files inside the archive by their relative path. Throws QInstaller::Error on failure.
+*/
+MetaArchiveEntries MetaArchiveEngineHandler::readArchive(const QString &archivePath)
+{
+    QFile file(archivePath);
+    QInstaller::openForRead(&file);
+
+    // The archive ends with the range of the resource collection table and the magic cookie.
+    const qint64 trailerSize = 3 * sizeof(qint64);
+    if (file.size() < trailerSize || !file.seek(file.size() - trailerSize)) {
+        throw Error(tr("Invalid meta data archive \"%1\".")
+            .arg(QDir::toNativeSeparators(archivePath)));
+    }
+    const Range<qint64> table = QInstaller::retrieveInt64Range(&file);
+    if (quint64(QInstaller::retrieveInt64(&file)) != scMetaArchiveMagicCookie
+            || table.start() < 0 || table.end() > file.size() - trailerSize
+            || !file.seek(table.start())) {
+        throw Error(tr("Invalid meta data archive \"%1\".")
+            .arg(QDir::toNativeSeparators(archivePath)));
+    }
+
+    ResourceCollectionManager manager;
+    manager.read(&file, 0);
+
+    MetaArchiveEntries entries;
+    const QList<ResourceCollection> collections = manager.collections();
+    for (const ResourceCollection &collection : collections) {
+        const QList<QSharedPointer<Resource>> resources = collection.resources();
+        for (const QSharedPointer<Resource> &resource : resources) {
+            const Range<qint64> segment = resource->segment();
+            if (segment.start() < 0 || segment.end() > table.start()) {
+                throw Error(tr("Invalid meta data archive \"%1\".")
+                    .arg(QDir::toNativeSeparators(archivePath)));
+            }
+            entries.insert(QString::fromUtf8(resource->name()), segment);
+        }
+    }
+    return entries;
+}
+
+/*!
+    Extracts the files of the meta data archive \a archivePath to \a targetDirectory.
+    Throws QInstaller::Error on failure, or if the archive contains files that would be
+    extracted outside of \a targetDirectory.
+*/
+void MetaArchiveEngineHandler::extractArchive(const QString &archivePath,
+    const QString &targetDirectory)
+{
+    const MetaArchiveEntries entries = readArchive(archivePath);
+    const QDir targetDir(targetDirectory);
+    const QString targetPath = QDir::cleanPath(targetDir.absolutePath()) + QLatin1Char('/');
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        const QString entryPath = QDir::cleanPath(it.key());
+        const QString filePath = QDir::cleanPath(targetDir.absoluteFilePath(entryPath));
+        if (QDir::isAbsolutePath(entryPath) || !filePath.startsWith(targetPath)) {
+            throw Error(tr("Invalid file name \"%1\" in meta data archive \"%2\".")
+                .arg(it.key(), QDir::toNativeSeparators(archivePath)));
+        }
+        if (!QDir().mkpath(QFileInfo(filePath).absolutePath())) {
+            throw Error(tr("Cannot create directory \"%1\".")
+                .arg(QDir::toNativeSeparators(QFileInfo(filePath).absolutePath())));
+        }
+
+        Resource resource(archivePath, it.value());
+        if (!resource.open()) {
+            throw Error(tr("Cannot open meta data archive \"%1\" for reading: %2")
+                .arg(QDir::toNativeSeparators(archivePath), resource.errorString()));
+        }
+        QFile file(filePath);
+        QInstaller::openForWrite(&file);
+        resource.copyData(&file);
+    }
+}
+
+} // namespace QInstaller
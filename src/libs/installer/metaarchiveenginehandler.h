@@ -0,0 +1,86 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#ifndef METAARCHIVEENGINEHANDLER_H
+#define METAARCHIVEENGINEHANDLER_H
+
+#include "installer_global.h"
+#include "range.h"
+
+#include <QtCore/private/qabstractfileengine_p.h>
+#include <QCoreApplication>
+#include <QHash>
+#include <QMutex>
+
+namespace QInstaller {
+
+typedef QHash<QString, Range<qint64>> MetaArchiveEntries;
+
+class INSTALLER_EXPORT MetaArchiveEngineHandler : public QAbstractFileEngineHandler
+{
+    Q_DISABLE_COPY(MetaArchiveEngineHandler)
+    Q_DECLARE_TR_FUNCTIONS(MetaArchiveEngineHandler)
+
+public:
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+    std::unique_ptr<QAbstractFileEngine> create(const QString &fileName) const;
+#else
+    QAbstractFileEngine *create(const QString &fileName) const;
+#endif
+    void clear();
+    static MetaArchiveEngineHandler *instance();
+
+    QString registerArchive(const QString &archivePath);
+    bool archive(const QString &path, QString *archivePath, QString *entryPath,
+        MetaArchiveEntries *entries) const;
+
+    static QString archivePath(const QString &directory, const QString &name);
+    static void createArchive(const QString &archivePath, const QString &directory);
+    static MetaArchiveEntries readArchive(const QString &archivePath);
+    static void extractArchive(const QString &archivePath, const QString &targetDirectory);
+
+private:
+    MetaArchiveEngineHandler() {}
+    ~MetaArchiveEngineHandler() {}
+
+    static QString archiveKey(const QString &archivePath);
+
+private:
+    struct Archive
+    {
+        QString path;
+        MetaArchiveEntries entries;
+    };
+
+    mutable QMutex m_mutex;
+    QHash<QString, Archive> m_archives;
+};
+
+} // namespace QInstaller
+
+#endif // METAARCHIVEENGINEHANDLER_H
@@ -28,8 +28,11 @@
 
 #include "metadata.h"
 
+#include "binaryformat.h"
 #include "constants.h"
+#include "errors.h"
 #include "globals.h"
+#include "metaarchiveenginehandler.h"
 #include "metadatajob.h"
 
 #include <QCryptographicHash>
@@ -37,9 +40,29 @@
 #include <QDomDocument>
 #include <QFile>
 #include <QByteArrayMatcher>
+#include <QDateTime>
 
 namespace QInstaller {
 
+static const QLatin1String scMetaFilesStamp("metafiles.stamp");
+static const QLatin1String scDeferredMetaFilesStamp("deferredmetafiles.stamp");
+
+/*!
+    \internal
+
+    Returns a string identifying the current version of the file at \a filePath
+    on disk, consisting of the size and the last modification time of the file.
+*/
+static QByteArray fileStamp(const QString &filePath)
+{
+    const QFileInfo fileInfo(filePath);
+    if (!fileInfo.exists())
+        return QByteArray();
+
+    return QByteArray::number(fileInfo.size()) + ' '
+        + QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch());
+}
+
 /*!
     \inmodule QtInstallerFramework
     \class QInstaller::Metadata
@@ -50,23 +73,34 @@ namespace QInstaller {
 /*!
     \internal
 */
-static bool verifyFileIntegrityFromElement(const QDomElement &element, const QString &childNodeName,
-    const QString &attribute, const QString &metaDirectory, bool testChecksum)
+static QStringList fileNamesFromElement(const QDomElement &element, const QString &childNodeName,
+    const QString &attribute)
 {
+    QStringList fileNames;
     const QDomNodeList nodes = element.childNodes();
     for (int i = 0; i < nodes.count(); ++i) {
         const QDomNode node = nodes.at(i);
         if (node.nodeName() != childNodeName)
             continue;
 
-        const QDir dir(metaDirectory);
         const QString filename = attribute.isEmpty()
             ? node.toElement().text()
             : node.toElement().attribute(attribute);
 
-        if (filename.isEmpty())
-            continue;
+        if (!filename.isEmpty())
+            fileNames.append(filename);
+    }
+    return fileNames;
+}
 
+/*!
+    \internal
+*/
+static bool verifyFileIntegrity(const QStringList &fileNames, const QString &metaDirectory,
+    bool testChecksum, QStringList *verifiedFiles)
+{
+    const QDir dir(metaDirectory);
+    for (const QString &filename : fileNames) {
         QFile file(dir.absolutePath() + QDir::separator() + filename);
         if (!file.open(QIODevice::ReadOnly)) {
             qCWarning(QInstaller::lcInstallerInstallLog)
@@ -75,6 +109,7 @@ static bool verifyFileIntegrityFromElement(const QDomElement &element, const QSt
             return false;
         }
 
+        verifiedFiles->append(file.fileName());
         if (!testChecksum)
             continue;
 
@@ -92,6 +127,54 @@ static bool verifyFileIntegrityFromElement(const QDomElement &element, const QSt
     return true;
 }
 
+/*!
+    \internal
+
+    Verifies the files \a fileNames of a packed meta data archive at \a archivePath. The
+    checksum files stored when the meta data was unpacked are part of the archive.
+*/
+static bool verifyArchiveIntegrity(const QStringList &fileNames, const QString &archivePath,
+    bool testChecksum, QStringList *verifiedFiles)
+{
+    MetaArchiveEntries entries;
+    try {
+        entries = MetaArchiveEngineHandler::readArchive(archivePath);
+    } catch (const Error &error) {
+        qCWarning(QInstaller::lcInstallerInstallLog) << error.message();
+        return false;
+    }
+
+    for (const QString &filename : fileNames) {
+        const auto it = entries.constFind(QDir::cleanPath(filename));
+        if (it == entries.constEnd()) {
+            qCWarning(QInstaller::lcInstallerInstallLog)
+                << "Cannot find" << filename << "in" << archivePath;
+            return false;
+        }
+        if (!testChecksum)
+            continue;
+
+        Resource resource(archivePath, it.value());
+        if (!resource.open()) {
+            qCWarning(QInstaller::lcInstallerInstallLog)
+                << "Cannot open" << archivePath
+                << "for reading:" << resource.errorString();
+            return false;
+        }
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(&resource);
+
+        const QByteArray checksum = hash.result().toHex();
+        if (!entries.contains(QString::fromLatin1(checksum) + QLatin1String(".sha1"))) {
+            qCWarning(QInstaller::lcInstallerInstallLog)
+                << "Unexpected checksum for file" << filename << "in" << archivePath;
+            return false;
+        }
+    }
+    verifiedFiles->append(archivePath);
+    return true;
+}
+
 /*!
     Constructs a new metadata object.
 */
@@ -170,12 +253,21 @@ QDomDocument Metadata::updatesDocument() const
 /*!
     Returns \c true if the \c Updates.xml document of this metadata exists, and that all
     meta files referenced in the document exist. If the \c Updates.xml contains a \c Checksum
-    element with a value of \c true, the integrity of the files is also verified.
+    element with a value of \c true, the integrity of the files is also verified. The meta
+    files of components whose meta data is packed in the cache are looked up in their
+    meta data archive.
+
+    After a successful verification the size and modification time of each verified
+    file is stored to the metadata directory. Subsequent calls skip reading the files
+    as long as none of them has changed on disk.
 
     Returns \c false otherwise.
 */
 bool Metadata::isValid() const
 {
+    if (matchesVerifiedStamp())
+        return true;
+
     QFile updateFile(path() + QLatin1String("/Updates.xml"));
     if (!updateFile.open(QIODevice::ReadOnly)) {
         qCWarning(QInstaller::lcInstallerInstallLog)
@@ -184,7 +276,13 @@ bool Metadata::isValid() const
         return false;
     }
 
-    return verifyMetaFiles(&updateFile);
+    QStringList verifiedFiles;
+    if (!verifyMetaFiles(&updateFile, &verifiedFiles))
+        return false;
+
+    verifiedFiles.prepend(updateFile.fileName());
+    writeVerifiedStamp(verifiedFiles);
+    return true;
 }
 
 /*!
@@ -333,14 +431,61 @@ bool Metadata::containsRepositoryUpdates() const
     return false;
 }
 
+/*!
+    Returns the parsed contents of the \c Updates.xml document of this metadata,
+    or an unread object if the document has not been parsed in this session or the
+    parsed contents have been released after the package list was built.
+
+    \sa setUpdatesInfo()
+*/
+KDUpdater::UpdatesInfo Metadata::updatesInfo() const
+{
+    return m_updatesInfo;
+}
+
+/*!
+    Sets the parsed contents of the \c Updates.xml document of this metadata
+    to \a updatesInfo, so that it can be reused without reading the file again.
+*/
+void Metadata::setUpdatesInfo(const KDUpdater::UpdatesInfo &updatesInfo)
+{
+    m_updatesInfo = updatesInfo;
+}
+
+/*!
+    Returns \c true if the meta data archives of the components in this metadata
+    are fetched on demand, \c false if they are fetched with the \c Updates.xml file.
+*/
+bool Metadata::isMetaFetchDeferred() const
+{
+    return QFileInfo::exists(path() + QLatin1Char('/') + scDeferredMetaFilesStamp);
+}
+
+/*!
+    Marks the meta data archives of the components in this metadata to be fetched on
+    demand. The mark is stored to the metadata directory, so that it persists in the cache.
+    Component directories that have not been fetched yet are then not considered when
+    verifying the metadata.
+*/
+void Metadata::setMetaFetchDeferred()
+{
+    QFile stampFile(path() + QLatin1Char('/') + scDeferredMetaFilesStamp);
+    if (!stampFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(QInstaller::lcInstallerInstallLog) << "Cannot open" << stampFile.fileName()
+            << "for writing:" << stampFile.errorString();
+    }
+}
+
 /*!
     Verifies that the files referenced in \a updateFile document exist
     on disk. If the document contains a \c Checksum element with a value
     of \c true, the integrity of the files is also verified.
 
+    The paths of the verified files are appended to \a verifiedFiles.
+
     Returns \c true if the meta files are valid, \c false otherwise.
 */
-bool Metadata::verifyMetaFiles(QFile *updateFile) const
+bool Metadata::verifyMetaFiles(QFile *updateFile, QStringList *verifiedFiles) const
 {
     QDomDocument doc;
     QDomDocument::ParseResult result = doc.setContent(updateFile);
@@ -354,6 +499,7 @@ bool Metadata::verifyMetaFiles(QFile *updateFile) const
     const QDomElement rootElement = doc.documentElement();
     const QDomNodeList childNodes = rootElement.childNodes();
 
+    const bool metaFetchDeferred = isMetaFetchDeferred();
     bool testChecksum = true;
     const QDomElement checksumElement = rootElement.firstChildElement(QLatin1String("Checksum"));
     if (!checksumElement.isNull())
@@ -373,39 +519,97 @@ bool Metadata::verifyMetaFiles(QFile *updateFile) const
         if (!MetadataJob::parsePackageUpdate(c2, packageName, unused1, unused2, true, true))
             continue; // nothing to check for this package
 
-        const QString packagePath = QString::fromLatin1("%1/%2/").arg(path(), packageName);
+        QStringList fileNames;
         for (auto &metaTagName : scMetaElements) {
             const QDomElement metaElement = element.firstChildElement(metaTagName);
             if (metaElement.isNull())
                 continue;
 
             if (metaElement.tagName() == QLatin1String("Licenses")) {
-                if (!verifyFileIntegrityFromElement(metaElement, QLatin1String("License"),
-                        QLatin1String("file"), packagePath, testChecksum)) {
-                    return false;
-                }
+                fileNames.append(fileNamesFromElement(metaElement, QLatin1String("License"),
+                    QLatin1String("file")));
             } else if (metaElement.tagName() == QLatin1String("UserInterfaces")) {
-                if (!verifyFileIntegrityFromElement(metaElement, QLatin1String("UserInterface"),
-                        QString(), packagePath, testChecksum)) {
-                    return false;
-                }
+                fileNames.append(fileNamesFromElement(metaElement, QLatin1String("UserInterface"),
+                    QString()));
             } else if (metaElement.tagName() == QLatin1String("Translations")) {
-                if (!verifyFileIntegrityFromElement(metaElement, QLatin1String("Translation"),
-                        QString(), packagePath, testChecksum)) {
-                    return false;
-                }
+                fileNames.append(fileNamesFromElement(metaElement, QLatin1String("Translation"),
+                    QString()));
             } else if (metaElement.tagName() == QLatin1String("Script")) {
-                if (!verifyFileIntegrityFromElement(metaElement.parentNode().toElement(),
-                        QLatin1String("Script"), QString(), packagePath, testChecksum)) {
-                    return false;
-                }
+                fileNames.append(fileNamesFromElement(metaElement.parentNode().toElement(),
+                    QLatin1String("Script"), QString()));
             } else {
                 Q_ASSERT_X(false, Q_FUNC_INFO, "Unknown meta element.");
             }
         }
+        if (fileNames.isEmpty())
+            continue;
+
+        const QString archivePath = MetaArchiveEngineHandler::archivePath(path(), packageName);
+        if (QFileInfo::exists(archivePath)) {
+            if (!verifyArchiveIntegrity(fileNames, archivePath, testChecksum, verifiedFiles))
+                return false;
+            continue;
+        }
+
+        const QString packagePath = QString::fromLatin1("%1/%2/").arg(path(), packageName);
+        if (metaFetchDeferred && !QFileInfo::exists(packagePath))
+            continue; // not fetched yet
+        if (!verifyFileIntegrity(fileNames, packagePath, testChecksum, verifiedFiles))
+            return false;
     }
 
     return true;
 }
 
+/*!
+    Returns \c true if the stamp written by the last successful verification
+    exists and none of the files listed in it have changed since.
+*/
+bool Metadata::matchesVerifiedStamp() const
+{
+    QFile stampFile(path() + QLatin1Char('/') + scMetaFilesStamp);
+    if (!stampFile.open(QIODevice::ReadOnly))
+        return false;
+
+    const QDir metaDirectory(path());
+    bool hasEntries = false;
+    while (!stampFile.atEnd()) {
+        const QByteArray line = stampFile.readLine().trimmed();
+        if (line.isEmpty())
+            continue;
+
+        // Each line has the format: <size> <modification time> <relative file path>
+        const int pathIndex = line.indexOf(' ', line.indexOf(' ') + 1);
+        if (pathIndex == -1)
+            return false;
+
+        const QString filePath = metaDirectory.absoluteFilePath(QString::fromUtf8(line.mid(pathIndex + 1)));
+        if (fileStamp(filePath) != line.left(pathIndex))
+            return false;
+
+        hasEntries = true;
+    }
+    return hasEntries;
+}
+
+/*!
+    Writes the size and modification time of each file in \a verifiedFiles to
+    the stamp file of this metadata.
+*/
+void Metadata::writeVerifiedStamp(const QStringList &verifiedFiles) const
+{
+    QFile stampFile(path() + QLatin1Char('/') + scMetaFilesStamp);
+    if (!stampFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCDebug(QInstaller::lcDeveloperBuild) << "Cannot open" << stampFile.fileName()
+            << "for writing:" << stampFile.errorString();
+        return;
+    }
+
+    const QDir metaDirectory(path());
+    for (const QString &filePath : verifiedFiles) {
+        stampFile.write(fileStamp(filePath) + ' '
+            + metaDirectory.relativeFilePath(filePath).toUtf8() + '\n');
+    }
+}
+
 } // namespace QInstaller
@@ -32,6 +32,7 @@
 #include "installer_global.h"
 #include "genericdatacache.h"
 #include "repository.h"
+#include "updatesinfo_p.h"
 
 #include <QDomDocument>
 
@@ -65,13 +66,22 @@ public:
 
     bool containsRepositoryUpdates() const;
 
+    KDUpdater::UpdatesInfo updatesInfo() const;
+    void setUpdatesInfo(const KDUpdater::UpdatesInfo &updatesInfo);
+
+    bool isMetaFetchDeferred() const;
+    void setMetaFetchDeferred();
+
 private:
-    bool verifyMetaFiles(QFile *updateFile) const;
+    bool verifyMetaFiles(QFile *updateFile, QStringList *verifiedFiles) const;
+    bool matchesVerifiedStamp() const;
+    void writeVerifiedStamp(const QStringList &verifiedFiles) const;
 
 private:
     Repository m_repository;
     QString m_persistentRepositoryPath;
     mutable QByteArray m_checksum;
+    KDUpdater::UpdatesInfo m_updatesInfo;
 
     bool m_fromDefaultRepository;
 };
@@ -37,6 +37,7 @@
 #include "testrepository.h"
 #include "globals.h"
 
+#include <QElapsedTimer>
 #include <QTemporaryDir>
 #include <QtConcurrent>
 #include <QtMath>
@@ -83,8 +84,12 @@ MetadataJob::MetadataJob(QObject *parent)
     , m_core(nullptr)
     , m_downloadType(DownloadType::All)
     , m_downloadableChunkSize(1000)
+    , m_maxConcurrentDownloads(32)
+    , m_maxDownloadsPerHost(0)
     , m_taskNumber(0)
+    , m_metadataDownloadFinished(false)
     , m_defaultRepositoriesFetched(false)
+    , m_fetchingComponentMetadata(false)
 {
     QByteArray downloadableChunkSize = qgetenv("IFW_METADATA_SIZE");
     if (!downloadableChunkSize.isEmpty()) {
@@ -92,9 +97,22 @@ MetadataJob::MetadataJob(QObject *parent)
         if (chunkSize > 0)
             m_downloadableChunkSize = chunkSize;
     }
+    QByteArray concurrentDownloads = qgetenv("IFW_METADATA_CONCURRENT_DOWNLOADS");
+    if (!concurrentDownloads.isEmpty()) {
+        int maxDownloads = QString::fromLocal8Bit(concurrentDownloads).toInt();
+        if (maxDownloads > 0)
+            m_maxConcurrentDownloads = maxDownloads;
+    }
+    QByteArray downloadsPerHost = qgetenv("IFW_METADATA_DOWNLOADS_PER_HOST");
+    if (!downloadsPerHost.isEmpty()) {
+        int maxDownloads = QString::fromLocal8Bit(downloadsPerHost).toInt();
+        if (maxDownloads > 0)
+            m_maxDownloadsPerHost = maxDownloads;
+    }
 
     setCapabilities(Cancelable);
     connect(&m_xmlTask, &QFutureWatcherBase::finished, this, &MetadataJob::xmlTaskFinished);
+    connect(&m_metadataTask, &QFutureWatcherBase::resultReadyAt, this, &MetadataJob::metadataResultReady);
     connect(&m_metadataTask, &QFutureWatcherBase::finished, this, &MetadataJob::metadataTaskFinished);
     connect(&m_metadataTask, &QFutureWatcherBase::progressValueChanged, this, &MetadataJob::progressChanged);
     connect(&m_updateCacheTask, &QFutureWatcherBase::finished, this, &MetadataJob::updateCacheTaskFinished);
@@ -182,6 +200,7 @@ bool MetadataJob::resetCache(bool init)
         return false;
     }
 
+    resetComponentMetadataTasks();
     if (m_metaFromCache.isValid() && !m_core->settings().persistentLocalCache())
         m_metaFromCache.clear();
 
@@ -202,6 +221,7 @@ bool MetadataJob::resetCache(bool init)
 
 bool MetadataJob::clearCache()
 {
+    resetComponentMetadataTasks();
     if (m_metaFromCache.clear())
         return true;
 
@@ -215,19 +235,37 @@ bool MetadataJob::isValidCache() const
     return m_metaFromCache.isValid();
 }
 
+/*!
+    Starts fetching the meta data archives of components to \a directories in the
+    background, unless they have been fetched or are being fetched already. Running the
+    job with the \c ComponentMetadata download type waits for them instead of fetching
+    them again.
+*/
+void MetadataJob::prefetchComponentMetadata(const QStringList &directories)
+{
+    const QList<FileTaskItem> items = deferredMetadataItems(directories);
+    if (!items.isEmpty())
+        startComponentMetadataTask(items);
+}
+
 // -- private slots
 
 void MetadataJob::doStart()
 {
     setError(Job::NoError);
     setErrorString(QString());
-    m_metadataResult.clear();
     setProgressTotalAmount(100);
 
     if (!m_core) {
         emitFinishedWithError(Job::Canceled, tr("Missing package manager core engine."));
         return; // We can't do anything here without core, so avoid tons of !m_core checks.
     }
+    if (m_downloadType == DownloadType::ComponentMetadata) {
+        fetchComponentMetadata();
+        return;
+    }
+
+    resetComponentMetadataTasks();
     if (!m_metaFromCache.isValid() && !resetCache(true)) {
         emitFinishedWithError(JobError::CacheError, m_metaFromCache.errorString());
         return;
@@ -246,6 +284,22 @@ void MetadataJob::doStart()
 
             quint64 cachedCount = 0;
             setProgressTotalAmount(0); // Show only busy indicator during this loop as we have no progress to measure
+
+            // Verify all cached items at once and remove the broken ones, so that looking
+            // up the cached repositories below only needs to compare the stamps of already
+            // verified files instead of hashing them again.
+            QElapsedTimer verifyTimer;
+            verifyTimer.start();
+            const int cachedItemCount = m_metaFromCache.items().count();
+            const QList<Metadata *> invalidItems = m_metaFromCache.invalidItems();
+            for (Metadata *invalidItem : invalidItems) {
+                // The checksum of a broken item cannot be calculated, use the cache key.
+                if (!m_metaFromCache.removeItem(QDir(invalidItem->path()).dirName().toUtf8()))
+                    qCWarning(lcInstallerInstallLog) << m_metaFromCache.errorString();
+            }
+            qCDebug(lcInstallerInstallLog).nospace() << "Verified "
+                << cachedItemCount << " cached metadata items in "
+                << verifyTimer.elapsed() << " ms. Removed invalid items: " << invalidItems.count() << ".";
             foreach (const Repository &repo, repositories) {
                 // For not blocking the UI
                 qApp->processEvents();
@@ -351,7 +405,6 @@ bool MetadataJob::startXMLTask()
     m_updatesXmlItems = m_updatesXmlItems.mid(chunkSize, m_updatesXmlItems.length());
     if (tempPackages.length() > 0) {
         DownloadFileTask *const xmlTask = new DownloadFileTask(tempPackages);
-        xmlTask->setProxyFactory(m_core->proxyFactory());
         connect(&m_xmlTask, &QFutureWatcher<FileTaskResult>::progressValueChanged, this,
                 &MetadataJob::progressChanged);
         m_xmlTask.setFuture(QtConcurrent::run(&DownloadFileTask::doTask, xmlTask));
@@ -629,7 +682,8 @@ void MetadataJob::unzipTaskFinished()
     m_unzipTasks.remove(watcher);
     delete watcher;
 
-    if (m_unzipTasks.isEmpty())
+    // Meta data archives are extracted while the remaining ones are still downloading.
+    if (m_unzipTasks.isEmpty() && m_metadataDownloadFinished)
         startUpdateCacheTask();
 }
 
@@ -643,50 +697,32 @@ void MetadataJob::setProgressTotalAmount(int maximum)
     setTotalAmount(maximum);
 }
 
+void MetadataJob::metadataResultReady(int index)
+{
+    if (error() != Job::NoError)
+        return;
+
+    try {
+        startUnzipMetadataTask(m_metadataTask.resultAt(index));
+    } catch (const TaskException &e) {
+        reset();
+        emitFinishedWithError(QInstaller::DownloadError, e.message());
+    }
+}
+
 void MetadataJob::metadataTaskFinished()
 {
+    // The job might have been finished already by an error in metadataResultReady().
+    if (error() != Job::NoError)
+        return;
+
     try {
         m_metadataTask.waitForFinished();
-        m_metadataResult.append(m_metadataTask.future().results());
-        if (!fetchMetaDataPackages()) {
-            if (m_metadataResult.count() > 0) {
-                emit infoMessage(this, tr("Extracting meta information..."));
-                foreach (const FileTaskResult &result, m_metadataResult) {
-                    const FileTaskItem item = result.value(TaskRole::TaskItem).value<FileTaskItem>();
-                    if (result.value(TaskRole::ChecksumMismatch).toBool()) {
-                        QString mismatchMessage = tr("Checksum mismatch detected for \"%1\".")
-                                .arg(item.value(TaskRole::SourceFile).toString());
-                        if (m_core->settings().allowUnstableComponents()) {
-                            m_shaMissmatchPackages.append(item.value(TaskRole::Name).toString());
-                            qCWarning(QInstaller::lcInstallerInstallLog) << mismatchMessage;
-                        } else {
-                            throw QInstaller::TaskException(mismatchMessage);
-                        }
-                        QFileInfo fi(result.target());
-                        QString targetPath = fi.absolutePath();
-                        if (m_fetchedMetadata.contains(targetPath)) {
-                            delete m_fetchedMetadata.value(targetPath);
-                            m_fetchedMetadata.remove(targetPath);
-                        }
-                        continue;
-                    }
-                    UnzipArchiveTask *task = new UnzipArchiveTask(result.target(),
-                        item.value(TaskRole::UserRole).toString());
-                    task->setRemoveArchive(true);
-                    task->setStoreChecksums(true);
-
-                    QFutureWatcher<void> *watcher = new QFutureWatcher<void>();
-                    m_unzipTasks.insert(watcher, qobject_cast<QObject*> (task));
-                    connect(watcher, &QFutureWatcherBase::finished, this, &MetadataJob::unzipTaskFinished);
-                    watcher->setFuture(QtConcurrent::run(&UnzipArchiveTask::doTask, task));
-                }
-                if (m_unzipTasks.isEmpty())
-                    startUpdateCacheTask();
-
-            } else {
-                startUpdateCacheTask();
-            }
-        }
+        m_metadataDownloadFinished = true;
+        if (m_unzipTasks.isEmpty())
+            startUpdateCacheTask();
+        else
+            emit infoMessage(this, tr("Extracting meta information..."));
     } catch (const TaskException &e) {
         reset();
         emitFinishedWithError(QInstaller::DownloadError, e.message());
@@ -721,25 +757,74 @@ void MetadataJob::updateCacheTaskFinished()
 
 // -- private
 
+/*!
+    \internal
+
+    Downloads all meta data archives in a single task. The download task keeps up to
+    \c m_maxConcurrentDownloads transfers running, at most as many against the same host as
+    the shared network session opens connections to it, and reports each archive as soon as
+    it has been downloaded, so that extracting it does not wait for the slowest transfer of a
+    fixed size chunk.
+*/
 bool MetadataJob::fetchMetaDataPackages()
 {
-    //Download files in chunks. QtConcurrent will choke if too many task is given to it
-    int chunkSize = qMin(m_packages.length(), m_downloadableChunkSize);
-    QList<FileTaskItem> tempPackages = m_packages.mid(0, chunkSize);
-    m_packages = m_packages.mid(chunkSize, m_packages.length());
-    if (tempPackages.length() > 0) {
-        setProcessedAmount(0);
-        DownloadFileTask *const metadataTask = new DownloadFileTask(tempPackages);
-        metadataTask->setProxyFactory(m_core->proxyFactory());
-        m_metadataTask.setFuture(QtConcurrent::run(&DownloadFileTask::doTask, metadataTask));
-        setInfoMessage(tr("Retrieving meta information from remote repository..."));
-        return true;
+    if (m_packages.isEmpty())
+        return false;
+
+    const QList<FileTaskItem> packages = m_packages;
+    m_packages.clear();
+    m_metadataDownloadFinished = false;
+
+    setProcessedAmount(0);
+    DownloadFileTask *const metadataTask = new DownloadFileTask(packages);
+    metadataTask->setConcurrencyLimits(m_maxConcurrentDownloads, m_maxDownloadsPerHost > 0
+        ? m_maxDownloadsPerHost : KDUpdater::FileDownloaderFactory::maxConnectionsPerHost());
+    m_metadataTask.setFuture(QtConcurrent::run(&DownloadFileTask::doTask, metadataTask));
+    setInfoMessage(tr("Retrieving meta information from remote repository..."));
+    return true;
+}
+
+/*!
+    \internal
+
+    Starts extracting the meta data archive downloaded as \a result. Throws a
+    TaskException on checksum mismatch, unless unstable components are allowed.
+*/
+void MetadataJob::startUnzipMetadataTask(const FileTaskResult &result)
+{
+    const FileTaskItem item = result.value(TaskRole::TaskItem).value<FileTaskItem>();
+    if (result.value(TaskRole::ChecksumMismatch).toBool()) {
+        QString mismatchMessage = tr("Checksum mismatch detected for \"%1\".")
+                .arg(item.value(TaskRole::SourceFile).toString());
+        if (m_core->settings().allowUnstableComponents()) {
+            m_shaMissmatchPackages.append(item.value(TaskRole::Name).toString());
+            qCWarning(QInstaller::lcInstallerInstallLog) << mismatchMessage;
+        } else {
+            throw QInstaller::TaskException(mismatchMessage);
+        }
+        QFileInfo fi(result.target());
+        QString targetPath = fi.absolutePath();
+        if (m_fetchedMetadata.contains(targetPath)) {
+            delete m_fetchedMetadata.value(targetPath);
+            m_fetchedMetadata.remove(targetPath);
+        }
+        return;
     }
-    return false;
+    UnzipArchiveTask *task = new UnzipArchiveTask(result.target(),
+        item.value(TaskRole::UserRole).toString());
+    task->setRemoveArchive(true);
+    task->setStoreChecksums(true);
+    task->setPackMetaFiles(m_core->settings().packMetadataInCache());
+
+    QFutureWatcher<void> *watcher = new QFutureWatcher<void>();
+    m_unzipTasks.insert(watcher, qobject_cast<QObject*> (task));
+    connect(watcher, &QFutureWatcherBase::finished, this, &MetadataJob::unzipTaskFinished);
+    watcher->setFuture(QtConcurrent::run(&UnzipArchiveTask::doTask, task));
 }
 
 void MetadataJob::reset()
 {
+    resetComponentMetadataTasks();
     m_packages.clear();
     m_updatesXmlItems.clear();
     m_defaultRepositoriesFetched = false;
@@ -759,7 +844,7 @@ void MetadataJob::reset()
         m_metadataTask.waitForFinished();
     } catch (...) {}
     m_tempDirDeleter.releaseAndDeleteAll();
-    m_metadataResult.clear();
+    m_metadataDownloadFinished = false;
     m_updatesXmlResult.clear();
     m_taskNumber = 0;
 }
@@ -832,62 +917,65 @@ MetadataJob::Status MetadataJob::parseUpdatesXml(const QList<FileTaskResult> &re
             continue;
 
         metadata->setChecksum(updatesChecksum);
+        metadata->setRepository(repository);
 
-        file.seek(0);
-
-        QDomDocument doc;
-        QDomDocument::ParseResult docResult = doc.setContent(&file);
-        if (!docResult) {
+        // Parse the document once, the package records are later handed over to the
+        // update finder instead of reading the file again.
+        KDUpdater::UpdatesInfo updatesInfo(repository.postLoadComponentScript());
+        updatesInfo.setFileName(result.target());
+        updatesInfo.parseFile();
+        // The parser stops at the first invalid PackageUpdate element, and the update finder
+        // drops repositories with invalid content, so do not fetch any of its meta data.
+        if (!updatesInfo.isValid()) {
             qCWarning(QInstaller::lcInstallerInstallLog).nospace() << "Cannot fetch a valid version of Updates.xml from repository "
-                               << metadata->repository().displayname() << ": " << docResult.errorMessage;
+                               << metadata->repository().displayname() << ": " << updatesInfo.errorString();
             //If there are other repositories, try to use those
             continue;
         }
-        file.close();
+        metadata->setUpdatesInfo(updatesInfo);
 
-        metadata->setRepository(repository);
         const bool online = !(metadata->repository().url().scheme()).isEmpty();
 
         bool testCheckSum = true;
-        const QDomElement root = doc.documentElement();
-        const QDomNode checksum = root.firstChildElement(QLatin1String("Checksum"));
-        if (!checksum.isNull())
-            testCheckSum = (checksum.toElement().text().toLower() == scTrue);
+        if (!updatesInfo.checkSha1CheckSum().isNull())
+            testCheckSum = (updatesInfo.checkSha1CheckSum().toLower() == scTrue);
 
         // If we have top level sha1 and MetadataName elements, we have compressed
         // all metadata inside one repository to a single 7z file. Fetch that
         // instead of component specific meta 7z files.
-        const QDomNode sha1 = root.firstChildElement(scSHA1);
-        QDomElement metadataNameElement = root.firstChildElement(scMetadataName);
-        QDomNodeList children = root.childNodes();
-        if (!sha1.isNull() && !metadataNameElement.isNull()) {
+        if (!updatesInfo.metadataSha1().isNull() && !updatesInfo.metadataName().isNull()) {
             const QString repoUrl = metadata->repository().url().toString();
-            const QString metadataName = metadataNameElement.toElement().text();
+            const QString metadataName = updatesInfo.metadataName();
             addFileTaskItem(QString::fromLatin1("%1/%2").arg(repoUrl, metadataName),
                 metadata->path() + QString::fromLatin1("/%1").arg(metadataName),
-                metadata.get(), sha1.toElement().text(), QString());
+                metadata.get(), updatesInfo.metadataSha1(), QString());
         } else {
-            bool metaFound = false;
-            for (int i = 0; i < children.count(); ++i) {
-                const QDomElement el = children.at(i).toElement();
-                if (!el.isNull() && el.tagName() == QLatin1String("PackageUpdate")) {
-                    const QDomNodeList c2 = el.childNodes();
-                    QString packageName, packageVersion, packageHash;
-                    metaFound = parsePackageUpdate(c2, packageName, packageVersion, packageHash,
-                                                   online, testCheckSum);
-
-                    // If meta element (script, licenses, etc.) is not found, no need to fetch metadata.
-                    if (metaFound) {
-                        const QString repoUrl = metadata->repository().url().toString();
-                        addFileTaskItem(QString::fromLatin1("%1/%2/%3meta.7z").arg(repoUrl, packageName, packageVersion),
-                            metadata->path() + QString::fromLatin1("/%1-%2-meta.7z").arg(packageName, packageVersion),
-                            metadata.get(), packageHash, packageName);
-                    } else {
-                        QString fileName = metadata->path() + QLatin1Char('/') + packageName;
-                        QDir directory(fileName);
-                        if (!directory.exists()) {
-                            directory.mkdir(fileName);
-                        }
+            // Compressed repositories are extracted as a whole, the meta data of components
+            // of other repositories can be fetched when the components are needed.
+            const bool fetchOnDemand = m_core->settings().fetchMetadataOnDemand()
+                && !repository.isCompressed();
+            if (fetchOnDemand)
+                metadata->setMetaFetchDeferred();
+
+            const QList<KDUpdater::UpdateInfo> packages = updatesInfo.updatesInfo();
+            for (const KDUpdater::UpdateInfo &package : packages) {
+                QString packageName, packageVersion, packageHash;
+                const bool metaFound = parsePackageUpdate(package.data, packageName,
+                    packageVersion, packageHash, online, testCheckSum);
+
+                // If meta element (script, licenses, etc.) is not found, no need to fetch metadata.
+                if (metaFound && fetchOnDemand) {
+                    continue; // see fetchComponentMetadata()
+                } else if (metaFound) {
+                    const QString repoUrl = metadata->repository().url().toString();
+                    addFileTaskItem(QString::fromLatin1("%1/%2/%3meta.7z").arg(repoUrl, packageName, packageVersion),
+                        metadata->path() + QString::fromLatin1("/%1-%2-meta.7z").arg(packageName, packageVersion),
+                        metadata.get(), packageHash, packageName);
+                } else {
+                    QString fileName = metadata->path() + QLatin1Char('/') + packageName;
+                    QDir directory(fileName);
+                    if (!directory.exists()) {
+                        directory.mkdir(fileName);
                     }
                 }
             }
@@ -905,7 +993,18 @@ MetadataJob::Status MetadataJob::parseUpdatesXml(const QList<FileTaskResult> &re
         m_fetchedMetadata.insert(metadataPath, metadata.release());
 
         // search for additional repositories that we might need to check
-        status = parseRepositoryUpdates(root, result, metadataPtr);
+        if (updatesInfo.containsRepositoryUpdates()) {
+            file.seek(0);
+            QDomDocument doc;
+            QDomDocument::ParseResult docResult = doc.setContent(&file);
+            if (!docResult) {
+                qCWarning(QInstaller::lcInstallerInstallLog).nospace() << "Cannot read repository "
+                    "updates from repository " << metadataPtr->repository().displayname() << ": "
+                    << docResult.errorMessage;
+                continue;
+            }
+            status = parseRepositoryUpdates(doc.documentElement(), result, metadataPtr);
+        }
         if (status == XmlDownloadRetry) {
             // The repository update may have removed or replaced current repositories,
             // clear repository information from cached items and refresh on next fetch run.
@@ -913,8 +1012,8 @@ MetadataJob::Status MetadataJob::parseUpdatesXml(const QList<FileTaskResult> &re
             return status;
         }
     }
-    double taskCount = m_packages.length()/static_cast<double>(m_downloadableChunkSize);
-    m_totalTaskCount = qCeil(taskCount);
+    // All meta data archives are fetched by a single, internally queued download task.
+    m_totalTaskCount = 1;
     m_taskNumber = 0;
 
     return XmlDownloadSuccess;
@@ -1035,6 +1134,12 @@ QSet<Repository> MetadataJob::getRepositories()
 
 void MetadataJob::addFileTaskItem(const QString &source, const QString &target, Metadata *metadata,
                                   const QString &sha1, const QString &packageName)
+{
+    m_packages.append(createFileTaskItem(source, target, metadata, sha1, packageName));
+}
+
+FileTaskItem MetadataJob::createFileTaskItem(const QString &source, const QString &target,
+    const Metadata *metadata, const QString &sha1, const QString &packageName) const
 {
     FileTaskItem item(source, target);
     QAuthenticator authenticator;
@@ -1045,32 +1150,287 @@ void MetadataJob::addFileTaskItem(const QString &source, const QString &target,
     item.insert(TaskRole::Checksum, sha1.toLatin1());
     item.insert(TaskRole::Authenticator, QVariant::fromValue(authenticator));
     item.insert(TaskRole::Name, packageName);
-    m_packages.append(item);
+    return item;
+}
+
+/*!
+    \internal
+
+    Returns the download items of the meta data archives to fetch for \a directories,
+    leaving out directories that exist already or whose archive is still being fetched.
+*/
+QList<FileTaskItem> MetadataJob::deferredMetadataItems(const QStringList &directories)
+{
+    QList<FileTaskItem> items;
+    for (const QString &directory : directories) {
+        const QString key = QDir::cleanPath(directory);
+        if (m_componentMetadataTasks.contains(key))
+            continue;
+
+        const QFileInfo keyInfo(key);
+        const QString metadataPath = keyInfo.absolutePath();
+        if (keyInfo.exists() || QFileInfo::exists(MetaArchiveEngineHandler::archivePath(metadataPath,
+                keyInfo.fileName()))) {
+            continue; // already fetched
+        }
+
+        if (!m_indexedMetadataPaths.contains(metadataPath)) {
+            Metadata *const metadata = m_metaFromCache.itemByChecksum(QDir(metadataPath)
+                .dirName().toUtf8());
+            if (metadata)
+                indexDeferredMetadata(metadata);
+            m_indexedMetadataPaths.insert(metadataPath);
+        }
+
+        const auto it = m_deferredMetadataItems.constFind(key);
+        if (it == m_deferredMetadataItems.constEnd()) {
+            qCWarning(QInstaller::lcInstallerInstallLog) << "Cannot find meta data to fetch for"
+                << QDir::toNativeSeparators(key);
+            continue;
+        }
+        items.append(it.value());
+    }
+    return items;
+}
+
+/*!
+    \internal
+
+    Collects the meta data archives of the components in \a metadata, reading its
+    \c Updates.xml file if it was restored from the cache without being parsed.
+*/
+void MetadataJob::indexDeferredMetadata(Metadata *metadata)
+{
+    KDUpdater::UpdatesInfo updatesInfo = metadata->updatesInfo();
+    if (updatesInfo.error() == KDUpdater::UpdatesInfo::NotYetReadError) {
+        updatesInfo = KDUpdater::UpdatesInfo(metadata->repository().postLoadComponentScript());
+        updatesInfo.setFileName(metadata->path() + QLatin1Char('/') + scUpdatesXML);
+        updatesInfo.parseFile();
+        metadata->setUpdatesInfo(updatesInfo);
+    }
+
+    const bool online = !(metadata->repository().url().scheme()).isEmpty();
+    bool testCheckSum = true;
+    if (!updatesInfo.checkSha1CheckSum().isNull())
+        testCheckSum = (updatesInfo.checkSha1CheckSum().toLower() == scTrue);
+
+    const QString repoUrl = metadata->repository().url().toString();
+    const QList<KDUpdater::UpdateInfo> packages = updatesInfo.updatesInfo();
+    for (const KDUpdater::UpdateInfo &package : packages) {
+        QString packageName, packageVersion, packageHash;
+        if (!parsePackageUpdate(package.data, packageName, packageVersion, packageHash,
+                online, testCheckSum)) {
+            continue;
+        }
+        m_deferredMetadataItems.insert(QDir::cleanPath(metadata->path() + QLatin1Char('/') + packageName),
+            createFileTaskItem(QString::fromLatin1("%1/%2/%3meta.7z").arg(repoUrl, packageName, packageVersion),
+                metadata->path() + QString::fromLatin1("/%1-%2-meta.7z").arg(packageName, packageVersion),
+                metadata, packageHash, packageName));
+    }
+}
+
+static QString componentMetadataDirectory(const FileTaskItem &item)
+{
+    return QDir::cleanPath(item.value(TaskRole::UserRole).toString() + QLatin1Char('/')
+        + item.value(TaskRole::Name).toString());
+}
+
+/*!
+    \internal
+
+    Fetches the meta data archives of components whose meta data was not fetched with
+    the \c Updates.xml file of their repository to the directories set with
+    setComponentMetadataDirectories(). Each directory is the meta data directory of a
+    component in the cache, named after the component. Archives that are already being
+    prefetched are not downloaded again. The job finishes once all the directories are
+    fetched, with a QInstaller::DownloadError if fetching any of them failed.
+*/
+void MetadataJob::fetchComponentMetadata()
+{
+    // Earlier prefetch failures are retried.
+    m_componentMetadataErrors.clear();
+    m_fetchingComponentMetadata = true;
+
+    const QList<FileTaskItem> items = deferredMetadataItems(m_componentMetadataDirectories);
+    if (!items.isEmpty()) {
+        setProgressTotalAmount(0);
+        emit infoMessage(this, tr("Retrieving component meta data from remote repositories..."));
+        startComponentMetadataTask(items);
+    }
+    finishComponentMetadataTasks(QStringList(), QString());
+}
+
+/*!
+    \internal
+
+    Downloads the meta data archives of \a items in the global thread pool. The
+    archives are extracted to their meta data directories once downloaded.
+*/
+void MetadataJob::startComponentMetadataTask(const QList<FileTaskItem> &items)
+{
+    DownloadFileTask *const task = new DownloadFileTask(items);
+    task->setConcurrencyLimits(m_maxConcurrentDownloads, m_maxDownloadsPerHost > 0
+        ? m_maxDownloadsPerHost : KDUpdater::FileDownloaderFactory::maxConnectionsPerHost());
+
+    QFutureWatcher<FileTaskResult> *const watcher = new QFutureWatcher<FileTaskResult>(this);
+    m_componentMetadataWatchers.insert(watcher, task);
+    for (const FileTaskItem &item : items)
+        m_componentMetadataTasks.insert(componentMetadataDirectory(item), watcher);
+
+    connect(watcher, &QFutureWatcherBase::finished, this,
+        &MetadataJob::componentMetadataDownloadFinished);
+    watcher->setFuture(QtConcurrent::run(&DownloadFileTask::doTask, task));
+}
+
+void MetadataJob::componentMetadataDownloadFinished()
+{
+    QFutureWatcher<FileTaskResult> *const watcher
+        = static_cast<QFutureWatcher<FileTaskResult> *>(sender());
+    m_componentMetadataWatchers.take(watcher)->deleteLater();
+    watcher->deleteLater();
+
+    QString error;
+    QList<FileTaskResult> results;
+    try {
+        results = watcher->future().results();  // trigger possible exceptions
+    } catch (const TaskException &e) {
+        error = e.message();
+    } catch (const QUnhandledException &e) {
+        error = QLatin1String(e.what());
+    } catch (...) {
+        error = tr("Unknown exception during download.");
+    }
+
+    for (const FileTaskResult &result : std::as_const(results)) {
+        const FileTaskItem item = result.value(TaskRole::TaskItem).value<FileTaskItem>();
+        const QString directory = componentMetadataDirectory(item);
+        if (result.value(TaskRole::ChecksumMismatch).toBool()) {
+            QFile::remove(result.target());
+            finishComponentMetadataTasks(QStringList(directory), tr("Checksum mismatch detected "
+                "for \"%1\".").arg(item.value(TaskRole::SourceFile).toString()));
+            continue;
+        }
+
+        UnzipArchiveTask *const task = new UnzipArchiveTask(result.target(),
+            item.value(TaskRole::UserRole).toString());
+        task->setRemoveArchive(true);
+        task->setStoreChecksums(true);
+        task->setPackMetaFiles(m_core->settings().packMetadataInCache());
+
+        QFutureWatcher<void> *const unzipWatcher = new QFutureWatcher<void>(this);
+        m_componentMetadataWatchers.insert(unzipWatcher, task);
+        m_componentMetadataTasks.insert(directory, unzipWatcher);
+        connect(unzipWatcher, &QFutureWatcherBase::finished, this,
+            &MetadataJob::componentMetadataUnzipFinished);
+        unzipWatcher->setFuture(QtConcurrent::run(&UnzipArchiveTask::doTask, task));
+    }
+
+    // Directories without a result could not be downloaded.
+    if (error.isEmpty())
+        error = tr("Cannot download component meta data.");
+    finishComponentMetadataTasks(m_componentMetadataTasks.keys(watcher), error);
 }
 
-bool MetadataJob::parsePackageUpdate(const QDomNodeList &c2, QString &packageName,
+void MetadataJob::componentMetadataUnzipFinished()
+{
+    QFutureWatcher<void> *const watcher = static_cast<QFutureWatcher<void> *>(sender());
+    delete m_componentMetadataWatchers.take(watcher);
+    watcher->deleteLater();
+
+    QString error;
+    try {
+        watcher->waitForFinished();    // trigger possible exceptions
+    } catch (const UnzipArchiveException &e) {
+        error = e.message();
+    } catch (const QUnhandledException &e) {
+        error = QLatin1String(e.what());
+    } catch (...) {
+        error = tr("Unknown exception during extracting.");
+    }
+    finishComponentMetadataTasks(m_componentMetadataTasks.keys(watcher), error);
+}
+
+/*!
+    \internal
+
+    Marks \a directories as no longer being fetched, and remembers \a error for them
+    unless it is empty. Finishes the job if it fetches component meta data and none of
+    its directories is being fetched anymore.
+*/
+void MetadataJob::finishComponentMetadataTasks(const QStringList &directories, const QString &error)
+{
+    for (const QString &directory : directories) {
+        m_componentMetadataTasks.remove(directory);
+        if (!error.isEmpty())
+            m_componentMetadataErrors.insert(directory, error);
+    }
+    if (!m_fetchingComponentMetadata)
+        return;
+
+    // Directories fetched by the same task share the error, report it once.
+    QSet<QString> errors;
+    for (const QString &directory : std::as_const(m_componentMetadataDirectories)) {
+        const QString key = QDir::cleanPath(directory);
+        if (m_componentMetadataTasks.contains(key))
+            return;
+        const QString message = m_componentMetadataErrors.value(key);
+        if (!message.isEmpty())
+            errors.insert(message);
+    }
+
+    // Failed fetches are retried the next time the components are needed.
+    m_fetchingComponentMetadata = false;
+    m_componentMetadataErrors.clear();
+    setProgressTotalAmount(100);
+    if (errors.isEmpty()) {
+        emitFinished();
+    } else {
+        emitFinishedWithError(QInstaller::DownloadError,
+            QStringList(errors.cbegin(), errors.cend()).join(QLatin1Char('\n')));
+    }
+}
+
+/*!
+    \internal
+
+    Waits for the meta data archives being fetched on demand and forgets the archives
+    known to be available, as the cache items may change when the job is run again.
+    Components register their packed meta data archives again when loaded.
+*/
+void MetadataJob::resetComponentMetadataTasks()
+{
+    for (auto it = m_componentMetadataWatchers.cbegin(); it != m_componentMetadataWatchers.cend(); ++it) {
+        QFutureWatcherBase *const watcher = it.key();
+        watcher->disconnect(this);
+        try {
+            watcher->waitForFinished();
+        } catch (...) {}
+        watcher->deleteLater();
+        it.value()->deleteLater();
+    }
+    m_componentMetadataWatchers.clear();
+    m_componentMetadataTasks.clear();
+    m_componentMetadataErrors.clear();
+    m_fetchingComponentMetadata = false;
+    m_deferredMetadataItems.clear();
+    m_indexedMetadataPaths.clear();
+    MetaArchiveEngineHandler::instance()->clear();
+}
+
+bool MetadataJob::parsePackageUpdate(const QHash<QString, QVariant> &data, QString &packageName,
                                     QString &packageVersion, QString &packageHash,
                                     bool online, bool testCheckSum)
 {
-    bool metaFound = false;
-    for (int j = 0; j < c2.count(); ++j) {
-        const QDomElement element = c2.at(j).toElement();
-        if (element.tagName() == scName)
-            packageName = element.text();
-        else if (element.tagName() == scVersion)
-            packageVersion = (online ? element.text() : QString());
-        else if ((element.tagName() == QLatin1String("SHA1")) && testCheckSum)
-            packageHash = element.text();
-        else {
-            foreach (QString meta, scMetaElements) {
-                if (element.tagName() == meta) {
-                    metaFound = true;
-                    break;
-                }
-            }
-        }
+    packageName = data.value(scName).toString();
+    packageVersion = (online ? data.value(scVersion).toString() : QString());
+    if (testCheckSum)
+        packageHash = data.value(QLatin1String("SHA1")).toString();
+
+    for (const QString &meta : scMetaElements) {
+        if (data.contains(meta))
+            return true;
     }
-    return metaFound;
+    return false;
 }
 
 QMultiHash<QString, QPair<Repository, Repository> > MetadataJob::searchAdditionalRepositories
@@ -38,7 +38,6 @@
 
 #include <QFutureWatcher>
 
-class QDomNodeList;
 class QDomNode;
 
 namespace QInstaller {
@@ -48,7 +47,8 @@ class PackageManagerCore;
 enum DownloadType
 {
     All,
-    CompressedPackage
+    CompressedPackage,
+    ComponentMetadata
 };
 
 class INSTALLER_EXPORT MetadataJob : public Job
@@ -76,21 +76,30 @@ public:
     bool clearCache();
     bool isValidCache() const;
 
+    void setComponentMetadataDirectories(const QStringList &directories) {
+        m_componentMetadataDirectories = directories;
+    }
+    void prefetchComponentMetadata(const QStringList &directories);
+
 private slots:
     void doStart() override;
     void doCancel() override;
 
     void xmlTaskFinished();
     void unzipTaskFinished();
+    void metadataResultReady(int index);
     void metadataTaskFinished();
     void updateCacheTaskFinished();
     void progressChanged(int progress);
     void setProgressTotalAmount(int maximum);
     void unzipRepositoryTaskFinished();
     bool startXMLTask();
+    void componentMetadataDownloadFinished();
+    void componentMetadataUnzipFinished();
 
 private:
     bool fetchMetaDataPackages();
+    void startUnzipMetadataTask(const FileTaskResult &result);
     void startUnzipRepositoryTask(const Repository &repo);
     void startUpdateCacheTask();
     void resetCacheRepositories();
@@ -103,7 +112,15 @@ private:
     QSet<Repository> getRepositories();
     void addFileTaskItem(const QString &source, const QString &target, Metadata *metadata,
                          const QString &sha1, const QString &packageName);
-    static bool parsePackageUpdate(const QDomNodeList &c2, QString &packageName, QString &packageVersion,
+    FileTaskItem createFileTaskItem(const QString &source, const QString &target,
+                         const Metadata *metadata, const QString &sha1, const QString &packageName) const;
+    QList<FileTaskItem> deferredMetadataItems(const QStringList &directories);
+    void indexDeferredMetadata(Metadata *metadata);
+    void fetchComponentMetadata();
+    void startComponentMetadataTask(const QList<FileTaskItem> &items);
+    void finishComponentMetadataTasks(const QStringList &directories, const QString &error);
+    void resetComponentMetadataTasks();
+    static bool parsePackageUpdate(const QHash<QString, QVariant> &data, QString &packageName, QString &packageVersion,
                             QString &packageHash, bool online, bool testCheckSum);
     QMultiHash<QString, QPair<Repository, Repository> > searchAdditionalRepositories(const QDomNode &repositoryUpdate,
                             const FileTaskResult &result, const Metadata &metadata);
@@ -126,17 +143,29 @@ private:
     QHash<QFutureWatcher<void> *, QObject*> m_unzipTasks;
     QHash<QFutureWatcher<void> *, QObject*> m_unzipRepositoryTasks;
     DownloadType m_downloadType;
-    QList<FileTaskResult> m_metadataResult;
     QList<FileTaskResult> m_updatesXmlResult;
     int m_downloadableChunkSize;
+    int m_maxConcurrentDownloads;
+    int m_maxDownloadsPerHost;
     int m_taskNumber;
     int m_totalTaskCount;
+    bool m_metadataDownloadFinished;
     QStringList m_shaMissmatchPackages;
     bool m_defaultRepositoriesFetched;
 
     QSet<Repository> m_fetchedCategorizedRepositories;
     QHash<QString, Metadata *> m_fetchedMetadata;
     MetadataCache m_metaFromCache;
+
+    // Meta data archives fetched on demand, by component meta data directory
+    QHash<QString, FileTaskItem> m_deferredMetadataItems;
+    QSet<QString> m_indexedMetadataPaths;
+    // Directories being fetched, by the watcher of their current download or extract task
+    QHash<QString, QFutureWatcherBase *> m_componentMetadataTasks;
+    QHash<QFutureWatcherBase *, QObject *> m_componentMetadataWatchers;
+    QHash<QString, QString> m_componentMetadataErrors;
+    QStringList m_componentMetadataDirectories;
+    bool m_fetchingComponentMetadata;
 };
 
 }   // namespace QInstaller
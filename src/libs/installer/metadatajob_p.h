@@ -30,11 +30,14 @@
 #define METADATAJOB_P_H
 
 #include "archivefactory.h"
+#include "errors.h"
+#include "metaarchiveenginehandler.h"
 #include "metadatajob.h"
 
 #include <QCryptographicHash>
 #include <QDir>
 #include <QFile>
+#include <QTemporaryDir>
 
 namespace QInstaller{
 
@@ -66,12 +69,14 @@ public:
         , m_targetDir(target)
         , m_removeArchive(false)
         , m_storeChecksums(false)
+        , m_packMetaFiles(false)
     {}
 
     QString target() { return m_targetDir; }
     QString archive() { return m_archive; }
     void setRemoveArchive(bool remove) { m_removeArchive = remove; }
     void setStoreChecksums(bool store) { m_storeChecksums = store; }
+    void setPackMetaFiles(bool pack) { m_packMetaFiles = pack; }
 
     void doTask(QFutureInterface<void> &fi) override
     {
@@ -83,6 +88,21 @@ public:
             return; // ignore already canceled
         }
 
+        // Meta files are extracted to a temporary directory inside the target directory
+        // first, and packed to one meta data archive per component directory afterwards.
+        QScopedPointer<QTemporaryDir> packDir;
+        QString extractDir = m_targetDir;
+        if (m_packMetaFiles) {
+            packDir.reset(new QTemporaryDir(m_targetDir + QLatin1String("/XXXXXX")));
+            if (!packDir->isValid()) {
+                fi.reportException(UnzipArchiveException(MetadataJob::tr("Cannot create temporary "
+                    "directory in \"%1\": %2").arg(QDir::toNativeSeparators(m_targetDir),
+                    packDir->errorString())));
+                return;
+            }
+            extractDir = packDir->path();
+        }
+
         QScopedPointer<AbstractArchive> archive(ArchiveFactory::instance().create(m_archive));
         if (!archive) {
             fi.reportException(UnzipArchiveException(MetadataJob::tr("Unsupported archive \"%1\": no handler "
@@ -92,7 +112,7 @@ public:
             fi.reportException(UnzipArchiveException(MetadataJob::tr("Cannot open file \"%1\" for "
                 "reading: %2").arg(QDir::toNativeSeparators(m_archive), archive->errorString())));
             return;
-        } else if (!archive->extract(m_targetDir)) {
+        } else if (!archive->extract(extractDir)) {
             fi.reportException(UnzipArchiveException(MetadataJob::tr("Error while extracting "
                 "archive \"%1\": %2").arg(QDir::toNativeSeparators(m_archive), archive->errorString())));
             return;
@@ -105,7 +125,7 @@ public:
                 if (entry.isDirectory)
                     continue;
 
-                QFile file(m_targetDir + QDir::separator() + entry.path);
+                QFile file(extractDir + QDir::separator() + entry.path);
                 if (!file.open(QIODevice::ReadOnly)) {
                     fi.reportException(UnzipArchiveException(MetadataJob::tr("Cannot open extracted file \"%1\" for "
                         "reading: %2").arg(QDir::toNativeSeparators(file.fileName()), file.errorString())));
@@ -127,17 +147,45 @@ public:
         }
 
         archive->close();
+        if (m_packMetaFiles) {
+            try {
+                packMetaFiles(extractDir);
+            } catch (const Error &error) {
+                fi.reportException(UnzipArchiveException(error.message()));
+            }
+        }
         if (m_removeArchive)
             QFile::remove(m_archive);
 
         fi.reportFinished();
     }
 
+private:
+    void packMetaFiles(const QString &extractDir) const
+    {
+        const QFileInfoList entries = QDir(extractDir).entryInfoList(QDir::Dirs | QDir::Files
+            | QDir::Hidden | QDir::NoDotAndDotDot);
+        for (const QFileInfo &entry : entries) {
+            if (entry.isDir()) {
+                MetaArchiveEngineHandler::createArchive(MetaArchiveEngineHandler::archivePath(
+                    m_targetDir, entry.fileName()), entry.filePath());
+                continue;
+            }
+            const QString target = m_targetDir + QDir::separator() + entry.fileName();
+            QFile::remove(target);
+            if (!QFile::rename(entry.filePath(), target)) {
+                throw Error(MetadataJob::tr("Cannot move file \"%1\" to \"%2\".").arg(
+                    QDir::toNativeSeparators(entry.filePath()), QDir::toNativeSeparators(target)));
+            }
+        }
+    }
+
 private:
     QString m_archive;
     QString m_targetDir;
     bool m_removeArchive;
     bool m_storeChecksums;
+    bool m_packMetaFiles;
 };
 
 class CacheTaskException : public QException
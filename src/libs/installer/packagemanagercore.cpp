@@ -38,6 +38,7 @@
 #include "globals.h"
 #include "messageboxhandler.h"
 #include "packagemanagerproxyfactory.h"
+#include "phasetracer.h"
 #include "progresscoordinator.h"
 #include "qprocesswrapper.h"
 #include "qsettingswrapper.h"
@@ -45,6 +46,7 @@
 #include "remotefileengine.h"
 #include "settings.h"
 #include "installercalculator.h"
+#include "installplan.h"
 #include "uninstallercalculator.h"
 #include "loggingutils.h"
 #include "componentsortfilterproxymodel.h"
@@ -84,6 +86,8 @@
 
 #include <QStandardPaths>
 
+#include <algorithm>
+
 /*!
     \namespace QInstaller
     \inmodule QtInstallerFramework
@@ -467,16 +471,16 @@ static bool sCreateLocalRepositoryFromBinary = false;
 static int sMaxConcurrentOperations = 0;
 
 static bool componentMatches(const Component *component, const QString &name,
-    const QString &version = QString())
+    const KDUpdater::VersionRequirement *requirement = nullptr)
 {
     if (name.isEmpty() || component->name() != name)
         return false;
 
-    if (version.isEmpty())
+    if (!requirement)
         return true;
 
     // can be remote or local version
-    return PackageManagerCore::versionMatches(component->value(scVersion), version);
+    return requirement->matches(component->versionKey());
 }
 
 /*!
@@ -590,12 +594,25 @@ bool PackageManagerCore::resetLocalCache(bool init)
 }
 
 /*!
-    Clears the contents of the cache used to store downloaded metadata.
-    Returns \c true on success, \c false otherwise. An error string can
-    be retrieved with \a error.
+    Clears the contents of the cache used to store downloaded metadata, and of the
+    cache of downloaded archives inside it. Returns \c true on success, \c false
+    otherwise. An error string can be retrieved with \a error.
 */
 bool PackageManagerCore::clearLocalCache(QString *error)
 {
+    const QString archiveCachePath = settings().localCachePath() + QLatin1String("/archives");
+    if (!d->m_archiveCache.isValid() && QFileInfo::exists(archiveCachePath)) {
+        d->m_archiveCache.setPath(archiveCachePath);
+        d->m_archiveCache.initialize();
+    }
+    // Clear the archives first, the meta data cache only removes its directory if empty.
+    if (d->m_archiveCache.isValid() && !d->m_archiveCache.clear()) {
+        if (error)
+            *error = d->m_archiveCache.errorString();
+        return false;
+    }
+    QDir(settings().localCachePath() + QLatin1String("/downloads")).removeRecursively();
+
     if (d->m_metadataJob.clearCache())
         return true;
 
@@ -625,6 +642,48 @@ bool PackageManagerCore::loadComponentScripts(const T &components, const bool po
 template bool PackageManagerCore::loadComponentScripts<QList<Component *>>(const QList<Component *> &, const bool);
 template bool PackageManagerCore::loadComponentScripts<QHash<QString, Component *>>(const QHash<QString, Component *> &, const bool);
 
+/*!
+    Starts fetching the meta data archives of \a components in the background, if the
+    meta data of the components is fetched on demand. The meta data is loaded when the
+    components are selected for installation or required by selected components.
+*/
+void PackageManagerCore::prefetchComponentMetaData(const QList<Component *> &components)
+{
+    d->prefetchDeferredMetaData(components);
+}
+
+/*!
+    Fetches and loads the meta data of the components to install whose meta data is
+    fetched on demand, and evaluates the scripts of the components to install whose
+    script is evaluated on demand. Their scripts may add dependencies when loaded, so the
+    components to install are resolved again until the meta data and scripts of all of
+    them are loaded, and orderedComponentsToInstall() returns the result. Call this before
+    the components to install are calculated for the installation, as the calculation
+    itself does not fetch anything. Returns \c false if the meta data or script of a
+    component cannot be loaded and unstable components are not allowed, \c true otherwise.
+
+    \sa calculateComponentsToInstall()
+*/
+bool PackageManagerCore::fetchComponentsToInstallMetaData()
+{
+    forever {
+        d->clearInstallerCalculator();
+        if (!d->installerCalculator()->solve())
+            return true; // reported when calculating the components to install
+
+        QList<Component *> deferred;
+        const QList<Component *> resolved = d->installerCalculator()->resolvedComponents();
+        for (Component *component : resolved) {
+            if (component->isMetaDataDeferred() || component->isScriptDeferred())
+                deferred.append(component);
+        }
+        if (deferred.isEmpty())
+            return true;
+        if (!d->loadDeferredMetaData(deferred))
+            return false;
+    }
+}
+
 /*!
     Saves the installer \a args user has given when running installer. Command and option arguments
     are not saved.
@@ -814,12 +873,8 @@ quint64 PackageManagerCore::size(QInstaller::Component *component, const QString
  */
 quint64 PackageManagerCore::requiredDiskSpace() const
 {
-    quint64 result = 0;
-
-    foreach (QInstaller::Component *component, orderedComponentsToInstall())
-        result += size(component, isOfflineGenerator() ? scCompressedSize : scUncompressedSize);
-
-    return result;
+    const InstallPlan *plan = d->installPlan();
+    return isOfflineGenerator() ? plan->compressedSize() : plan->uncompressedSize();
 }
 
 /*!
@@ -828,14 +883,22 @@ quint64 PackageManagerCore::requiredDiskSpace() const
  */
 quint64 PackageManagerCore::requiredTemporaryDiskSpace() const
 {
-    quint64 result = 0;
-    foreach (QInstaller::Component *component, orderedComponentsToInstall()) {
-        if (!component->isFromOnlineRepository())
-            continue;
+    return d->installPlan()->temporarySize();
+}
 
-        result += size(component, scCompressedSize);
-    }
-    return result;
+/*!
+    Returns information about the current install plan: the ordered names of
+    the components to install, the archives to download, the byte totals and
+    whether admin rights are required. The plan is calculated once and reused
+    until the components to install are recalculated, or a component changes
+    its sizes, its admin rights requirement, or its downloadable archives.
+
+    \sa {installer::installPlan}{installer.installPlan}
+    \sa calculateComponentsToInstall()
+*/
+QVariantMap PackageManagerCore::installPlan() const
+{
+    return d->installPlan()->toVariantMap();
 }
 
 /*!
@@ -847,22 +910,9 @@ int PackageManagerCore::downloadNeededArchives(double partProgressSize)
 {
     Q_ASSERT(partProgressSize >= 0 && partProgressSize <= 1);
 
-    QList<DownloadItem> archivesToDownload;
-    quint64 archivesToDownloadTotalSize = 0;
-    QList<Component*> neededComponents = orderedComponentsToInstall();
-    foreach (Component *component, neededComponents) {
-        // collect all archives to be downloaded
-        const QStringList toDownload = component->downloadableArchives();
-        bool checkSha1CheckSum = (component->value(scCheckSha1CheckSum).toLower() == scTrue);
-        foreach (const QString &versionFreeString, toDownload) {
-            DownloadItem item;
-            item.checkSha1CheckSum = checkSha1CheckSum;
-            item.fileName = scInstallerPrefixWithTwoArgs.arg(component->name(), versionFreeString);
-            item.sourceUrl = scThreeArgs.arg(component->repositoryUrl().toString(), component->name(), versionFreeString);
-            archivesToDownload.push_back(item);
-        }
-        archivesToDownloadTotalSize += component->value(scCompressedSize).toULongLong();
-    }
+    const InstallPlan *plan = d->installPlan();
+    const QList<DownloadItem> archivesToDownload = plan->archivesToDownload();
+    const quint64 archivesToDownloadTotalSize = plan->downloadSize();
 
     if (archivesToDownload.isEmpty())
         return 0;
@@ -874,6 +924,7 @@ int PackageManagerCore::downloadNeededArchives(double partProgressSize)
     archivesJob.setAutoDelete(false);
     archivesJob.setArchivesToDownload(archivesToDownload);
     archivesJob.setExpectedTotalSize(archivesToDownloadTotalSize);
+    archivesJob.setPartialDownloadDirectory(settings().localCachePath() + QLatin1String("/downloads"));
     connect(this, &PackageManagerCore::installationInterrupted, &archivesJob, &Job::cancel);
     connect(&archivesJob, &DownloadArchivesJob::outputTextChanged,
             ProgressCoordinator::instance(), &ProgressCoordinator::emitLabelAndDetailTextChanged);
@@ -885,11 +936,30 @@ int PackageManagerCore::downloadNeededArchives(double partProgressSize)
     connect(&archivesJob, &DownloadArchivesJob::hashDownloadReady,
             d, &PackageManagerCorePrivate::addPathForDeletion);
 
+    const qint64 archiveCacheSize = settings().archiveCacheSize();
+    if (archiveCacheSize > 0 && !d->m_archiveCache.isValid()) {
+        d->m_archiveCache.setPath(settings().localCachePath() + QLatin1String("/archives"));
+        if (!d->m_archiveCache.initialize()) {
+            qCWarning(QInstaller::lcInstallerInstallLog) << "Cannot use archive cache:"
+                << d->m_archiveCache.errorString();
+        }
+    }
+    if (archiveCacheSize > 0 && d->m_archiveCache.isValid())
+        archivesJob.setArchiveCache(&d->m_archiveCache);
+
     ProgressCoordinator::instance()->registerPartProgress(&archivesJob,
         SIGNAL(progressChanged(double)), partProgressSize);
 
-    archivesJob.start();
-    archivesJob.waitForFinished();
+    {
+        PhaseTracer::Scope trace("Download archives");
+        archivesJob.start();
+        archivesJob.waitForFinished();
+    }
+
+    if (archiveCacheSize > 0 && d->m_archiveCache.isValid()) {
+        d->m_archiveCache.evict(archiveCacheSize);
+        d->m_archiveCache.sync();
+    }
 
     if (archivesJob.error() == Job::Canceled)
         interrupt();
@@ -2247,7 +2317,7 @@ Component *PackageManagerCore::componentByName(const QString &name) const
     if (!component)
         return nullptr;
 
-    if (componentMatches(component, fixedName, fixedVersion))
+    if (componentMatches(component, fixedName, d->versionRequirement(fixedVersion)))
         return component;
 
     return nullptr;
@@ -2279,8 +2349,9 @@ Component *PackageManagerCore::componentByName(const QString &name, const QList<
 
     parseNameAndVersion(name, &fixedName, &fixedVersion);
 
+    const KDUpdater::VersionRequirement requirement(fixedVersion);
     foreach (Component *component, components) {
-        if (componentMatches(component, fixedName, fixedVersion))
+        if (componentMatches(component, fixedName, fixedVersion.isEmpty() ? nullptr : &requirement))
             return component;
     }
 
@@ -2566,7 +2637,7 @@ QList<Component*> PackageManagerCore::dependees(const Component *_component) con
         const QStringList &dependencies = component->dependencies();
         foreach (const QString &dependency, dependencies) {
             parseNameAndVersion(dependency, &name, &version);
-            if (componentMatches(_component, name, version))
+            if (componentMatches(_component, name, d->versionRequirement(version)))
                 dependees.append(component);
         }
     }
@@ -2601,7 +2672,7 @@ bool PackageManagerCore::isDependencyForRequestedComponent(const Component *comp
             const QStringList &dependencies = availableComponent->dependencies();
             foreach (const QString &dependency, dependencies) {
                 parseNameAndVersion(dependency, &name, &version);
-                if (componentMatches(component, name, version)) {
+                if (componentMatches(component, name, d->versionRequirement(version))) {
                     return true;
                 }
             }
@@ -2627,7 +2698,7 @@ QStringList PackageManagerCore::localDependenciesToComponent(const Component *co
     for (const KDUpdater::LocalPackage &localPackage : std::as_const(localPackages)) {
         for (const QString &dependency : localPackage.dependencies) {
             parseNameAndVersion(dependency, &name, &version);
-            if (componentMatches(component, name, version)) {
+            if (componentMatches(component, name, d->versionRequirement(version))) {
                 dependents.append(localPackage.name);
             }
         }
@@ -3005,7 +3076,7 @@ PackageManagerCore::Status PackageManagerCore::updateComponentsSilently(const QS
         // restart installer and install rest of the updates.
         bool essentialUpdatesFound = false;
         foreach (Component *component, componentList) {
-            if ((component->value(scEssential, scFalse).toLower() == scTrue)
+            if (component->isEssential()
                 || component->isForcedUpdate())
                 essentialUpdatesFound = true;
         }
@@ -3130,6 +3201,15 @@ void PackageManagerCore::createAutoDependencyHash(const QString &component, cons
 {
     d->createAutoDependencyHash(component, oldDependencies, newDependencies);
 }
+
+/*!
+ * Discards the install plan, so that it is calculated again the next time it is
+ * needed. Called when a component changes a value the plan is calculated from.
+ */
+void PackageManagerCore::clearInstallPlan()
+{
+    d->clearInstallPlan();
+}
 /*!
     Uninstalls the selected components \a components without GUI.
     Returns PackageManagerCore installation status.
@@ -3705,25 +3785,7 @@ bool PackageManagerCore::performOperation(const QString &name, const QStringList
 */
 bool PackageManagerCore::versionMatches(const QString &version, const QString &requirement)
 {
-    static const QRegularExpression compEx(QLatin1String("^([<=>]+)(.*)$"));
-    const QRegularExpressionMatch match = compEx.match(requirement);
-    const QString comparator = match.hasMatch() ? match.captured(1) : QLatin1String("=");
-    const QString ver = match.hasMatch() ? match.captured(2) : requirement;
-
-    const bool allowEqual = comparator.contains(QLatin1Char('='));
-    const bool allowLess = comparator.contains(QLatin1Char('<'));
-    const bool allowMore = comparator.contains(QLatin1Char('>'));
-
-    if (allowEqual && version == ver)
-        return true;
-
-    if (allowLess && KDUpdater::compareVersion(ver, version) > 0)
-        return true;
-
-    if (allowMore && KDUpdater::compareVersion(ver, version) < 0)
-        return true;
-
-    return false;
+    return KDUpdater::VersionRequirement(requirement).matches(KDUpdater::VersionKey(version));
 }
 
 /*!
@@ -4734,7 +4796,7 @@ bool PackageManagerCore::fetchUpdaterPackages(const PackagesList &remotes, const
 
                     component->setCheckable(false);
                     component->setSelectable(false);
-                    if ((component->value(scEssential, scFalse).toLower() == scTrue)
+                    if (component->isEssential()
                         || (component->value(scForcedUpdate, scFalse).toLower() == scTrue)) {
                         // essential updates are enabled, still not checkable but checked
                         component->setEnabled(true);
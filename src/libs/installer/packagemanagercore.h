@@ -41,6 +41,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QStringList>
 #include <QtCore/QList>
+#include <QtCore/QVariantMap>
 #include <QSettings>
 #include <QModelIndex>
 
@@ -116,6 +117,7 @@ public:
         QString fileName;
         QString sourceUrl;
         bool checkSha1CheckSum;
+        QList<QByteArray> deltaBases;
     };
 
     Q_DECLARE_FLAGS(ComponentTypes, ComponentType)
@@ -345,6 +347,7 @@ public:
 
     Q_INVOKABLE quint64 requiredDiskSpace() const;
     Q_INVOKABLE quint64 requiredTemporaryDiskSpace() const;
+    Q_INVOKABLE QVariantMap installPlan() const;
 
     Q_INVOKABLE bool isProcessRunning(const QString &name) const;
     Q_INVOKABLE bool killProcess(const QString &absoluteFilePath) const;
@@ -388,6 +391,7 @@ public:
     bool hasLicenses() const;
     void createLocalDependencyHash(const QString &component, const QString &dependencies) const;
     void createAutoDependencyHash(const QString &component, const QString &oldDependencies, const QString &newDependencies) const;
+    void clearInstallPlan();
 
     bool resetLocalCache(bool init = false);
     bool clearLocalCache(QString *error = nullptr);
@@ -395,6 +399,8 @@ public:
 
     template <typename T>
     bool loadComponentScripts(const T &components, const bool postScript = false);
+    void prefetchComponentMetaData(const QList<Component *> &components);
+    bool fetchComponentsToInstallMetaData();
 
     void saveGivenArguments(const QStringList &args);
     QStringList givenArguments() const;
@@ -38,12 +38,14 @@
 #include "remotefileengine.h"
 #include "graph.h"
 #include "messageboxhandler.h"
+#include "metaarchiveenginehandler.h"
 #include "packagemanagercore.h"
 #include "progresscoordinator.h"
 #include "qprocesswrapper.h"
 #include "protocol.h"
 #include "qsettingswrapper.h"
 #include "installercalculator.h"
+#include "installplan.h"
 #include "uninstallercalculator.h"
 #include "componentalias.h"
 #include "componentchecker.h"
@@ -53,6 +55,8 @@
 #include "concurrentoperationrunner.h"
 #include "remoteclient.h"
 #include "operationtracer.h"
+#include "phasetracer.h"
+#include "utils.h"
 
 #include "selfrestarter.h"
 #include "filedownloaderfactory.h"
@@ -67,6 +71,7 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDir>
 #include <QtCore/QDirIterator>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QUuid>
 #include <QtCore/QFuture>
 #include <QtCore/QFutureWatcher>
@@ -156,6 +161,28 @@ static QString getAppBundlePath() {
     return QString();
 }
 
+static bool hasSameContent(const QString &path, const QString &otherPath)
+{
+    const QFileInfo fi(path);
+    const QFileInfo otherFi(otherPath);
+    if (!fi.isFile() || !otherFi.isFile() || fi.size() != otherFi.size())
+        return false;
+
+    return QInstaller::calculateHash(path, QCryptographicHash::Sha1)
+        == QInstaller::calculateHash(otherPath, QCryptographicHash::Sha1);
+}
+
+// On macOS the data file lives in the Resources directory of the app bundle.
+static QDir maintenanceToolResourceDir(const QString &binary)
+{
+    QDir resourcePath(QFileInfo(binary).dir());
+#ifdef Q_OS_MACOS
+    resourcePath.cdUp();
+    resourcePath.cd(QLatin1String("Resources"));
+#endif
+    return resourcePath;
+}
+
 // -- PackageManagerCorePrivate
 
 PackageManagerCorePrivate::PackageManagerCorePrivate(PackageManagerCore *core)
@@ -187,6 +214,7 @@ PackageManagerCorePrivate::PackageManagerCorePrivate(PackageManagerCore *core)
     , m_componentScriptEngine(nullptr)
     , m_controlScriptEngine(nullptr)
     , m_installerCalculator(nullptr)
+    , m_installPlan(nullptr)
     , m_uninstallerCalculator(nullptr)
     , m_proxyFactory(nullptr)
     , m_defaultModel(nullptr)
@@ -234,6 +262,7 @@ PackageManagerCorePrivate::PackageManagerCorePrivate(PackageManagerCore *core, q
     , m_componentScriptEngine(nullptr)
     , m_controlScriptEngine(nullptr)
     , m_installerCalculator(nullptr)
+    , m_installPlan(nullptr)
     , m_uninstallerCalculator(nullptr)
     , m_proxyFactory(nullptr)
     , m_defaultModel(nullptr)
@@ -258,10 +287,17 @@ PackageManagerCorePrivate::PackageManagerCorePrivate(PackageManagerCore *core, q
             continue;
         }
 
-        if (!op->fromXml(operation.xml)) {
-            qCWarning(QInstaller::lcInstallerInstallLog) << "Failed to load XML for operation"
-                << operation.name;
-            continue;
+        if (operation.component.isEmpty()) {
+            if (!op->fromXml(operation.xml)) {
+                qCWarning(QInstaller::lcInstallerInstallLog) << "Failed to load XML for operation"
+                    << operation.name;
+                continue;
+            }
+        } else {
+            // The XML is only parsed once the operation is actually needed, e.g. on undo.
+            QVariantMap knownValues;
+            knownValues.insert(QLatin1String("component"), operation.component);
+            op->setDeferredXml(operation.xml, knownValues);
         }
         m_performedOperationsOld.append(op.release());
     }
@@ -375,6 +411,7 @@ QString PackageManagerCorePrivate::componentsXmlPath() const
 
 bool PackageManagerCorePrivate::buildComponentTree(QHash<QString, Component*> &components, bool loadScript)
 {
+    PhaseTracer::Scope trace("Build component tree");
     try {
         if (statusCanceledOrFailed())
             return false;
@@ -401,6 +438,20 @@ bool PackageManagerCorePrivate::buildComponentTree(QHash<QString, Component*> &c
         if (loadScript && !loadComponentScripts(components))
             return false;
 
+        // Components whose default state is decided by their script need the script
+        // now, even if their meta data or script is otherwise loaded on demand.
+        if (loadScript) {
+            QList<Component *> scriptedDefaults;
+            for (Component *component : std::as_const(components)) {
+                if ((component->isMetaDataDeferred() || component->isScriptDeferred())
+                        && component->value(scDefault).compare(scScript, Qt::CaseInsensitive) == 0) {
+                    scriptedDefaults.append(component);
+                }
+            }
+            if (!loadDeferredMetaData(scriptedDefaults))
+                return false;
+        }
+
         // now we can preselect components in the tree
         foreach (QInstaller::Component *component, components) {
             // set the checked state for all components without child (means without tristate)
@@ -574,19 +625,44 @@ bool PackageManagerCorePrivate::buildComponentAliases()
 template <typename T>
 bool PackageManagerCorePrivate::loadComponentScripts(const T &components, const bool postScript)
 {
+    // Scripts loaded before the installation must be available also for components
+    // whose meta data is fetched on demand. Otherwise the scripts of those components
+    // are loaded when their meta data is.
+    if (postScript && !loadDeferredMetaData(QList<Component *>(components.cbegin(), components.cend())))
+        return false;
+
     infoMessage(nullptr, tr("Loading component scripts..."));
 
+    // The scripts are evaluated one by one in the shared engine, but reading them from
+    // disk does not need to wait for that.
+    QStringList scriptPaths;
+    for (auto *component : components) {
+        if (component->isMetaDataDeferred() || (!postScript && component->isScriptOnDemand()))
+            continue;
+        const QString scriptPath = component->componentScriptPath(postScript);
+        if (!scriptPath.isEmpty())
+            scriptPaths.append(scriptPath);
+    }
+    if (scriptPaths.count() > 1)
+        componentScriptEngine()->prefetchScripts(scriptPaths);
+
     quint64 loadedComponents = 0;
+    QElapsedTimer uiTimer;
+    uiTimer.start();
     for (auto *component : components) {
         if (statusCanceledOrFailed())
             return false;
 
-        component->loadComponentScript(postScript);
+        if (!component->isMetaDataDeferred())
+            component->loadComponentScript(postScript);
         ++loadedComponents;
 
-        const int currentProgress = qRound(double(loadedComponents) / components.count() * 100);
-        infoProgress(nullptr, currentProgress, 100);
-        qApp->processEvents();
+        if (uiTimer.elapsed() > 50 || loadedComponents == quint64(components.count())) {
+            const int currentProgress = qRound(double(loadedComponents) / components.count() * 100);
+            infoProgress(nullptr, currentProgress, 100);
+            qApp->processEvents();
+            uiTimer.restart();
+        }
     }
     return true;
 }
@@ -594,6 +670,77 @@ bool PackageManagerCorePrivate::loadComponentScripts(const T &components, const
 template bool PackageManagerCorePrivate::loadComponentScripts<QList<Component *>>(const QList<Component *> &, const bool);
 template bool PackageManagerCorePrivate::loadComponentScripts<QHash<QString, Component *>>(const QHash<QString, Component *> &, const bool);
 
+/*!
+    \internal
+
+    Fetches the meta data archives of those \a components whose meta data is fetched on
+    demand and loads their meta data and scripts, and evaluates the scripts of those
+    \a components whose script is evaluated on demand. A component whose meta data or
+    script cannot be loaded is marked unstable if unstable components are allowed.
+    Otherwise, sets the status to failure and returns \c false.
+*/
+bool PackageManagerCorePrivate::loadDeferredMetaData(const QList<Component *> &components)
+{
+    QList<Component *> deferredComponents;
+    QStringList directories;
+    for (Component *component : components) {
+        if (!component->isMetaDataDeferred())
+            continue;
+        deferredComponents.append(component);
+        directories.append(scTwoArgs.arg(component->localTempPath(), component->name()));
+    }
+
+    if (!deferredComponents.isEmpty()) {
+        PhaseTracer::Scope trace("Fetch component metadata", QString::number(deferredComponents.count()));
+        m_metadataJob.addDownloadType(DownloadType::ComponentMetadata);
+        m_metadataJob.setComponentMetadataDirectories(directories);
+        m_metadataJob.start();
+        m_metadataJob.waitForFinished();
+        if (m_metadataJob.error() != Job::NoError) {
+            // The components without meta data are reported below
+            qCWarning(QInstaller::lcInstallerInstallLog).noquote() << "Cannot fetch meta data:"
+                << m_metadataJob.errorString();
+        }
+    }
+
+    // Loading the meta data defers the scripts that are evaluated on demand as well.
+    for (Component *component : components) {
+        if (!component->isMetaDataDeferred() && !component->isScriptDeferred())
+            continue;
+        try {
+            component->loadDeferredMetaData();
+            component->loadDeferredScript();
+        } catch (const Error &error) {
+            if (!m_data.settings().allowUnstableComponents()) {
+                setStatus(PackageManagerCore::Failure, error.message());
+                MessageBoxHandler::critical(MessageBoxHandler::currentBestSuitParent(),
+                    QLatin1String("Error"), tr("Error"), error.message());
+                return false;
+            }
+            qCWarning(QInstaller::lcInstallerInstallLog).noquote() << error.message();
+            component->setUnstable(Component::UnstableError::ScriptLoadingFailed, error.message());
+        }
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    Starts fetching the meta data archives of those \a components whose meta data is
+    fetched on demand in the background.
+*/
+void PackageManagerCorePrivate::prefetchDeferredMetaData(const QList<Component *> &components)
+{
+    QStringList directories;
+    for (Component *component : components) {
+        if (component->isMetaDataDeferred())
+            directories.append(scTwoArgs.arg(component->localTempPath(), component->name()));
+    }
+    if (!directories.isEmpty())
+        m_metadataJob.prefetchComponentMetadata(directories);
+}
+
 void PackageManagerCorePrivate::cleanUpComponentEnvironment()
 {
     m_componentReplaces.clear();
@@ -629,6 +776,24 @@ ScriptEngine *PackageManagerCorePrivate::controlScriptEngine() const
     return m_controlScriptEngine;
 }
 
+/*!
+    \internal
+
+    Returns the version \a requirement of a dependency, like \c{>=1.2}, parsed once and
+    reused by subsequent calls with the same \a requirement. Returns \c nullptr if
+    \a requirement is empty.
+*/
+const KDUpdater::VersionRequirement *PackageManagerCorePrivate::versionRequirement(const QString &requirement)
+{
+    if (requirement.isEmpty())
+        return nullptr;
+
+    auto it = m_versionRequirements.constFind(requirement);
+    if (it == m_versionRequirements.constEnd())
+        it = m_versionRequirements.insert(requirement, KDUpdater::VersionRequirement(requirement));
+    return &it.value();
+}
+
 void PackageManagerCorePrivate::clearAllComponentLists()
 {
     qDeleteAll(m_componentAliases);
@@ -643,6 +808,7 @@ void PackageManagerCorePrivate::clearAllComponentLists()
 
     m_componentsToReplaceAllMode.clear();
     m_foundEssentialUpdate = false;
+    m_componentDependencyGraph.clear();
 
     qDeleteAll(toDelete);
     cleanUpComponentEnvironment();
@@ -670,6 +836,7 @@ void PackageManagerCorePrivate::clearUpdaterComponentLists()
 
     m_componentsToReplaceUpdaterMode.clear();
     m_foundEssentialUpdate = false;
+    m_componentDependencyGraph.clear();
 
     qDeleteAll(usedComponents);
     cleanUpComponentEnvironment();
@@ -692,6 +859,7 @@ QHash<QString, QStringList> &PackageManagerCorePrivate::componentReplaces()
 
 void PackageManagerCorePrivate::clearInstallerCalculator()
 {
+    clearInstallPlan();
     delete m_installerCalculator;
     m_installerCalculator = nullptr;
 }
@@ -705,6 +873,21 @@ InstallerCalculator *PackageManagerCorePrivate::installerCalculator() const
     return m_installerCalculator;
 }
 
+void PackageManagerCorePrivate::clearInstallPlan()
+{
+    delete m_installPlan;
+    m_installPlan = nullptr;
+}
+
+const InstallPlan *PackageManagerCorePrivate::installPlan() const
+{
+    if (!m_installPlan) {
+        PackageManagerCorePrivate *const pmcp = const_cast<PackageManagerCorePrivate *> (this);
+        pmcp->m_installPlan = new InstallPlan(installerCalculator()->resolvedComponents());
+    }
+    return m_installPlan;
+}
+
 void PackageManagerCorePrivate::clearUninstallerCalculator()
 {
     delete m_uninstallerCalculator;
@@ -805,6 +988,8 @@ void PackageManagerCorePrivate::initialize(const QHash<QString, QString> &params
     connect(&m_metadataJob, &Job::progress, this, &PackageManagerCorePrivate::infoProgress);
     connect(&m_metadataJob, &Job::totalProgress, this, &PackageManagerCorePrivate::totalProgress);
     KDUpdater::FileDownloaderFactory::instance().setProxyFactory(m_core->proxyFactory());
+    KDUpdater::FileDownloaderFactory::setHttp2Allowed(m_data.settings().allowHttp2());
+    KDUpdater::FileDownloaderFactory::setMaxConnectionsPerHost(m_data.settings().maxConnectionsPerHost());
 }
 
 bool PackageManagerCorePrivate::isOfflineOnly() const
@@ -1287,22 +1472,35 @@ void PackageManagerCorePrivate::writeMaintenanceToolBinary(QFile *const input, q
     qCDebug(QInstaller::lcInstallerInstallLog) << "Writing maintenance tool:" << maintenanceToolRenamedName;
     ProgressCoordinator::instance()->emitLabelAndDetailTextChanged(tr("Writing maintenance tool."));
 
-    QFile out(generateTemporaryFileName());
+    {
+        QFile dummy(maintenanceToolRenamedName);
+        if (dummy.exists() && !dummy.remove()) {
+            throw Error(tr("Cannot remove data file \"%1\": %2").arg(dummy.fileName(),
+                dummy.errorString()));
+        }
+    }
+
+    // Write the binary in place, copying it through a temporary file doubles the I/O.
+    QFile out(maintenanceToolRenamedName);
     QInstaller::openForWrite(&out); // throws an exception in case of error
 
     if (!input->seek(0))
         throw Error(tr("Failed to seek in file %1: %2").arg(input->fileName(), input->errorString()));
 
-    QInstaller::appendData(&out, input, size);
+    try {
+        QInstaller::appendData(&out, input, size);
+    } catch (const Error &) {
+        out.remove();   // do not leave a truncated binary behind
+        throw;
+    }
+
     if (writeBinaryLayout) {
 
-        QDir resourcePath(QFileInfo(maintenanceToolRenamedName).dir());
 #ifdef Q_OS_MACOS
-        if (!resourcePath.path().endsWith(QLatin1String("Contents/MacOS")))
+        if (!QFileInfo(maintenanceToolRenamedName).path().endsWith(QLatin1String("Contents/MacOS")))
             throw Error(tr("Maintenance tool is not a bundle"));
-        resourcePath.cdUp();
-        resourcePath.cd(QLatin1String("Resources"));
 #endif
+        const QDir resourcePath = maintenanceToolResourceDir(maintenanceToolRenamedName);
         // It's a bit odd to have only the magic in the data file, but this simplifies
         // other code a lot (since installers don't have any appended data either)
         QFile dataOut(generateTemporaryFileName());
@@ -1324,15 +1522,8 @@ void PackageManagerCorePrivate::writeMaintenanceToolBinary(QFile *const input, q
         setDefaultFilePermissions(&dataOut, DefaultFilePermissions::NonExecutable);
     }
 
-    {
-        QFile dummy(maintenanceToolRenamedName);
-        if (dummy.exists() && !dummy.remove()) {
-            throw Error(tr("Cannot remove data file \"%1\": %2").arg(dummy.fileName(),
-                dummy.errorString()));
-        }
-    }
-
-    if (!out.copy(maintenanceToolRenamedName)) {
+    out.close();
+    if (out.error() != QFileDevice::NoError) {
         throw Error(tr("Cannot write maintenance tool to \"%1\": %2").arg(maintenanceToolRenamedName,
             out.errorString()));
     }
@@ -1342,11 +1533,6 @@ void PackageManagerCorePrivate::writeMaintenanceToolBinary(QFile *const input, q
         qCDebug(QInstaller::lcInstallerInstallLog) << "Wrote permissions for maintenance tool.";
     else
         qCWarning(QInstaller::lcInstallerInstallLog) << "Failed to write permissions for maintenance tool.";
-
-    if (out.exists() && !out.remove()) {
-        qCWarning(QInstaller::lcInstallerInstallLog) << tr("Cannot remove temporary data file \"%1\": %2")
-            .arg(out.fileName(), out.errorString());
-    }
 }
 
 void PackageManagerCorePrivate::writeMaintenanceToolBinaryData(QFileDevice *output, QFile *const input,
@@ -1381,14 +1567,25 @@ void PackageManagerCorePrivate::writeMaintenanceToolBinaryData(QFileDevice *outp
 
     const qint64 operationsStart = output->pos();
     QInstaller::appendInt64(output, performedOperations.count());
+    QElapsedTimer uiTimer;
+    uiTimer.start();
     foreach (Operation *operation, performedOperations) {
         QInstaller::appendString(output, operation->name());
-        QInstaller::appendString(output, operation->toXml().toString());
+        // operations that were never touched are copied verbatim
+        const QString deferredXml = operation->deferredXml();
+        QInstaller::appendString(output, deferredXml.isEmpty()
+            ? operation->toXml().toString() : deferredXml);
 
         // for the ui not to get blocked
-        qApp->processEvents();
+        if (uiTimer.elapsed() > 100) {
+            qApp->processEvents();
+            uiTimer.restart();
+        }
     }
     QInstaller::appendInt64(output, performedOperations.count());
+    QInstaller::appendInt64(output, BinaryContent::MagicOperationIndexMarker);
+    foreach (Operation *operation, performedOperations)
+        QInstaller::appendString(output, operation->value(QLatin1String("component")).toString());
     const qint64 operationsEnd = output->pos();
 
     // we don't save any component-indexes.
@@ -1500,6 +1697,7 @@ void PackageManagerCorePrivate::writeMaintenanceToolAppBundle(OperationList &per
 
 void PackageManagerCorePrivate::writeMaintenanceTool(OperationList performedOperations)
 {
+    PhaseTracer::Scope trace("Write maintenance tool");
     if (m_disableWriteMaintenanceTool) {
         qCDebug(QInstaller::lcInstallerInstallLog()) << "Maintenance tool writing disabled.";
         return;
@@ -1562,11 +1760,20 @@ void PackageManagerCorePrivate::writeMaintenanceTool(OperationList performedOper
                 writeMaintenanceToolAppBundle(performedOperations);
                 QFile replacementBinary(installerBaseBinary);
                 try {
-                    QInstaller::openForRead(&replacementBinary);
-                    writeMaintenanceToolBinary(&replacementBinary, replacementBinary.size(), true);
-                    qCDebug(QInstaller::lcInstallerInstallLog) << "Wrote the binary with the new replacement.";
-
-                    newBinaryWritten = true;
+                    // The binary data lives in the .dat file, an identical base binary does
+                    // not need to be written again.
+                    if (!isInstaller() && hasSameContent(installerBaseBinary, mtName)
+                            && QFileInfo::exists(maintenanceToolResourceDir(mtName)
+                            .filePath(QLatin1String("installer.dat")))) {
+                        qCDebug(QInstaller::lcInstallerInstallLog) << "Replacement installer base "
+                            "binary is identical to the maintenance tool, skipped writing it.";
+                    } else {
+                        QInstaller::openForRead(&replacementBinary);
+                        writeMaintenanceToolBinary(&replacementBinary, replacementBinary.size(), true);
+                        qCDebug(QInstaller::lcInstallerInstallLog) << "Wrote the binary with the new replacement.";
+
+                        newBinaryWritten = true;
+                    }
                 } catch (const Error &error) {
                     qCWarning(QInstaller::lcInstallerInstallLog) << error.message();
                 }
@@ -1884,15 +2091,9 @@ bool PackageManagerCorePrivate::runInstaller()
             throw Error(tr("It is not possible to install from network location"));
         }
 
-        if (!m_core->hasAdminRights()) {
-            foreach (Component *component, componentsToInstall) {
-                if (component->value(scRequiresAdminRights, scFalse) == scFalse)
-                    continue;
-
-                m_core->gainAdminRights();
-                m_core->dropAdminRights();
-                break;
-            }
+        if (!m_core->hasAdminRights() && installPlan()->requiresAdminRights()) {
+            m_core->gainAdminRights();
+            m_core->dropAdminRights();
         }
 
         const double downloadPartProgressSize = double(1) / double(3);
@@ -2035,16 +2236,7 @@ bool PackageManagerCorePrivate::runPackageUpdater()
             throw Error(tr("It is not possible to run that operation from a network location"));
         }
 
-        bool updateAdminRights = false;
-        if (!adminRightsGained) {
-            foreach (Component *component, componentsToInstall) {
-                if (component->value(scRequiresAdminRights, scFalse) == scFalse)
-                    continue;
-
-                updateAdminRights = true;
-                break;
-            }
-        }
+        const bool updateAdminRights = !adminRightsGained && installPlan()->requiresAdminRights();
 
         OperationList undoOperations;
         OperationList nonRevertedOperations;
@@ -2342,6 +2534,14 @@ bool PackageManagerCorePrivate::runOfflineGenerator()
             args.resources = m_offlineGeneratorResourceCollections;
 
         foreach (auto component, componentsToInclude) {
+            // The binary creator reads the meta files from the meta data directories
+            // of the components, unpack meta data that is packed in the cache.
+            const QString archivePath = MetaArchiveEngineHandler::archivePath(
+                component->localTempPath(), component->name());
+            if (QFileInfo::exists(archivePath)) {
+                MetaArchiveEngineHandler::extractArchive(archivePath,
+                    scTwoArgs.arg(component->localTempPath(), component->name()));
+            }
             args.filteredPackages.append(component->name());
             args.repositoryDirectories.append(component->localTempPath());
         }
@@ -2395,6 +2595,7 @@ bool PackageManagerCorePrivate::runOfflineGenerator()
 void PackageManagerCorePrivate::unpackComponents(const QList<Component *> &components,
     double progressOperationSize)
 {
+    PhaseTracer::Scope trace("Unpack components");
     OperationList unpackOperations;
     bool becameAdmin = false;
 
@@ -2536,6 +2737,7 @@ void PackageManagerCorePrivate::unpackComponents(const QList<Component *> &compo
 
 void PackageManagerCorePrivate::installComponent(Component *component, double progressOperationSize)
 {
+    PhaseTracer::Scope trace("Install component", component->name());
     OperationList operations = component->operations(Operation::Install);
     if (!component->operationsCreatedSuccessfully())
         m_core->setCanceled();
@@ -2601,7 +2803,7 @@ void PackageManagerCorePrivate::installComponent(Component *component, double pr
     }
 
     if (!m_core->isCommandLineInstance()) {
-        if ((component->value(scEssential, scFalse) == scTrue) && !isInstaller())
+        if (component->isEssential() && !isInstaller())
             m_needsHardRestart = true;
         else if ((component->value(scForcedUpdate, scFalse) == scTrue) && isUpdater())
             m_needsHardRestart = true;
@@ -2625,12 +2827,12 @@ void PackageManagerCorePrivate::installComponent(Component *component, double pr
                                   QPair<QString, bool>(component->value(scTreeName),
                                                        component->treeNameMoveChildren()),
                                   component->value(scDescription),
-                                  component->value(scSortingPriority).toInt(),
+                                  component->sortingPriority(),
                                   component->dependencies(),
                                   component->autoDependencies(),
                                   component->forcedInstallation(),
                                   component->isVirtual(),
-                                  component->value(scUncompressedSize).toULongLong(),
+                                  component->uncompressedSize(),
                                   component->value(scInheritVersion),
                                   component->isCheckable(),
                                   component->isExpandedByDefault(),
@@ -2885,7 +3087,14 @@ void PackageManagerCorePrivate::runUndoOperations(const OperationList &undoOpera
             qCDebug(QInstaller::lcInstallerInstallLog) << "undo operation=" << undoOperation->name();
 
             bool ignoreError = false;
-            bool ok = performOperationThreaded(undoOperation, Operation::Undo);
+            bool ok = true;
+            if (undoOperation->error() == Operation::InvalidXml) {
+                // Nothing is known about what the operation did, so there is nothing to undo.
+                qCWarning(QInstaller::lcInstallerInstallLog) << "Skipping undo of operation"
+                    << undoOperation->name() << ":" << undoOperation->errorString();
+            } else {
+                ok = performOperationThreaded(undoOperation, Operation::Undo);
+            }
 
             const QString componentName = undoOperation->value(QLatin1String("component")).toString();
 
@@ -2943,6 +3152,19 @@ PackagesList PackageManagerCorePrivate::remotePackages()
     m_updateFinder = new KDUpdater::UpdateFinder;
     m_updateFinder->setAutoDelete(false);
     m_updateFinder->setPackageSources(m_packageSources + m_compressedPackageSources);
+
+    // Hand the package records parsed while fetching the metadata over to the update
+    // finder, the metadata does not need to keep them once the packages are known.
+    QHash<QString, KDUpdater::UpdatesInfo> parsedUpdatesInfo;
+    const QList<Metadata *> metadata = m_metadataJob.metadata();
+    for (Metadata *data : metadata) {
+        const KDUpdater::UpdatesInfo updatesInfo = data->updatesInfo();
+        if (updatesInfo.error() != KDUpdater::UpdatesInfo::NotYetReadError)
+            parsedUpdatesInfo.insert(data->path() + QLatin1String("/Updates.xml"), updatesInfo);
+        data->setUpdatesInfo(KDUpdater::UpdatesInfo());
+    }
+    m_updateFinder->setParsedUpdatesInfo(parsedUpdatesInfo);
+    parsedUpdatesInfo.clear();
     m_updateFinder->setLocalPackageHub(m_localPackageHub);
     m_updateFinder->run();
 
@@ -3012,6 +3234,7 @@ bool PackageManagerCorePrivate::fetchMetaInformationFromRepositories(DownloadTyp
     m_updateSourcesAdded = false;
 
     try {
+        PhaseTracer::Scope trace("Fetch metadata");
         m_metadataJob.addDownloadType(type);
         m_metadataJob.start();
         m_metadataJob.waitForFinished();
@@ -3111,6 +3334,8 @@ void PackageManagerCorePrivate::storeCheckState()
 
 void PackageManagerCorePrivate::updateComponentInstallActions()
 {
+    // The install plan sums up sizes based on the install actions
+    clearInstallPlan();
     for (Component *component : m_core->components(PackageManagerCore::ComponentType::All)) {
         component->setInstallAction(component->isInstalled()
               ? ComponentModelHelper::KeepInstalled
@@ -3267,19 +3492,18 @@ OperationList PackageManagerCorePrivate::sortOperationsBasedOnComponentDependenc
             componentOperationHash[componentName].append(operation);
     }
 
-    Graph<QString> componentGraph;  // create the complete component graph
-    foreach (const Component* node, m_core->components(PackageManagerCore::ComponentType::All)) {
-        componentGraph.addNode(node->name());
-        componentGraph.addEdges(node->name(), m_core->parseNames(node->dependencies()));
-    }
+    // the complete component graph is only rebuilt if the components changed
+    const QList<Component *> components = m_core->components(PackageManagerCore::ComponentType::All);
+    if (!m_componentDependencyGraph.isUpToDate(components))
+        m_componentDependencyGraph.build(components);
 
-    const QStringList resolvedComponents = componentGraph.sort();
-    if (componentGraph.hasCycle()) {
-        throw Error(tr("Dependency cycle between components \"%1\" and \"%2\" detected.")
-            .arg(componentGraph.cycle().first, componentGraph.cycle().second));
+    const QStringList resolvedComponents = m_componentDependencyGraph.sortedNames();
+    sortedOperations.reserve(operationList.count());
+    foreach (const QString &componentName, resolvedComponents) {
+        const auto it = componentOperationHash.constFind(componentName);
+        if (it != componentOperationHash.constEnd())
+            sortedOperations.append(it.value());
     }
-    foreach (const QString &componentName, resolvedComponents)
-        sortedOperations.append(componentOperationHash.value(componentName));
 
     return sortedOperations;
 }
@@ -3338,6 +3562,8 @@ void PackageManagerCorePrivate::processFilesForDelayedDeletion()
 
 bool PackageManagerCorePrivate::calculateComponentsAndRun()
 {
+    if (!m_core->fetchComponentsToInstallMetaData())
+        return false;
     bool componentsOk = m_core->recalculateAllComponents();
 
     if (statusCanceledOrFailed()) {
@@ -3352,6 +3578,11 @@ bool PackageManagerCorePrivate::calculateComponentsAndRun()
         qCDebug(QInstaller::lcInstallerInstallLog).noquote()
             << htmlToString(m_core->componentResolveReasons());
 
+        const InstallPlan *plan = installPlan();
+        qCDebug(QInstaller::lcInstallerInstallLog).nospace() << "Install plan: "
+            << plan->components().size() << " components, " << plan->archivesToDownload().size()
+            << " archives to download (" << humanReadableSize(plan->downloadSize()) << ").";
+
         const bool spaceOk = m_core->checkAvailableSpace();
         qCDebug(QInstaller::lcInstallerInstallLog) << m_core->availableSpaceMessage();
 
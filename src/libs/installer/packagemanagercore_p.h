@@ -29,6 +29,8 @@
 #ifndef PACKAGEMANAGERCORE_P_H
 #define PACKAGEMANAGERCORE_P_H
 
+#include "archivecache.h"
+#include "componentdependencygraph.h"
 #include "metadatajob.h"
 #include "packagemanagercore.h"
 #include "packagemanagercoredata.h"
@@ -60,6 +62,7 @@ class ScriptEngine;
 class ComponentModel;
 class ComponentAlias;
 class InstallerCalculator;
+class InstallPlan;
 class UninstallerCalculator;
 class RemoteFileEngineHandler;
 class ComponentSortFilterProxyModel;
@@ -114,11 +117,15 @@ public:
 
     template <typename T>
     bool loadComponentScripts(const T &components, const bool postScript = false);
+    bool loadDeferredMetaData(const QList<Component *> &components);
+    void prefetchDeferredMetaData(const QList<Component *> &components);
 
     void cleanUpComponentEnvironment();
     ScriptEngine *componentScriptEngine() const;
     ScriptEngine *controlScriptEngine() const;
 
+    const KDUpdater::VersionRequirement *versionRequirement(const QString &requirement);
+
     void clearAllComponentLists();
     void clearUpdaterComponentLists();
     QList<Component*> &replacementDependencyComponents();
@@ -128,6 +135,9 @@ public:
     void clearInstallerCalculator();
     InstallerCalculator *installerCalculator() const;
 
+    void clearInstallPlan();
+    const InstallPlan *installPlan() const;
+
     void clearUninstallerCalculator();
     UninstallerCalculator *uninstallerCalculator() const;
 
@@ -298,6 +308,8 @@ private:
 private:
     PackageManagerCore *m_core;
     MetadataJob m_metadataJob;
+    ArchiveCache m_archiveCache;
+    ComponentDependencyGraph m_componentDependencyGraph;
     TempPathDeleter m_tmpPathDeleter;
 
     bool m_updates;
@@ -318,6 +330,7 @@ private:
     QHash<QString, QPair<Component::UnstableError, QString>> m_pendingUnstableComponents;
 
     InstallerCalculator *m_installerCalculator;
+    InstallPlan *m_installPlan;
     UninstallerCalculator *m_uninstallerCalculator;
 
     PackageManagerProxyFactory *m_proxyFactory;
@@ -335,6 +348,7 @@ private:
     AutoDependencyHash m_autoDependencyComponentHash;
     LocalDependencyHash m_localDependencyComponentHash;
     QHash<QString, Component *> m_componentByNameHash;
+    QHash<QString, KDUpdater::VersionRequirement> m_versionRequirements;
 
     QStringList m_localVirtualComponents;
 
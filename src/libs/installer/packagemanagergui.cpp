@@ -38,6 +38,7 @@
 #include "settings.h"
 #include "utils.h"
 #include "scriptengine.h"
+#include "scriptprofiler.h"
 #include "productkeycheck.h"
 #include "repositorycategory.h"
 #include "componentselectionpage_p.h"
@@ -739,6 +740,7 @@ void PackageManagerGui::setValidatorForCustomPageRequested(Component *component,
 */
 void PackageManagerGui::loadControlScript(const QString &scriptPath)
 {
+    ScriptProfiler::Scope profile(QLatin1String("Controller"), QLatin1String("<load script>"));
     d->m_controlScriptContext = m_core->controlScriptEngine()->loadInContext(
         QLatin1String("Controller"), scriptPath);
     qCDebug(QInstaller::lcInstallerInstallLog) << "Loaded control script" << scriptPath;
@@ -752,9 +754,11 @@ void PackageManagerGui::callControlScriptMethod(const QString &methodName)
     if (d->m_controlScriptContext.isUndefined())
         return;
     try {
+        ScriptProfiler::Scope profile(QLatin1String("Controller"), methodName);
         const QJSValue returnValue = m_core->controlScriptEngine()->callScriptMethod(
             d->m_controlScriptContext, methodName);
         if (returnValue.isUndefined()) {
+            profile.discard();
             qCDebug(QInstaller::lcDeveloperBuild) << "Control script callback" << methodName
                 << "does not exist.";
             return;
@@ -2275,12 +2279,15 @@ void ComponentSelectionPage::showEvent(QShowEvent *event)
 
 /*!
     Called when \c ComponentSelectionPage is validated.
-    Tries to load \c component scripts for components about to be installed.
+    Fetches the meta data of components about to be installed if it is fetched on demand,
+    and tries to load \c component scripts for them.
     Returns \c true if the script loading succeeded and the next page is shown.
 */
 bool ComponentSelectionPage::validatePage()
 {
     PackageManagerCore *core = packageManagerCore();
+    if (!core->fetchComponentsToInstallMetaData())
+        return false;
     try {
         core->loadComponentScripts(core->orderedComponentsToInstall(), true);
     } catch (const Error &error) {
@@ -43,7 +43,7 @@
 #include <QVBoxLayout>
 #include <QImageReader>
 #include <QScrollArea>
-#include <QTextEdit>
+#include <QPlainTextEdit>
 #include <QFileInfo>
 
 #include <QtCore/QTimer>
@@ -57,6 +57,9 @@
 
 using namespace QInstaller;
 
+static const int scDetailsFlushInterval = 100; // milliseconds
+static const int scMaximumDetailLines = 10000;
+
 // -- PerformInstallationForm
 
 /*!
@@ -72,6 +75,10 @@ using namespace QInstaller;
      about the progress in an \e {details browser}. The text on the button
      changes depending on whether the details browser is currently shown or
      hidden.
+
+     Detail lines are collected into a bounded buffer and flushed to the
+     details browser in batches, at most every 100 milliseconds. The details
+     browser keeps only the most recent 10000 lines.
 */
 
 /*!
@@ -95,6 +102,7 @@ PerformInstallationForm::PerformInstallationForm(PackageManagerCore *core, QObje
     , m_detailsButton(nullptr)
     , m_detailsBrowser(nullptr)
     , m_updateTimer(nullptr)
+    , m_detailsFlushTimer(nullptr)
     , m_core(core)
 {
 #ifdef Q_OS_WIN
@@ -163,9 +171,11 @@ void PerformInstallationForm::setupUi(QWidget *widget)
     m_productImagesScrollArea->setWidget(m_productImagesLabel);
     bottomLayout->addWidget(m_productImagesScrollArea);
 
-    m_detailsBrowser = new QTextEdit(widget);
+    m_detailsBrowser = new QPlainTextEdit(widget);
     m_detailsBrowser->setReadOnly(true);
     m_detailsBrowser->setWordWrapMode(QTextOption::NoWrap);
+    m_detailsBrowser->setMaximumBlockCount(scMaximumDetailLines);
+    m_detailsBrowser->setUndoRedoEnabled(false);
     m_detailsBrowser->setObjectName(QLatin1String("DetailsBrowser"));
     m_detailsBrowser->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
     bottomLayout->addWidget(m_detailsBrowser);
@@ -180,6 +190,12 @@ void PerformInstallationForm::setupUi(QWidget *widget)
             this, &PerformInstallationForm::updateProgress); //updateProgress includes label
     m_updateTimer->setInterval(30);
 
+    m_detailsFlushTimer = new QTimer(widget);
+    m_detailsFlushTimer->setSingleShot(true);
+    m_detailsFlushTimer->setInterval(scDetailsFlushInterval);
+    connect(m_detailsFlushTimer, &QTimer::timeout,
+            this, &PerformInstallationForm::flushProgressDetails);
+
     m_progressBar->setRange(0, 100);
 }
 
@@ -193,11 +209,31 @@ void PerformInstallationForm::setDetailsWidgetVisible(bool visible)
 
 /*!
     Displays \a details about progress of the installation in the details
-    browser.
+    browser. The text is buffered and shown with the next batch of details.
 */
 void PerformInstallationForm::appendProgressDetails(const QString &details)
 {
-    m_detailsBrowser->append(details);
+    m_pendingDetails.append(details);
+    // The browser drops the oldest lines anyway, so never buffer more than it can show.
+    if (m_pendingDetails.size() > scMaximumDetailLines)
+        m_pendingDetails.erase(m_pendingDetails.begin(),
+            m_pendingDetails.begin() + (m_pendingDetails.size() - scMaximumDetailLines));
+
+    if (m_detailsBrowser->isVisible() && !m_detailsFlushTimer->isActive())
+        m_detailsFlushTimer->start();
+}
+
+/*!
+    Appends all buffered progress details to the details browser at once.
+*/
+void PerformInstallationForm::flushProgressDetails()
+{
+    m_detailsFlushTimer->stop();
+    if (m_pendingDetails.isEmpty())
+        return;
+
+    m_detailsBrowser->appendPlainText(m_pendingDetails.join(QLatin1Char('\n')));
+    m_pendingDetails.clear();
 }
 
 /*!
@@ -237,6 +273,8 @@ void PerformInstallationForm::toggleDetails()
     m_detailsButton->setText(willShow ? tr("&Hide Details") : tr("&Show Details"));
     m_detailsBrowser->setVisible(willShow);
     m_productImagesScrollArea->setVisible(!willShow);
+    if (willShow)
+        flushProgressDetails();
     emit showDetailsChanged();
 }
 
@@ -245,6 +283,8 @@ void PerformInstallationForm::toggleDetails()
 */
 void PerformInstallationForm::clearDetailsBrowser()
 {
+    m_detailsFlushTimer->stop();
+    m_pendingDetails.clear();
     m_detailsBrowser->clear();
 }
 
@@ -276,6 +316,7 @@ void PerformInstallationForm::stopUpdateProgress()
 {
     m_updateTimer->stop();
     updateProgress();
+    flushProgressDetails();
 }
 
 /*!
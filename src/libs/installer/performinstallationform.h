@@ -30,6 +30,7 @@
 #define PERFORMINSTALLATIONFORM_H
 
 #include <QObject>
+#include <QStringList>
 
 QT_BEGIN_NAMESPACE
 class QLabel;
@@ -39,7 +40,7 @@ class QTimer;
 class QWidget;
 class QWinTaskbarButton;
 class QScrollArea;
-class QTextEdit;
+class QPlainTextEdit;
 QT_END_NAMESPACE
 
 
@@ -74,6 +75,9 @@ public slots:
     void onAdditionalProgressStatusChanged(const QString &status);
     void setImageFromFileName(const QString &fileName, const QString &url);
 
+private slots:
+    void flushProgressDetails();
+
 private:
     QProgressBar *m_progressBar;
     QLabel *m_progressLabel;
@@ -81,8 +85,10 @@ private:
     QScrollArea *m_productImagesScrollArea;
     AspectRatioLabel *m_productImagesLabel;
     QPushButton *m_detailsButton;
-    QTextEdit *m_detailsBrowser;
+    QPlainTextEdit *m_detailsBrowser;
     QTimer *m_updateTimer;
+    QTimer *m_detailsFlushTimer;
+    QStringList m_pendingDetails;
     PackageManagerCore *m_core;
 
 #ifdef Q_OS_WIN
@@ -0,0 +1,241 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "phasetracer.h"
+
+#include "fileio.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+namespace QInstaller {
+
+/*!
+    \class QInstaller::PhaseTracer
+    \inmodule QtInstallerFramework
+    \brief The PhaseTracer class records how long the major phases of an installation take.
+
+    The phases are marked with Scope objects, for example reading the binary content,
+    fetching the metadata, building the component tree, downloading and unpacking the
+    archives, and writing the maintenance tool. Other measurements, like the calls of
+    script functions recorded by ScriptProfiler, are added to the same trace in their own
+    category, so that all spans share one clock.
+
+    The tracer is disabled by default, in which case a Scope only checks a flag. When a
+    category is enabled, every span of it is recorded together with the thread it ran in,
+    and writeTrace() writes the recorded spans in the Chrome trace event format.
+*/
+
+/*!
+    \enum QInstaller::PhaseTracer::Category
+
+    This enum specifies the category of a recorded span:
+
+    \value Phase
+           A major phase of the installation, recorded with a Scope.
+    \value Script
+           A call of a component or control script function.
+*/
+
+/*!
+    \class QInstaller::PhaseTracer::Scope
+    \inmodule QtInstallerFramework
+    \brief The Scope class records a phase from its construction until it is destroyed.
+*/
+
+/*!
+    Starts recording the phase \a name, if the tracer is enabled. The \a detail is added to
+    the recorded span, for example the name of the component the phase belongs to. The
+    \a name must point to a string with static storage duration.
+*/
+PhaseTracer::Scope::Scope(const char *name, const QString &detail)
+    : m_name(name)
+    , m_start(0)
+    , m_active(PhaseTracer::instance().isEnabled(Phase))
+{
+    if (!m_active)
+        return;
+    m_detail = detail;
+    m_start = PhaseTracer::instance().elapsed();
+}
+
+/*!
+    Adds the recorded phase to the tracer.
+*/
+PhaseTracer::Scope::~Scope()
+{
+    if (!m_active)
+        return;
+    PhaseTracer &tracer = PhaseTracer::instance();
+    tracer.addSpan(Phase, QLatin1String(m_name), m_detail, m_start, tracer.elapsed() - m_start);
+}
+
+PhaseTracer::PhaseTracer()
+    : m_categories(0)
+{
+    m_clock.start();
+}
+
+/*!
+    Returns the instance of the tracer.
+*/
+PhaseTracer &PhaseTracer::instance()
+{
+    static PhaseTracer instance;
+    return instance;
+}
+
+/*!
+    \fn QInstaller::PhaseTracer::isEnabled(Category category) const
+
+    Returns \c true if spans of \a category are recorded.
+*/
+
+/*!
+    Sets whether spans of \a category are recorded to \a enabled.
+*/
+void PhaseTracer::setEnabled(bool enabled, Category category)
+{
+    if (enabled)
+        m_categories.fetchAndOrRelaxed(category);
+    else
+        m_categories.fetchAndAndRelaxed(~int(category));
+}
+
+/*!
+    Returns the time in nanoseconds since the tracer was created.
+*/
+qint64 PhaseTracer::elapsed() const
+{
+    return m_clock.nsecsElapsed();
+}
+
+/*!
+    Adds the span \a name of \a category with \a detail that started at \a start and took
+    \a duration nanoseconds in the calling thread. The \a start is a time returned by
+    elapsed(). This function is thread-safe.
+*/
+void PhaseTracer::addSpan(Category category, const QString &name, const QString &detail,
+    qint64 start, qint64 duration)
+{
+    QThread *const thread = QThread::currentThread();
+    const Qt::HANDLE handle = QThread::currentThreadId();
+
+    QMutexLocker _(&m_mutex);
+    int index = m_threadIndexes.value(handle, -1);
+    if (index < 0) {
+        index = m_threadNames.count();
+        m_threadIndexes.insert(handle, index);
+        QString threadName = thread->objectName();
+        if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+            threadName = QLatin1String("Main thread");
+        else if (threadName.isEmpty())
+            threadName = QLatin1String("Thread");
+        m_threadNames.append(QString::fromLatin1("%1 (%2)").arg(threadName).arg(index));
+    }
+    m_spans.append({ category, name, detail, start, duration, index });
+}
+
+/*!
+    Returns the number of recorded spans.
+*/
+int PhaseTracer::spanCount() const
+{
+    QMutexLocker _(&m_mutex);
+    return m_spans.count();
+}
+
+/*!
+    Removes all recorded spans.
+*/
+void PhaseTracer::clear()
+{
+    QMutexLocker _(&m_mutex);
+    m_spans.clear();
+    m_threadIndexes.clear();
+    m_threadNames.clear();
+}
+
+/*!
+    Writes the recorded spans in the Chrome trace event format to \a fileName. Every thread
+    that recorded a span gets its own track. The values of \a extra are added to the top
+    level object of the trace. Throws Error on failure.
+*/
+void PhaseTracer::writeTrace(const QString &fileName, const QJsonObject &extra) const
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray traceEvents;
+    {
+        QMutexLocker _(&m_mutex);
+        for (int i = 0; i < m_threadNames.count(); ++i) {
+            QJsonObject args;
+            args.insert(QLatin1String("name"), m_threadNames.at(i));
+
+            QJsonObject traceEvent;
+            traceEvent.insert(QLatin1String("name"), QLatin1String("thread_name"));
+            traceEvent.insert(QLatin1String("ph"), QLatin1String("M"));
+            traceEvent.insert(QLatin1String("pid"), pid);
+            traceEvent.insert(QLatin1String("tid"), i);
+            traceEvent.insert(QLatin1String("args"), args);
+            traceEvents.append(traceEvent);
+        }
+
+        for (const Span &span : m_spans) {
+            QJsonObject traceEvent;
+            traceEvent.insert(QLatin1String("name"), span.name);
+            traceEvent.insert(QLatin1String("cat"), span.category == Script
+                ? QLatin1String("script") : QLatin1String("phase"));
+            traceEvent.insert(QLatin1String("ph"), QLatin1String("X"));
+            traceEvent.insert(QLatin1String("ts"), double(span.start) / 1000.0);
+            traceEvent.insert(QLatin1String("dur"), double(span.duration) / 1000.0);
+            traceEvent.insert(QLatin1String("pid"), pid);
+            traceEvent.insert(QLatin1String("tid"), span.thread);
+            if (!span.detail.isEmpty()) {
+                QJsonObject args;
+                args.insert(QLatin1String("detail"), span.detail);
+                traceEvent.insert(QLatin1String("args"), args);
+            }
+            traceEvents.append(traceEvent);
+        }
+    }
+
+    QJsonObject root = extra;
+    root.insert(QLatin1String("traceEvents"), traceEvents);
+    root.insert(QLatin1String("displayTimeUnit"), QLatin1String("ms"));
+
+    QFile file(fileName);
+    QInstaller::openForWrite(&file);
+    QInstaller::blockingWrite(&file, QJsonDocument(root).toJson(QJsonDocument::Compact));
+}
+
+} // namespace QInstaller
@@ -0,0 +1,112 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#ifndef PHASETRACER_H
+#define PHASETRACER_H
+
+#include "installer_global.h"
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+namespace QInstaller {
+
+class INSTALLER_EXPORT PhaseTracer
+{
+    Q_DISABLE_COPY(PhaseTracer)
+
+public:
+    enum Category {
+        Phase = 0x1,
+        Script = 0x2
+    };
+
+    class INSTALLER_EXPORT Scope
+    {
+        Q_DISABLE_COPY(Scope)
+
+    public:
+        explicit Scope(const char *name, const QString &detail = QString());
+        ~Scope();
+
+    private:
+        const char *m_name;
+        QString m_detail;
+        qint64 m_start;
+        bool m_active;
+    };
+
+    static PhaseTracer &instance();
+
+    bool isEnabled(Category category = Phase) const
+    {
+        return (m_categories.loadRelaxed() & category) != 0;
+    }
+    void setEnabled(bool enabled, Category category = Phase);
+
+    qint64 elapsed() const;
+    void addSpan(Category category, const QString &name, const QString &detail, qint64 start,
+        qint64 duration);
+
+    int spanCount() const;
+    void clear();
+
+    void writeTrace(const QString &fileName, const QJsonObject &extra = QJsonObject()) const;
+
+private:
+    PhaseTracer();
+
+    struct Span
+    {
+        Category category;
+        QString name;
+        QString detail;
+        qint64 start;
+        qint64 duration;
+        int thread;
+    };
+
+private:
+    QAtomicInt m_categories;
+    QElapsedTimer m_clock;
+
+    mutable QMutex m_mutex;
+    QList<Span> m_spans;
+    QHash<Qt::HANDLE, int> m_threadIndexes;
+    QStringList m_threadNames;
+};
+
+} // namespace QInstaller
+
+#endif // PHASETRACER_H
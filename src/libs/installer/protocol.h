@@ -56,6 +56,7 @@ const char Create[] = "Create";
 const char Shutdown[] = "Shutdown";
 const char Authorize[] = "Authorize";
 const char Reply[] = "Reply";
+const char Signals[] = "Signals";
 
 // QProcessWrapper
 const char QProcess[] = "QProcess";
@@ -86,7 +87,6 @@ const char QProcessProcessChannelMode[] = "QProcess::processChannelMode";
 const char QProcessSetProcessChannelMode[] = "QProcess::setProcessChannelMode";
 const char QProcessSetNativeArguments[] = "QProcess::setNativeArguments";
 
-const char GetQProcessSignals[] = "GetQProcessSignals";
 const char QProcessSignalBytesWritten[] = "QProcess::bytesWritten";
 const char QProcessSignalAboutToClose[] = "QProcess::aboutToClose";
 const char QProcessSignalReadChannelFinished[] = "QProcess::readChannelFinished";
@@ -182,7 +182,6 @@ const char AbstractArchiveSetFilePosition[] = "AbstractArchive::setFilePosition"
 const char AbstractArchiveWorkerStatus[] = "AbstractArchive::workerStatus";
 const char AbstractArchiveCancel[] = "AbstractArchive::cancel";
 
-const char GetAbstractArchiveSignals[] = "GetAbstractArchiveSignals";
 const char AbstractArchiveSignalCurrentEntryChanged[] = "AbstractArchive::currentEntryChanged";
 const char AbstractArchiveSignalCompletedChanged[] = "AbstractArchive::completedChanged";
 const char AbstractArchiveSignalDataBlockRequested[] = "AbstractArchive::dataBlockRequested";
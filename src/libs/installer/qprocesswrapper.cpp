@@ -49,8 +49,6 @@ QProcessWrapper::QProcessWrapper(QObject *parent)
     qRegisterMetaType<QProcess::ProcessError>();
     qRegisterMetaType<QProcess::ProcessState>();
 
-    m_timer.start(250);
-    connect(&m_timer, &QTimer::timeout, this, &QProcessWrapper::processSignals);
     connect(&process, &QIODevice::bytesWritten, this, &QProcessWrapper::bytesWritten);
     connect(&process, &QIODevice::aboutToClose, this, &QProcessWrapper::aboutToClose);
     connect(&process, &QIODevice::readChannelFinished, this, &QProcessWrapper::readChannelFinished);
@@ -65,20 +63,14 @@ QProcessWrapper::QProcessWrapper(QObject *parent)
 
 QProcessWrapper::~QProcessWrapper()
 {
-    m_timer.stop();
 }
 
-void QProcessWrapper::processSignals()
+/*!
+    Emits the signals in \a signalList of the process running on the server side.
+*/
+void QProcessWrapper::processSignals(const QVariantList &signalList)
 {
-    if (!isConnectedToServer())
-        return;
-
-    if (!m_lock.tryLockForRead())
-        return;
-
-    QList<QVariant> receivedSignals =
-        callRemoteMethod<QList<QVariant> >(QString::fromLatin1(Protocol::GetQProcessSignals));
-
+    QVariantList receivedSignals = signalList;
     while (!receivedSignals.isEmpty()) {
         const QString name = receivedSignals.takeFirst().toString();
         if (name == QLatin1String(Protocol::QProcessSignalBytesWritten)) {
@@ -105,7 +97,6 @@ void QProcessWrapper::processSignals()
                 static_cast<QProcess::ExitStatus> (receivedSignals.takeFirst().toInt()));
         }
     }
-    m_lock.unlock();
 }
 
 /*!
@@ -123,7 +114,6 @@ bool QProcessWrapper::startDetached(const QString &program, const QStringList &a
                 program, arguments, workingDirectory);
         if (pid != nullptr)
             *pid = result.second;
-        w.processSignals();
         return result.first;
     }
     return QInstaller::startDetached(program, arguments, workingDirectory, pid);
@@ -181,7 +171,6 @@ bool QProcessWrapper::startDetached2(const QString &program, const QStringList &
                 program, arguments, workingDirectory);
         if (pid != nullptr)
             *pid = result.second;
-        w.processSignals();
         return result.first;
     }
     return QProcess::startDetached(program, arguments, workingDirectory, pid);
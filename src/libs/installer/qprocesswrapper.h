@@ -34,7 +34,6 @@
 #include <QIODevice>
 #include <QProcess>
 #include <QReadWriteLock>
-#include <QTimer>
 
 namespace QInstaller {
 
@@ -130,11 +129,10 @@ Q_SIGNALS:
 public Q_SLOTS:
     void cancel();
 
-private slots:
-    void processSignals();
+protected:
+    void processSignals(const QVariantList &signalList) override;
 
 private:
-    QTimer m_timer;
     QProcess process;
     mutable QReadWriteLock m_lock;
 };
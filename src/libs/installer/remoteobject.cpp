@@ -48,6 +48,7 @@ RemoteObject::RemoteObject(const QString &wrappedType, QObject *parent)
     : QObject(parent)
     , m_type(wrappedType)
     , m_socket(nullptr)
+    , m_waitingForReply(false)
 {
     Q_ASSERT_X(!m_type.isEmpty(), Q_FUNC_INFO, "The wrapped Qt type needs to be passed as "
         "argument and cannot be empty.");
@@ -89,6 +90,7 @@ bool RemoteObject::authorize()
         delete m_socket;
 
     m_socket = new QLocalSocket;
+    connect(m_socket, &QLocalSocket::readyRead, this, &RemoteObject::onReadyRead);
     m_socket->connectToServer(RemoteClient::instance().socketName());
 
     if (m_socket->waitForConnected()) {
@@ -139,4 +141,75 @@ bool RemoteObject::isConnectedToServer() const
     return false;
 }
 
+/*!
+    Called with the \a receivedSignals of the wrapped object, as pushed by the server.
+    The list contains the signal names each followed by its arguments. The default
+    implementation does nothing.
+*/
+void RemoteObject::processSignals(const QVariantList &receivedSignals)
+{
+    Q_UNUSED(receivedSignals)
+}
+
+/*!
+    \internal
+
+    Reads the signals the server pushed while no call is waiting for its reply.
+*/
+void RemoteObject::onReadyRead()
+{
+    if (m_waitingForReply)
+        return; // the pending call reads the packets
+    readSignals();
+}
+
+/*!
+    \internal
+
+    Queues the signals of the complete packets already received from the server.
+*/
+void RemoteObject::readSignals() const
+{
+    QByteArray command;
+    QByteArray data;
+    while (m_socket && receivePacket(m_socket, &command, &data)) {
+        if (command == Protocol::Signals)
+            queueSignals(data);
+        else
+            qCWarning(lcServer) << "Unexpected packet from remote server:" << command;
+    }
+}
+
+/*!
+    \internal
+
+    Emits the queued signals on the client side.
+*/
+void RemoteObject::dispatchSignals()
+{
+    while (!m_pendingSignals.isEmpty())
+        processSignals(m_pendingSignals.takeFirst());
+}
+
+/*!
+    \internal
+
+    Queues the signals serialized in \a data for emission from the event loop, so that
+    no slot runs while a remote call is still waiting for its reply.
+*/
+void RemoteObject::queueSignals(const QByteArray &data) const
+{
+    QDataStream stream(data);
+    QVariantList receivedSignals;
+    stream >> receivedSignals;
+    if (receivedSignals.isEmpty())
+        return;
+
+    if (m_pendingSignals.isEmpty()) {
+        QMetaObject::invokeMethod(const_cast<RemoteObject *>(this), &RemoteObject::dispatchSignals,
+            Qt::QueuedConnection);
+    }
+    m_pendingSignals.append(receivedSignals);
+}
+
 } // namespace QInstaller
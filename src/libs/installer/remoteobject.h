@@ -37,6 +37,7 @@
 #include <QDataStream>
 #include <QLocalSocket>
 #include <QObject>
+#include <QScopedValueRollback>
 #include <QVariant>
 
 
@@ -70,7 +71,16 @@ protected:
     bool authorize();
     bool connectToServer(const QVariantList &arguments = QVariantList());
 
+    virtual void processSignals(const QVariantList &receivedSignals);
+
+private slots:
+    void onReadyRead();
+    void dispatchSignals();
+
 private:
+    void readSignals() const;
+    void queueSignals(const QByteArray &data) const;
+
 
     template<typename T, typename... Args>
     T sendReceivePacket(const QString &name, const Args&... args) const
@@ -111,14 +121,22 @@ private:
     template<typename T>
     T readData(const QString &name) const
     {
+        QScopedValueRollback<bool> _(m_waitingForReply, true);
+
         QByteArray command;
         QByteArray data;
-        while (!receivePacket(m_socket, &command, &data)) {
-            if (!m_socket->waitForReadyRead(-1)) {
-                throw Error(tr("Cannot read all data after sending command: %1. "
-                    "Bytes expected: %2, Bytes received: %3. Error: %4").arg(name).arg(0)
-                    .arg(m_socket->bytesAvailable()).arg(m_socket->errorString()));
+        forever {
+            while (!receivePacket(m_socket, &command, &data)) {
+                if (!m_socket->waitForReadyRead(-1)) {
+                    throw Error(tr("Cannot read all data after sending command: %1. "
+                        "Bytes expected: %2, Bytes received: %3. Error: %4").arg(name).arg(0)
+                        .arg(m_socket->bytesAvailable()).arg(m_socket->errorString()));
+                }
             }
+            // signals pushed by the server before the reply are emitted later
+            if (command != Protocol::Signals)
+                break;
+            queueSignals(data);
         }
 
         Q_ASSERT(command == Protocol::Reply);
@@ -129,12 +147,19 @@ private:
         stream >> result;
         Q_ASSERT(stream.status() == QDataStream::Ok);
         Q_ASSERT(stream.atEnd());
+
+        // Signals pushed right after the reply may have been read together with it, no
+        // readyRead() follows for them.
+        if (m_socket->bytesAvailable() > 0)
+            readSignals();
         return result;
     }
 
 private:
     QString m_type;
     QLocalSocket *m_socket;
+    mutable bool m_waitingForReply;
+    mutable QList<QVariantList> m_pendingSignals;
 };
 
 } // namespace QInstaller
@@ -40,6 +40,7 @@
 
 #include <QCoreApplication>
 #include <QDataStream>
+#include <QEventLoop>
 #include <QLocalSocket>
 
 namespace QInstaller {
@@ -136,14 +137,22 @@ void RemoteServerConnection::run()
     socket.setSocketDescriptor(m_socketDescriptor);
     QScopedPointer<PermissionSettings> settings;
 
+    // Wakes up whenever a new packet arrives, the client goes away or one of the signal
+    // receivers records a signal that needs to be pushed to the client.
+    QEventLoop loop;
+    connect(&socket, &QLocalSocket::readyRead, &loop, &QEventLoop::quit);
+    connect(&socket, &QLocalSocket::disconnected, &loop, &QEventLoop::quit);
+
     bool authorized = false;
     while (socket.state() == QLocalSocket::ConnectedState) {
         QByteArray cmd;
         QByteArray data;
 
+        if (authorized)
+            sendPendingSignals(&socket);
+
         if (!receivePacket(&socket, &cmd, &data)) {
-            socket.waitForReadyRead(250);
-            qApp->processEvents();
+            loop.exec();
             continue;
         }
 
@@ -196,6 +205,8 @@ void RemoteServerConnection::run()
                 } else if (type == QLatin1String(Protocol::QProcess)) {
                     m_process.reset(new QProcess);
                     m_processSignalReceiver = new QProcessSignalReceiver(m_process.get());
+                    connect(m_processSignalReceiver, &QProcessSignalReceiver::signalAdded,
+                        &loop, &QEventLoop::quit);
                 } else if (type == QLatin1String(Protocol::QAbstractFileEngine)) {
                     m_engine.reset(new QFSFileEngine);
                 } else if (type == QLatin1String(Protocol::AbstractArchive)) {
@@ -203,6 +214,8 @@ void RemoteServerConnection::run()
                     m_archive.reset(new LibArchiveArchive);
                     m_archiveSignalReceiver = new AbstractArchiveSignalReceiver(
                         static_cast<LibArchiveArchive *>(m_archive.get()));
+                    connect(m_archiveSignalReceiver, &AbstractArchiveSignalReceiver::signalAdded,
+                        &loop, &QEventLoop::quit);
 #else
                     Q_ASSERT_X(false, Q_FUNC_INFO, "No compatible archive handler exists for protocol.");
 #endif
@@ -212,26 +225,6 @@ void RemoteServerConnection::run()
                 continue;
             }
 
-            if (command == QLatin1String(Protocol::GetQProcessSignals)) {
-                if (m_processSignalReceiver) {
-                    QMutexLocker _(&m_processSignalReceiver->m_lock);
-                    reply.send(m_processSignalReceiver->m_receivedSignals);
-                    m_processSignalReceiver->m_receivedSignals.clear();
-                }
-                continue;
-            } else if (command == QLatin1String(Protocol::GetAbstractArchiveSignals)) {
-#ifdef IFW_LIBARCHIVE
-                if (m_archiveSignalReceiver) {
-                    QMutexLocker _(&m_archiveSignalReceiver->m_lock);
-                    reply.send(m_archiveSignalReceiver->m_receivedSignals);
-                    m_archiveSignalReceiver->m_receivedSignals.clear();
-                }
-                continue;
-#else
-                Q_ASSERT_X(false, Q_FUNC_INFO, "No compatible archive handler exists for protocol.");
-#endif
-            }
-
             if (command.startsWith(QLatin1String(Protocol::QProcess))) {
                 handleQProcess(&reply, command, stream);
             } else if (command.startsWith(QLatin1String(Protocol::QSettings))) {
@@ -252,6 +245,31 @@ void RemoteServerConnection::run()
     }
 }
 
+/*!
+    Sends the signals recorded by the process and archive signal receivers since the last
+    call to the client connected on \a socket. Each receiver's signals are sent as a
+    separate \c Signals packet.
+*/
+void RemoteServerConnection::sendPendingSignals(QLocalSocket *socket)
+{
+    auto send = [socket](const QVariantList &receivedSignals) {
+        if (receivedSignals.isEmpty())
+            return;
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream << receivedSignals;
+        sendPacket(socket, Protocol::Signals, data);
+        socket->flush();
+    };
+
+    if (m_processSignalReceiver)
+        send(m_processSignalReceiver->takeSignals());
+#ifdef IFW_LIBARCHIVE
+    if (m_archiveSignalReceiver)
+        send(m_archiveSignalReceiver->takeSignals());
+#endif
+}
+
 void RemoteServerConnection::handleQProcess(RemoteServerReply *reply, const QString &command, QDataStream &data)
 {
     if (command == QLatin1String(Protocol::QProcessCloseWriteChannel)) {
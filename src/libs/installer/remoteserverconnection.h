@@ -83,6 +83,8 @@ private:
     void handleQFSFileEngine(RemoteServerReply *reply, const QString &command, QDataStream &data);
     void handleArchive(RemoteServerReply *reply, const QString &command, QDataStream &data);
 
+    void sendPendingSignals(QLocalSocket *socket);
+
 private:
     qintptr m_socketDescriptor;
     QString m_authorizationKey;
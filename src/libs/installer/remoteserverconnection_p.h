@@ -38,6 +38,8 @@
 #include <QProcess>
 #include <QVariant>
 
+#include <utility>
+
 namespace QInstaller {
 
 class QProcessSignalReceiver : public QObject
@@ -68,58 +70,62 @@ private:
 
 private Q_SLOTS:
     void onBytesWritten(qint64 count) {
-        QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::QProcessSignalBytesWritten));
-        m_receivedSignals.append(count);
+        addSignal({ QLatin1String(Protocol::QProcessSignalBytesWritten), count });
     }
 
     void onAboutToClose() {
-        QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::QProcessSignalAboutToClose));
+        addSignal({ QLatin1String(Protocol::QProcessSignalAboutToClose) });
     }
 
     void onReadChannelFinished() {
-        QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::QProcessSignalReadChannelFinished));
+        addSignal({ QLatin1String(Protocol::QProcessSignalReadChannelFinished) });
     }
 
     void onError(QProcess::ProcessError error) {
-        QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::QProcessSignalError));
-        m_receivedSignals.append(static_cast<int> (error));
+        addSignal({ QLatin1String(Protocol::QProcessSignalError), static_cast<int> (error) });
     }
 
     void onReadyReadStandardOutput() {
-        QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::QProcessSignalReadyReadStandardOutput));
+        addSignal({ QLatin1String(Protocol::QProcessSignalReadyReadStandardOutput) });
     }
 
     void onReadyReadStandardError() {
-        QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::QProcessSignalReadyReadStandardError));
+        addSignal({ QLatin1String(Protocol::QProcessSignalReadyReadStandardError) });
     }
 
     void onFinished(int exitCode, QProcess::ExitStatus exitStatus) {
-        QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::QProcessSignalFinished));
-        m_receivedSignals.append(exitCode);
-        m_receivedSignals.append(static_cast<int> (exitStatus));
+        addSignal({ QLatin1String(Protocol::QProcessSignalFinished), exitCode, static_cast<int> (exitStatus) });
     }
 
     void onReadyRead() {
-        QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::QProcessSignalReadyRead));
+        addSignal({ QLatin1String(Protocol::QProcessSignalReadyRead) });
     }
 
     void onStarted() {
-        QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::QProcessSignalStarted));
+        addSignal({ QLatin1String(Protocol::QProcessSignalStarted) });
     }
 
     void onStateChanged(QProcess::ProcessState newState) {
+        addSignal({ QLatin1String(Protocol::QProcessSignalStateChanged), static_cast<int>(newState) });
+    }
+
+Q_SIGNALS:
+    void signalAdded();
+
+private:
+    void addSignal(const QVariantList &signal)
+    {
+        {
+            QMutexLocker _(&m_lock);
+            m_receivedSignals.append(signal);
+        }
+        emit signalAdded();
+    }
+
+    QVariantList takeSignals()
+    {
         QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::QProcessSignalStateChanged));
-        m_receivedSignals.append(static_cast<int>(newState));
+        return std::exchange(m_receivedSignals, QVariantList());
     }
 
 private:
@@ -152,37 +158,46 @@ private:
 private Q_SLOTS:
     void onCurrentEntryChanged(const QString &filename)
     {
-        QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::AbstractArchiveSignalCurrentEntryChanged));
-        m_receivedSignals.append(filename);
+        addSignal({ QLatin1String(Protocol::AbstractArchiveSignalCurrentEntryChanged), filename });
     }
 
     void onCompletedChanged(quint64 completed, quint64 total)
     {
-        QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::AbstractArchiveSignalCompletedChanged));
-        m_receivedSignals.append(completed);
-        m_receivedSignals.append(total);
+        addSignal({ QLatin1String(Protocol::AbstractArchiveSignalCompletedChanged), completed, total });
     }
 
     void onDataBlockRequested()
     {
-        QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::AbstractArchiveSignalDataBlockRequested));
+        addSignal({ QLatin1String(Protocol::AbstractArchiveSignalDataBlockRequested) });
     }
 
     void onSeekRequested(qint64 offset, int whence)
     {
-        QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::AbstractArchiveSignalSeekRequested));
-        m_receivedSignals.append(offset);
-        m_receivedSignals.append(whence);
+        addSignal({ QLatin1String(Protocol::AbstractArchiveSignalSeekRequested), offset, whence });
     }
 
     void onWorkerFinished()
+    {
+        addSignal({ QLatin1String(Protocol::AbstractArchiveSignalWorkerFinished) });
+    }
+
+Q_SIGNALS:
+    void signalAdded();
+
+private:
+    void addSignal(const QVariantList &signal)
+    {
+        {
+            QMutexLocker _(&m_lock);
+            m_receivedSignals.append(signal);
+        }
+        emit signalAdded();
+    }
+
+    QVariantList takeSignals()
     {
         QMutexLocker _(&m_lock);
-        m_receivedSignals.append(QLatin1String(Protocol::AbstractArchiveSignalWorkerFinished));
+        return std::exchange(m_receivedSignals, QVariantList());
     }
 
 private:
@@ -40,6 +40,7 @@
 #include <QQmlEngine>
 #include <QUuid>
 #include <QWizard>
+#include <QtConcurrentMap>
 
 namespace QInstaller {
 
@@ -465,6 +466,30 @@ void ScriptEngine::removeFromGlobalObject(QObject *object)
     globalObject().deleteProperty(object->objectName());
 }
 
+static QPair<QString, QByteArray> readScriptFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return qMakePair(fileName, QByteArray());
+    return qMakePair(fileName, file.readAll());
+}
+
+/*!
+    Reads the scripts at \a fileNames in parallel and keeps their content until they are
+    loaded with loadInContext(). Scripts that cannot be read are read again, and the error is
+    reported, when they are loaded.
+*/
+void ScriptEngine::prefetchScripts(const QStringList &fileNames)
+{
+    m_prefetchedScripts.clear();
+    const QList<QPair<QString, QByteArray>> scripts
+        = QtConcurrent::blockingMapped<QList<QPair<QString, QByteArray>>>(fileNames, readScriptFile);
+    for (const QPair<QString, QByteArray> &script : scripts) {
+        if (!script.second.isNull())
+            m_prefetchedScripts.insert(script.first, script.second);
+    }
+}
+
 /*!
     Loads a script into the given \a context at \a fileName inside the ScriptEngine.
 
@@ -479,16 +504,20 @@ QJSValue ScriptEngine::loadInContext(const QString &context, const QString &file
     const QString &scriptInjection)
 {
     QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly)) {
-        throw Error(tr("Cannot open script file at %1: %2")
-            .arg(fileName, file.errorString()));
+    QByteArray content = m_prefetchedScripts.take(fileName);
+    if (content.isNull()) {
+        if (!file.open(QIODevice::ReadOnly)) {
+            throw Error(tr("Cannot open script file at %1: %2")
+                .arg(fileName, file.errorString()));
+        }
+        content = file.readAll();
     }
 
     // Create a closure. Put the content in the first line to keep line number order in case of an
     // exception. Script content will be added as the last argument to the command to prevent wrong
     // replacements of %1, %2 or %3 inside the javascript code.
     const QString scriptContent = QLatin1String("(function() {")
-        + scriptInjection + QString::fromUtf8(file.readAll())
+        + scriptInjection + QString::fromUtf8(content)
         + QString::fromLatin1("\n"
         "    if (typeof %1 != \"undefined\")"
         "        return new %1;"
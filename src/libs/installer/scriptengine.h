@@ -56,6 +56,7 @@ public:
     void addToGlobalObject(QObject *object);
     void removeFromGlobalObject(QObject *object);
 
+    void prefetchScripts(const QStringList &fileNames);
     QJSValue loadInContext(const QString &context, const QString &fileName,
         const QString &scriptInjection = QString());
     QJSValue callScriptMethod(const QJSValue &context, const QString &methodName,
@@ -76,6 +77,7 @@ private:
 private:
     QJSEngine m_engine;
     QHash<QString, QStringList> m_callstack;
+    QHash<QString, QByteArray> m_prefetchedScripts;
     GuiProxy *m_guiProxy;
     PackageManagerCore *m_core;
 };
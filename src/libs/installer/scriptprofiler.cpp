@@ -0,0 +1,204 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "scriptprofiler.h"
+
+#include "globals.h"
+#include "phasetracer.h"
+
+#include <QJsonObject>
+
+#include <algorithm>
+
+namespace QInstaller {
+
+/*!
+    \class QInstaller::ScriptProfiler
+    \inmodule QtInstallerFramework
+    \brief The ScriptProfiler class measures the time spent in component and control scripts.
+
+    When enabled, the profiler counts the calls of every script function per component and
+    sums up the time they take. Calls taking longer than threshold() are logged as warnings.
+    If the PhaseTracer::Script category of the PhaseTracer is enabled, every single call is
+    also recorded there, so that it shows up in the trace next to the installation phases.
+*/
+
+/*!
+    \class QInstaller::ScriptProfiler::Scope
+    \inmodule QtInstallerFramework
+    \brief The Scope class measures the time spent in a script function until it is destroyed.
+*/
+
+/*!
+    Starts measuring the \a function of the script that belongs to \a owner, if the profiler
+    is enabled.
+*/
+ScriptProfiler::Scope::Scope(const QString &owner, const QString &function)
+    : m_start(0)
+    , m_active(ScriptProfiler::instance().isEnabled())
+{
+    if (!m_active)
+        return;
+    m_owner = owner;
+    m_function = function;
+    m_start = PhaseTracer::instance().elapsed();
+}
+
+/*!
+    Adds the measured time to the profiler.
+*/
+ScriptProfiler::Scope::~Scope()
+{
+    if (!m_active)
+        return;
+    ScriptProfiler::instance().addEvent(m_owner, m_function, m_start,
+        PhaseTracer::instance().elapsed() - m_start);
+}
+
+/*!
+    Drops the measurement, for example because the script does not implement the function.
+*/
+void ScriptProfiler::Scope::discard()
+{
+    m_active = false;
+}
+
+ScriptProfiler::ScriptProfiler()
+    : m_threshold(0)
+{
+}
+
+/*!
+    Returns the instance of the profiler.
+*/
+ScriptProfiler &ScriptProfiler::instance()
+{
+    static ScriptProfiler instance;
+    return instance;
+}
+
+/*!
+    Returns \c true if script functions are measured. This is the case if script calls are
+    traced or a threshold is set.
+*/
+bool ScriptProfiler::isEnabled() const
+{
+    return m_threshold > 0 || PhaseTracer::instance().isEnabled(PhaseTracer::Script);
+}
+
+/*!
+    Sets the time in milliseconds after which a single call is logged as slow to \a msecs.
+    A value of \c 0 disables the warning.
+*/
+void ScriptProfiler::setThreshold(qint64 msecs)
+{
+    m_threshold = qMax(qint64(0), msecs);
+}
+
+/*!
+    Returns the time in milliseconds after which a single call is logged as slow.
+*/
+qint64 ScriptProfiler::threshold() const
+{
+    return m_threshold;
+}
+
+/*!
+    Adds a call of \a function of the script belonging to \a owner that started at \a start
+    and took \a duration nanoseconds. The \a start is a time returned by PhaseTracer::elapsed().
+*/
+void ScriptProfiler::addEvent(const QString &owner, const QString &function, qint64 start,
+    qint64 duration)
+{
+    const QPair<QString, QString> key = qMakePair(owner, function);
+    int index = m_entryIndexes.value(key, -1);
+    if (index < 0) {
+        index = m_entries.count();
+        m_entryIndexes.insert(key, index);
+        Entry entry;
+        entry.owner = owner;
+        entry.function = function;
+        m_entries.append(entry);
+    }
+
+    Entry &entry = m_entries[index];
+    ++entry.calls;
+    entry.totalTime += duration;
+    entry.maxTime = qMax(entry.maxTime, duration);
+
+    PhaseTracer &tracer = PhaseTracer::instance();
+    if (tracer.isEnabled(PhaseTracer::Script))
+        tracer.addSpan(PhaseTracer::Script, function, owner, start, duration);
+
+    if (m_threshold > 0 && duration > m_threshold * 1000000) {
+        qCWarning(QInstaller::lcInstallerInstallLog).nospace() << "Script function \""
+            << function << "\" of \"" << owner << "\" took " << duration / 1000000 << " ms.";
+    }
+}
+
+/*!
+    Returns the measured script functions, sorted by the total time spent in them.
+*/
+QList<ScriptProfiler::Entry> ScriptProfiler::entries() const
+{
+    QList<Entry> entries = m_entries;
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs) {
+        return lhs.totalTime > rhs.totalTime;
+    });
+    return entries;
+}
+
+/*!
+    Returns the calls and the time spent per component and function as returned by
+    entries(), to be added to a trace written with PhaseTracer::writeTrace().
+*/
+QJsonArray ScriptProfiler::summary() const
+{
+    QJsonArray summary;
+    foreach (const Entry &entry, entries()) {
+        QJsonObject object;
+        object.insert(QLatin1String("component"), entry.owner);
+        object.insert(QLatin1String("function"), entry.function);
+        object.insert(QLatin1String("calls"), entry.calls);
+        object.insert(QLatin1String("totalMs"), double(entry.totalTime) / 1000000.0);
+        object.insert(QLatin1String("maxMs"), double(entry.maxTime) / 1000000.0);
+        summary.append(object);
+    }
+    return summary;
+}
+
+/*!
+    Removes all measurements.
+*/
+void ScriptProfiler::clear()
+{
+    m_entryIndexes.clear();
+    m_entries.clear();
+}
+
+} // namespace QInstaller
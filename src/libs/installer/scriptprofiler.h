@@ -0,0 +1,97 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#ifndef SCRIPTPROFILER_H
+#define SCRIPTPROFILER_H
+
+#include "installer_global.h"
+
+#include <QHash>
+#include <QJsonArray>
+#include <QList>
+#include <QPair>
+#include <QString>
+
+namespace QInstaller {
+
+class INSTALLER_EXPORT ScriptProfiler
+{
+    Q_DISABLE_COPY(ScriptProfiler)
+
+public:
+    struct Entry
+    {
+        QString owner;
+        QString function;
+        qint64 calls = 0;
+        qint64 totalTime = 0;   // nanoseconds
+        qint64 maxTime = 0;     // nanoseconds
+    };
+
+    class INSTALLER_EXPORT Scope
+    {
+        Q_DISABLE_COPY(Scope)
+
+    public:
+        Scope(const QString &owner, const QString &function);
+        ~Scope();
+
+        void discard();
+
+    private:
+        QString m_owner;
+        QString m_function;
+        qint64 m_start;
+        bool m_active;
+    };
+
+    static ScriptProfiler &instance();
+
+    bool isEnabled() const;
+    void setThreshold(qint64 msecs);
+    qint64 threshold() const;
+
+    void addEvent(const QString &owner, const QString &function, qint64 start, qint64 duration);
+
+    QList<Entry> entries() const;
+    QJsonArray summary() const;
+    void clear();
+
+private:
+    ScriptProfiler();
+
+private:
+    qint64 m_threshold;
+
+    QHash<QPair<QString, QString>, int> m_entryIndexes;
+    QList<Entry> m_entries;
+};
+
+} // namespace QInstaller
+
+#endif // SCRIPTPROFILER_H
@@ -331,7 +331,9 @@ Settings Settings::fromFileAndPrefix(const QString &path, const QString &prefix,
                 << scRepositorySettingsPageVisible << scTargetConfigurationFile
                 << scRemoteRepositories << scTranslations << scUrlQueryString << QLatin1String(scControlScript)
                 << scCreateLocalRepository << scInstallActionColumnVisible << scSupportsModify << scAllowUnstableComponents
-                << scSaveDefaultRepositories << scRepositoryCategories;
+                << scSaveDefaultRepositories << scRepositoryCategories
+                << scAllowHttp2 << scMaxConnectionsPerHost << scArchiveCacheSize << scFetchMetadataOnDemand
+                << scPackMetadataInCache;
 
     Settings s;
     s.d->m_data.replace(scPrefix, prefix);
@@ -1000,6 +1002,45 @@ void Settings::setSaveDefaultRepositories(bool save)
     d->m_data.replace(scSaveDefaultRepositories, save);
 }
 
+bool Settings::allowHttp2() const
+{
+    return d->m_data.value(scAllowHttp2, false).toBool();
+}
+
+int Settings::maxConnectionsPerHost() const
+{
+    bool ok = false;
+    const int connections = d->m_data.value(scMaxConnectionsPerHost).toInt(&ok);
+    return (ok && connections > 0) ? connections : 6;
+}
+
+qint64 Settings::archiveCacheSize() const
+{
+    bool ok = false;
+    const qint64 megabytes = d->m_data.value(scArchiveCacheSize).toLongLong(&ok);
+    return (ok && megabytes > 0) ? megabytes * 1024 * 1024 : 0;
+}
+
+bool Settings::fetchMetadataOnDemand() const
+{
+    return d->m_data.value(scFetchMetadataOnDemand, false).toBool();
+}
+
+void Settings::setFetchMetadataOnDemand(bool enable)
+{
+    d->m_data.replace(scFetchMetadataOnDemand, enable);
+}
+
+bool Settings::packMetadataInCache() const
+{
+    return d->m_data.value(scPackMetadataInCache, false).toBool();
+}
+
+void Settings::setPackMetadataInCache(bool enable)
+{
+    d->m_data.replace(scPackMetadataInCache, enable);
+}
+
 QString Settings::repositoryCategoryDisplayName() const
 {
     QString displayName = d->m_data.value(QLatin1String(scRepositoryCategoryDisplayName)).toString();
@@ -188,6 +188,16 @@ public:
     bool saveDefaultRepositories() const;
     void setSaveDefaultRepositories(bool save);
 
+    bool allowHttp2() const;
+    int maxConnectionsPerHost() const;
+    qint64 archiveCacheSize() const;
+
+    bool fetchMetadataOnDemand() const;
+    void setFetchMetadataOnDemand(bool enable);
+
+    bool packMetadataInCache() const;
+    void setPackMetadataInCache(bool enable);
+
     QString repositoryCategoryDisplayName() const;
     void setRepositoryCategoryDisplayName(const QString &displayName);
 
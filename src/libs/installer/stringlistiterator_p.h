@@ -0,0 +1,92 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#ifndef STRINGLISTITERATOR_P_H
+#define STRINGLISTITERATOR_P_H
+
+#include <QtCore/private/qabstractfileengine_p.h>
+
+namespace QInstaller {
+
+class StringListIterator : public QAbstractFileEngineIterator
+{
+public:
+    StringListIterator(const QString &path, const QStringList &list, QDir::Filters filters, const QStringList &nameFilters)
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+        : QAbstractFileEngineIterator(path, filters, nameFilters)
+#else
+        : QAbstractFileEngineIterator(filters, nameFilters)
+#endif
+        , list(list)
+        , index(-1)
+    {
+    }
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+    StringListIterator(const QString &path, const QStringList &list, QDirListing::IteratorFlags filters, const QStringList &nameFilters)
+
+        : QAbstractFileEngineIterator(path, filters, nameFilters)
+        , list(list)
+        , index(-1)
+    {
+    }
+
+    bool advance() override
+    {
+        if (index < list.size() - 1) {
+            ++index;
+            return true;
+        }
+        return false;
+    }
+#else
+    bool hasNext() const override
+    {
+        return index < list.size() - 1;
+    }
+
+    QString next() override
+    {
+        if(!hasNext())
+            return QString();
+        ++index;
+        return currentFilePath();
+    }
+#endif
+    QString currentFileName() const override
+    {
+        return index < 0 ? QString() : list[index];
+    }
+
+private:
+    const QStringList list;
+    int index;
+};
+
+} // namespace QInstaller
+
+#endif // STRINGLISTITERATOR_P_H
@@ -94,8 +94,6 @@ void TestRepository::doStart()
 
     m_timer.start(10000);
     DownloadFileTask *const xmlTask = new DownloadFileTask(item);
-    if (m_core)
-        xmlTask->setProxyFactory(m_core->proxyFactory());
     m_xmlTask.setFuture(QtConcurrent::run(&DownloadFileTask::doTask, xmlTask));
 }
 
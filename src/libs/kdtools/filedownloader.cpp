@@ -207,6 +207,7 @@ struct KDUpdater::FileDownloader::Private
         , m_downloadSpeed(0)
         , m_factory(0)
         , m_ignoreSslErrors(false)
+        , m_allowInPlaceDownload(false)
     {
         memset(m_samples, 0, sizeof(m_samples));
     }
@@ -247,6 +248,9 @@ struct KDUpdater::FileDownloader::Private
     QAuthenticator m_authenticator;
     FileDownloaderProxyFactory *m_factory;
     bool m_ignoreSslErrors;
+    bool m_allowInPlaceDownload;
+    QByteArray m_partialDownloadKey;
+    QString m_partialDownloadDirectory;
 };
 
 /*!
@@ -657,6 +661,14 @@ void KDUpdater::FileDownloader::addCheckSumData(const QByteArray &data)
     d->m_hash.addData(data);
 }
 
+/*!
+    Adds \a length bytes of checksum data starting at \a data.
+*/
+void KDUpdater::FileDownloader::addCheckSumData(const char *data, qint64 length)
+{
+    d->m_hash.addData(QByteArray::fromRawData(data, int(length)));
+}
+
 /*!
     Resets SHA-1 checksum data of the downloaded file.
 */
@@ -725,6 +737,88 @@ void KDUpdater::FileDownloader::setIgnoreSslErrors(bool ignore)
     d->m_ignoreSslErrors = ignore;
 }
 
+/*!
+    Returns \c true if the downloader may use the source file in place instead of copying it.
+*/
+bool KDUpdater::FileDownloader::allowInPlaceDownload() const
+{
+    return d->m_allowInPlaceDownload;
+}
+
+/*!
+    Determines that downloaders with direct access to the source file may skip copying it if
+    \a allow is \c true. The source file is still read once to calculate its checksum, and
+    downloadedFileName() returns the path of the source file afterwards. The caller must not
+    remove that file then. Only LocalFileDownloader supports this. The default is \c false.
+
+    \sa isDownloadedInPlace()
+*/
+void KDUpdater::FileDownloader::setAllowInPlaceDownload(bool allow)
+{
+    d->m_allowInPlaceDownload = allow;
+}
+
+/*!
+    Returns \c true if the last download used the source file in place, meaning that
+    downloadedFileName() refers to the source and not to a copy of it.
+
+    \sa setAllowInPlaceDownload()
+*/
+bool KDUpdater::FileDownloader::isDownloadedInPlace() const
+{
+    return false;
+}
+
+/*!
+    Returns the key identifying the content of a partially downloaded file.
+
+    \sa setPartialDownloadKey()
+*/
+QByteArray KDUpdater::FileDownloader::partialDownloadKey() const
+{
+    return d->m_partialDownloadKey;
+}
+
+/*!
+    Sets the key identifying the content of the downloaded file to \a key, for example the
+    source URL together with the expected checksum.
+
+    If the key is not empty and a file name is set with setDownloadedFileName(), data is
+    written to a \c .part file next to it, or in the directory set with
+    setPartialDownloadDirectory(). That file is kept if the download fails, is canceled, or
+    the installer exits, and a later download with the same key continues it with an HTTP
+    range request instead of starting over. Only HttpDownloader supports this. The default
+    is an empty key.
+*/
+void KDUpdater::FileDownloader::setPartialDownloadKey(const QByteArray &key)
+{
+    d->m_partialDownloadKey = key;
+}
+
+/*!
+    Returns the directory that keeps the partial files of interrupted downloads.
+
+    \sa setPartialDownloadDirectory()
+*/
+QString KDUpdater::FileDownloader::partialDownloadDirectory() const
+{
+    return d->m_partialDownloadDirectory;
+}
+
+/*!
+    Sets the directory that keeps the partial files of interrupted downloads to \a directory.
+    A partial file in the directory is named after the SHA-1 checksum of the partial download
+    key, so that it is found again independently of the file name of the download. It is
+    moved to the downloaded file name once the download has finished. The default is an
+    empty directory, which keeps the partial file next to the downloaded file.
+
+    \sa setPartialDownloadKey()
+*/
+void KDUpdater::FileDownloader::setPartialDownloadDirectory(const QString &directory)
+{
+    d->m_partialDownloadDirectory = directory;
+}
+
 /*!
     Returns the number of received bytes.
 */
@@ -746,21 +840,30 @@ qint64 FileDownloader::getBytesReceived() const
     a long time, it will make the other downloads hang. Therefore, a timer is used
     and one block of data is copied per unit time, even though QFile::copy() does the
     task of copying local files from one place to another.
+
+    If in place downloads are allowed, the source file is not copied at all. It is only
+    read to calculate its checksum, and downloadedFileName() returns the source path.
 */
 
+static const qint64 scLocalFileBlockSize = 1024 * 1024;
+
 struct KDUpdater::LocalFileDownloader::Private
 {
     Private()
         : source(0)
         , destination(0)
         , downloaded(false)
+        , inPlace(false)
         , timerId(-1)
     {}
 
     QFile *source;
     QFile *destination;
     QString destFileName;
+    QString sourceFileName;
+    QByteArray buffer;
     bool downloaded;
+    bool inPlace;
     int timerId;
 };
 
@@ -778,7 +881,7 @@ KDUpdater::LocalFileDownloader::LocalFileDownloader(QObject *parent)
 */
 KDUpdater::LocalFileDownloader::~LocalFileDownloader()
 {
-    if (this->isAutoRemoveDownloadedFile() && !d->destFileName.isEmpty())
+    if (this->isAutoRemoveDownloadedFile() && !d->inPlace && !d->destFileName.isEmpty())
         QFile::remove(d->destFileName);
 
     delete d;
@@ -821,22 +924,28 @@ void KDUpdater::LocalFileDownloader::doDownload()
         return;
     }
 
-    if (d->destFileName.isEmpty()) {
-        QTemporaryFile *file = new QTemporaryFile(this);
-        file->open();
-        d->destination = file;
-    } else {
-        d->destination = new QFile(d->destFileName, this);
-        d->destination->open(QIODevice::ReadWrite | QIODevice::Truncate);
-    }
+    // If allowed, only hash the source where it is instead of copying it to the destination.
+    d->inPlace = allowInPlaceDownload();
+    d->sourceFileName = localFile;
+    if (!d->inPlace) {
+        if (d->destFileName.isEmpty()) {
+            QTemporaryFile *file = new QTemporaryFile(this);
+            file->open();
+            d->destination = file;
+        } else {
+            d->destination = new QFile(d->destFileName, this);
+            d->destination->open(QIODevice::ReadWrite | QIODevice::Truncate);
+        }
 
-    if (!d->destination->isOpen()) {
-        setDownloadAborted(tr("Cannot open file \"%1\" for writing: %2")
-            .arg(QFileInfo(d->destination->fileName()).fileName(), d->destination->errorString()));
-        onError();
-        return;
+        if (!d->destination->isOpen()) {
+            setDownloadAborted(tr("Cannot open file \"%1\" for writing: %2")
+                .arg(QFileInfo(d->destination->fileName()).fileName(), d->destination->errorString()));
+            onError();
+            return;
+        }
     }
 
+    d->buffer.resize(scLocalFileBlockSize);
     runDownloadSpeedTimer();
     // Start a timer and kickoff the copy process
     d->timerId = startTimer(0); // as fast as possible
@@ -850,7 +959,7 @@ void KDUpdater::LocalFileDownloader::doDownload()
 */
 QString KDUpdater::LocalFileDownloader::downloadedFileName() const
 {
-    return d->destFileName;
+    return d->inPlace ? d->sourceFileName : d->destFileName;
 }
 
 /*!
@@ -870,6 +979,14 @@ KDUpdater::LocalFileDownloader *KDUpdater::LocalFileDownloader::clone(QObject *p
     return new LocalFileDownloader(parent);
 }
 
+/*!
+    Returns \c true if the source file was used in place instead of being copied.
+*/
+bool KDUpdater::LocalFileDownloader::isDownloadedInPlace() const
+{
+    return d->downloaded && d->inPlace;
+}
+
 /*!
     Cancels copying the file.
 */
@@ -891,16 +1008,22 @@ void KDUpdater::LocalFileDownloader::cancelDownload()
 void KDUpdater::LocalFileDownloader::timerEvent(QTimerEvent *event)
 {
     if (event->timerId() == d->timerId) {
-        if (!d->source || !d->destination)
+        if (!d->source || (!d->destination && !d->inPlace))
             return;
 
-        const qint64 blockSize = 32768;
-        QByteArray buffer;
-        buffer.resize(blockSize);
-        const qint64 numRead = d->source->read(buffer.data(), buffer.size());
-        qint64 toWrite = numRead;
+        const qint64 numRead = d->source->read(d->buffer.data(), d->buffer.size());
+        if (numRead < 0) {
+            killTimer(d->timerId);
+            d->timerId = -1;
+            setDownloadAborted(tr("Reading from file \"%1\" failed: %2").arg(
+                                   QDir::toNativeSeparators(d->source->fileName()),
+                                   d->source->errorString()));
+            onError();
+            return;
+        }
+        qint64 toWrite = d->inPlace ? 0 : numRead;
         while (toWrite > 0) {
-            const qint64 numWritten = d->destination->write(buffer.constData() + numRead - toWrite, toWrite);
+            const qint64 numWritten = d->destination->write(d->buffer.constData() + numRead - toWrite, toWrite);
             if (numWritten < 0) {
                 killTimer(d->timerId);
                 d->timerId = -1;
@@ -913,14 +1036,15 @@ void KDUpdater::LocalFileDownloader::timerEvent(QTimerEvent *event)
             toWrite -= numWritten;
         }
         addSample(numRead);
-        addCheckSumData(buffer.left(numRead));
+        addCheckSumData(d->buffer.constData(), numRead);
         if (numRead > 0) {
             setProgress(d->source->pos(), d->source->size());
             emit downloadProgress(calcProgress(d->source->pos(), d->source->size()));
             return;
         }
 
-        d->destination->flush();
+        if (d->destination)
+            d->destination->flush();
 
         killTimer(d->timerId);
         d->timerId = -1;
@@ -941,14 +1065,17 @@ void KDUpdater::LocalFileDownloader::timerEvent(QTimerEvent *event)
 void LocalFileDownloader::onSuccess()
 {
     d->downloaded = true;
-    d->destFileName = d->destination->fileName();
-    if (QTemporaryFile *file = dynamic_cast<QTemporaryFile *>(d->destination))
-        file->setAutoRemove(false);
-    d->destination->close();
-    delete d->destination;
-    d->destination = 0;
+    if (d->destination) {
+        d->destFileName = d->destination->fileName();
+        if (QTemporaryFile *file = dynamic_cast<QTemporaryFile *>(d->destination))
+            file->setAutoRemove(false);
+        d->destination->close();
+        delete d->destination;
+        d->destination = 0;
+    }
     delete d->source;
     d->source = 0;
+    d->buffer = QByteArray();
     stopDownloadSpeedTimer();
 }
 
@@ -960,10 +1087,12 @@ void LocalFileDownloader::onError()
 {
     d->downloaded = false;
     d->destFileName.clear();
+    d->sourceFileName.clear();
     delete d->destination;
     d->destination = 0;
     delete d->source;
     d->source = 0;
+    d->buffer = QByteArray();
     stopDownloadSpeedTimer();
 }
 
@@ -1161,23 +1290,36 @@ struct KDUpdater::HttpDownloader::Private
 {
     explicit Private(HttpDownloader *qq)
         : q(qq)
+        , manager(FileDownloaderFactory::networkAccessManager())
         , http(0)
         , destination(0)
         , downloaded(false)
         , aborted(false)
+        , rangeChecked(false)
         , m_authenticationCount(0)
     {}
 
     HttpDownloader *const q;
-    QNetworkAccessManager manager;
+    QNetworkAccessManager *const manager;
     QNetworkReply *http;
     QUrl sourceUrl;
     QFile *destination;
     QString destFileName;
     bool downloaded;
     bool aborted;
+    bool rangeChecked;
     int m_authenticationCount;
 
+    QString partialFileName() const
+    {
+        const QString directory = q->partialDownloadDirectory();
+        if (directory.isEmpty())
+            return destFileName + QLatin1String(".part");
+        return directory + QLatin1Char('/') + QString::fromLatin1(QCryptographicHash::hash(
+            q->partialDownloadKey(), QCryptographicHash::Sha1).toHex()) + QLatin1String(".part");
+    }
+    QString partialInfoFileName() const { return partialFileName() + QLatin1String(".info"); }
+
     void shutDown(bool closeDestination = true)
     {
         if (http) {
@@ -1206,13 +1348,13 @@ KDUpdater::HttpDownloader::HttpDownloader(QObject *parent)
     , d(new Private(this))
 {
 #ifndef QT_NO_SSL
-    connect(&d->manager, &QNetworkAccessManager::sslErrors,
+    connect(d->manager, &QNetworkAccessManager::sslErrors,
             this, &HttpDownloader::onSslErrors);
 #endif
-    connect(&d->manager, &QNetworkAccessManager::authenticationRequired,
+    connect(d->manager, &QNetworkAccessManager::authenticationRequired,
             this, &HttpDownloader::onAuthenticationRequired);
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    connect(&d->manager, &QNetworkAccessManager::networkAccessibleChanged,
+    connect(d->manager, &QNetworkAccessManager::networkAccessibleChanged,
             this, &HttpDownloader::onNetworkAccessibleChanged);
 #else
     auto netInfo = QNetworkInformation::instance();
@@ -1230,6 +1372,13 @@ KDUpdater::HttpDownloader::HttpDownloader(QObject *parent)
 */
 KDUpdater::HttpDownloader::~HttpDownloader()
 {
+    // The network access manager is shared and outlives this downloader, stop the request.
+    if (d->http) {
+        disconnect(d->http, nullptr, this, nullptr);
+        d->http->abort();
+        d->http->deleteLater();
+        d->http = 0;
+    }
     if (this->isAutoRemoveDownloadedFile() && !d->destFileName.isEmpty())
         QFile::remove(d->destFileName);
     delete d;
@@ -1294,6 +1443,26 @@ void KDUpdater::HttpDownloader::httpReadyRead()
 {
     if (d->http == 0 || d->destination == 0)
       return;
+
+    // Redirects and error pages are not part of the file.
+    const int statusCode = d->http->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (statusCode >= 300) {
+        d->http->readAll();
+        return;
+    }
+
+    if (isDownloadResumed() && !d->rangeChecked) {
+        d->rangeChecked = true;
+        if (statusCode == 200) {
+            // The server ignored the range and sends the whole file.
+            d->destination->resize(0);
+            d->destination->seek(0);
+            resetCheckSumData();
+            clearBytesDownloadedBeforeResume();
+            setDownloadResumed(false);
+        }
+    }
+
     static QByteArray buffer(16384, '\0');
     while (d->http->bytesAvailable()) {
         const qint64 read = d->http->read(buffer.data(), buffer.size());
@@ -1311,7 +1480,7 @@ void KDUpdater::HttpDownloader::httpReadyRead()
             written += numWritten;
         }
         addSample(written);
-        addCheckSumData(buffer.left(read));
+        addCheckSumData(buffer.constData(), read);
         updateBytesDownloadedBeforeResume(written);
     }
 }
@@ -1329,6 +1498,8 @@ void KDUpdater::HttpDownloader::cancelDownload()
 {
     d->aborted = true;
     if (d->http) {
+        // Aborting emits finished(), do not handle it as a regular end of the request.
+        disconnect(d->http, nullptr, this, nullptr);
         d->http->abort();
         httpDone(true);
     }
@@ -1337,9 +1508,19 @@ void KDUpdater::HttpDownloader::cancelDownload()
 void KDUpdater::HttpDownloader::httpDone(bool error)
 {
     if (error) {
-        if (isDownloadResumed()) {
-            d->shutDown(false);
-            return;
+        const int statusCode = d->http
+            ? d->http->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() : 0;
+        if (isDownloadResumed() && !d->aborted) {
+            // 416: Range Not Satisfiable, the partial file does not match the server's file.
+            if (statusCode == 416 && d->destination) {
+                restartDownload();
+                return;
+            }
+            // Wait for the download deadline timer to resume, unless the server refused.
+            if (statusCode < 400) {
+                d->shutDown(false);
+                return;
+            }
         }
         QString err;
         if (d->http) {
@@ -1367,6 +1548,7 @@ void KDUpdater::HttpDownloader::httpDone(bool error)
 void KDUpdater::HttpDownloader::onError()
 {
     d->downloaded = false;
+    // A partial file with its key file stays on disk, so that the next download continues it.
     d->destFileName.clear();
     delete d->destination;
     d->destination = 0;
@@ -1382,7 +1564,19 @@ void KDUpdater::HttpDownloader::onSuccess()
 {
     d->downloaded = true;
     if (d->destination) {
-        d->destFileName = d->destination->fileName();
+        if (d->destination->fileName() == d->partialFileName()) {
+            d->destination->close();
+            QFile::remove(d->destFileName);
+            QDir().mkpath(QFileInfo(d->destFileName).absolutePath());
+            if (!d->destination->rename(d->destFileName)) {
+                qCWarning(QInstaller::lcInstallerInstallLog) << "Cannot rename" << d->partialFileName()
+                    << "to" << d->destFileName << ":" << d->destination->errorString();
+                d->destFileName = d->destination->fileName();
+            }
+            QFile::remove(d->partialInfoFileName());
+        } else {
+            d->destFileName = d->destination->fileName();
+        }
         if (QTemporaryFile *file = dynamic_cast<QTemporaryFile *>(d->destination))
             file->setAutoRemove(false);
     }
@@ -1471,50 +1665,147 @@ void KDUpdater::HttpDownloader::startDownload(const QUrl &url)
 {
     d->sourceUrl = url;
     d->m_authenticationCount = 0;
-    d->manager.setProxyFactory(proxyFactory());
     clearBytesDownloadedBeforeResume();
 
-    QNetworkRequest request(url);
-    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::ManualRedirectPolicy);
-    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    if (!openDestination())
+        return;
 
-    d->http = d->manager.get(request);
-    connect(d->http, &QIODevice::readyRead, this, &HttpDownloader::httpReadyRead);
-    connect(d->http, &QNetworkReply::downloadProgress,
-            this, &HttpDownloader::httpReadProgress);
-    connect(d->http, &QNetworkReply::finished, this, &HttpDownloader::httpReqFinished);
-    connect(d->http, &QNetworkReply::errorOccurred, this, &HttpDownloader::httpError);
+    // A kept partial file is continued where the previous download stopped.
+    const qint64 offset = d->destination->size();
+    if (offset > 0) {
+        qCDebug(QInstaller::lcInstallerInstallLog) << "Continuing partial download of"
+            << url.toString() << "at byte" << offset;
+        updateBytesDownloadedBeforeResume(offset);
+        updateTotalBytesDownloadedBeforeResume();
+        setDownloadResumed(true);
+    }
+    startRequest(offset);
+}
+
+/*!
+    \internal
 
+    Opens the destination file. If a partial download key is set, the partial file of a
+    previous download with the same key is reopened and its content added to the checksum.
+*/
+bool KDUpdater::HttpDownloader::openDestination()
+{
     bool fileOpened = false;
     if (d->destFileName.isEmpty()) {
         QTemporaryFile *file = new QTemporaryFile(this);
         fileOpened = file->open();
         d->destination = file;
+    } else if (!partialDownloadKey().isEmpty()) {
+        d->destination = new QFile(d->partialFileName(), this);
+        fileOpened = openPartialFile();
     } else {
         d->destination = new QFile(d->destFileName, this);
         fileOpened = d->destination->open(QIODevice::ReadWrite | QIODevice::Truncate);
     }
-    if (!fileOpened) {
-        qCWarning(QInstaller::lcInstallerInstallLog).nospace() << "Failed to open file " << d->destFileName
-            << ": "<<d->destination->errorString() << ". Trying again.";
-        QFileInfo fileInfo;
-        fileInfo.setFile(d->destination->fileName());
-        if (!QDir().mkpath(fileInfo.absolutePath())) {
-            setDownloadAborted(tr("Cannot download %1. Cannot create directory for \"%2\"").arg(
-                url.toString(), fileInfo.filePath()));
-        } else {
-            fileOpened = d->destination->open(QIODevice::ReadWrite | QIODevice::Truncate);
-            if (fileOpened)
-                return;
-            if (d->destination->exists())
-                qCWarning(QInstaller::lcInstallerInstallLog) << "File exists but installer is unable to open it.";
-            else
-                qCWarning(QInstaller::lcInstallerInstallLog) << "File does not exist.";
-            setDownloadAborted(tr("Cannot download %1. Cannot create file \"%2\": %3").arg(
-                url.toString(), d->destination->fileName(), d->destination->errorString()));
-            d->shutDown();
+    if (fileOpened)
+        return true;
+
+    qCWarning(QInstaller::lcInstallerInstallLog).nospace() << "Failed to open file " << d->destFileName
+        << ": "<<d->destination->errorString() << ". Trying again.";
+    QFileInfo fileInfo;
+    fileInfo.setFile(d->destination->fileName());
+    if (!QDir().mkpath(fileInfo.absolutePath())) {
+        setDownloadAborted(tr("Cannot download %1. Cannot create directory for \"%2\"").arg(
+            d->sourceUrl.toString(), fileInfo.filePath()));
+        d->shutDown();
+        return false;
+    }
+    fileOpened = partialDownloadKey().isEmpty() || d->destFileName.isEmpty()
+        ? d->destination->open(QIODevice::ReadWrite | QIODevice::Truncate) : openPartialFile();
+    if (fileOpened)
+        return true;
+
+    if (d->destination->exists())
+        qCWarning(QInstaller::lcInstallerInstallLog) << "File exists but installer is unable to open it.";
+    else
+        qCWarning(QInstaller::lcInstallerInstallLog) << "File does not exist.";
+    setDownloadAborted(tr("Cannot download %1. Cannot create file \"%2\": %3").arg(
+        d->sourceUrl.toString(), d->destination->fileName(), d->destination->errorString()));
+    d->shutDown();
+    return false;
+}
+
+/*!
+    \internal
+
+    Opens the partial file for appending. Its content is kept only if it was written for the
+    same partial download key, otherwise the file is truncated.
+*/
+bool KDUpdater::HttpDownloader::openPartialFile()
+{
+    QFile info(d->partialInfoFileName());
+    const bool sameContent = info.open(QIODevice::ReadOnly) && info.readAll() == partialDownloadKey();
+    info.close();
+
+    QIODevice::OpenMode mode = QIODevice::ReadWrite;
+    if (!sameContent)
+        mode |= QIODevice::Truncate;
+    if (!d->destination->open(mode))
+        return false;
+
+    QByteArray buffer(1024 * 1024, Qt::Uninitialized);
+    while (!d->destination->atEnd()) {
+        const qint64 numRead = d->destination->read(buffer.data(), buffer.size());
+        if (numRead <= 0) {
+            // Do not continue from a file we cannot read back for the checksum.
+            d->destination->resize(0);
+            resetCheckSumData();
+            break;
         }
+        addCheckSumData(buffer.constData(), numRead);
+    }
+    d->destination->seek(d->destination->size());
+
+    if (!info.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            || info.write(partialDownloadKey()) != partialDownloadKey().size()) {
+        qCWarning(QInstaller::lcInstallerInstallLog) << "Cannot write" << info.fileName()
+            << "- the download cannot be continued after an interruption.";
     }
+    return true;
+}
+
+/*!
+    \internal
+
+    Requests the source file starting at \a offset.
+*/
+void KDUpdater::HttpDownloader::startRequest(qint64 offset)
+{
+    QNetworkRequest request(d->sourceUrl);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::ManualRedirectPolicy);
+    FileDownloaderFactory::configureRequest(&request);
+    if (offset > 0)
+        request.setRawHeader(QByteArray("Range"), QByteArray("bytes=") + QByteArray::number(offset) + '-');
+
+    d->rangeChecked = false;
+    d->http = d->manager->get(request);
+    connect(d->http, &QIODevice::readyRead, this, &HttpDownloader::httpReadyRead);
+    connect(d->http, &QNetworkReply::downloadProgress,
+            this, &HttpDownloader::httpReadProgress);
+    connect(d->http, &QNetworkReply::finished, this, &HttpDownloader::httpReqFinished);
+    connect(d->http, &QNetworkReply::errorOccurred, this, &HttpDownloader::httpError);
+}
+
+/*!
+    \internal
+
+    Drops the downloaded data and requests the whole file again. Used when the server does
+    not accept the range of a resumed download.
+*/
+void KDUpdater::HttpDownloader::restartDownload()
+{
+    d->shutDown(false);
+    d->destination->resize(0);
+    d->destination->seek(0);
+    resetCheckSumData();
+    clearBytesDownloadedBeforeResume();
+    setDownloadResumed(false);
+    startRequest(0);
 }
 
 void KDUpdater::HttpDownloader::resumeDownload()
@@ -1522,13 +1813,15 @@ void KDUpdater::HttpDownloader::resumeDownload()
     updateTotalBytesDownloadedBeforeResume();
     d->m_authenticationCount = 0;
     QNetworkRequest request(d->sourceUrl);
+    FileDownloaderFactory::configureRequest(&request);
 
     request.setRawHeader(QByteArray("Range"),
                          QString(QStringLiteral("bytes=%1-"))
                          .arg(bytesDownloadedBeforeResume())
                          .toLatin1());
     setDownloadResumed(true);
-    d->http = d->manager.get(request);
+    d->rangeChecked = false;
+    d->http = d->manager->get(request);
     connect(d->http, &QIODevice::readyRead, this, &HttpDownloader::httpReadyRead);
     connect(d->http, &QNetworkReply::downloadProgress,
             this, &HttpDownloader::httpReadProgress);
@@ -1540,7 +1833,10 @@ void KDUpdater::HttpDownloader::resumeDownload()
 
 void KDUpdater::HttpDownloader::onAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator)
 {
-    Q_UNUSED(reply)
+    // The network access manager is shared, ignore requests started by other downloaders.
+    if (reply != d->http)
+        return;
+
     // first try with the information we have already
     if (d->m_authenticationCount == 0) {
         d->m_authenticationCount++;
@@ -1613,7 +1909,9 @@ void KDUpdater::HttpDownloader::onReachabilityChanged(QNetworkInformation::Reach
 
 void KDUpdater::HttpDownloader::onSslErrors(QNetworkReply* reply, const QList<QSslError> &errors)
 {
-    Q_UNUSED(reply)
+    if (reply != d->http)
+        return;
+
     QString errorString;
     foreach (const QSslError &error, errors) {
         if (!errorString.isEmpty())
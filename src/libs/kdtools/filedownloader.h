@@ -90,6 +90,15 @@ public:
     bool ignoreSslErrors();
     void setIgnoreSslErrors(bool ignore);
 
+    bool allowInPlaceDownload() const;
+    void setAllowInPlaceDownload(bool allow);
+    virtual bool isDownloadedInPlace() const;
+
+    QByteArray partialDownloadKey() const;
+    void setPartialDownloadKey(const QByteArray &key);
+    QString partialDownloadDirectory() const;
+    void setPartialDownloadDirectory(const QString &directory);
+
     qint64 getBytesReceived() const;
 
 public Q_SLOTS:
@@ -143,6 +152,7 @@ protected:
     void emitEstimatedDownloadTime();
 
     void addCheckSumData(const QByteArray &data);
+    void addCheckSumData(const char *data, qint64 length);
     void resetCheckSumData();
 
 private Q_SLOTS:
@@ -56,6 +56,7 @@ public:
     QString downloadedFileName() const override;
     void setDownloadedFileName(const QString &name) override;
     LocalFileDownloader *clone(QObject *parent = 0) const override;
+    bool isDownloadedInPlace() const override;
 
 public Q_SLOTS:
     void cancelDownload() override;
@@ -145,6 +146,10 @@ private Q_SLOTS:
 private:
     void startDownload(const QUrl &url);
     void resumeDownload();
+    bool openDestination();
+    bool openPartialFile();
+    void startRequest(qint64 offset);
+    void restartDownload();
 
 private:
     struct Private;
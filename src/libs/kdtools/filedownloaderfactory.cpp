@@ -30,6 +30,16 @@
 #include "filedownloader_p.h"
 #include "globals.h"
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QPointer>
+#include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+#include <QtNetwork/QHttp1Configuration>
+#endif
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QSslSocket>
 
 using namespace KDUpdater;
@@ -92,12 +102,16 @@ void FileDownloaderFactory::setFollowRedirects(bool val)
 }
 
 /*!
-    Sets \a factory as the file downloader proxy factory.
+    Sets \a factory as the file downloader proxy factory. The shared network access managers
+    pick up the new factory the next time they are requested.
 */
 void FileDownloaderFactory::setProxyFactory(FileDownloaderProxyFactory *factory)
 {
-    delete FileDownloaderFactory::instance().d->m_factory;
-    FileDownloaderFactory::instance().d->m_factory = factory;
+    FileDownloaderFactoryData *const data = FileDownloaderFactory::instance().d;
+    QMutexLocker _(&data->m_factoryMutex);
+    delete data->m_factory;
+    data->m_factory = factory;
+    data->m_factoryGeneration.fetchAndAddOrdered(1);
 }
 
 /*!
@@ -116,6 +130,111 @@ void FileDownloaderFactory::setIgnoreSslErrors(bool ignore)
     FileDownloaderFactory::instance().d->m_ignoreSslErrors = ignore;
 }
 
+/*!
+    Returns \c true if requests may be sent over HTTP/2. The default is \c false.
+*/
+bool FileDownloaderFactory::http2Allowed()
+{
+    return FileDownloaderFactory::instance().d->m_http2Allowed;
+}
+
+/*!
+    Determines that requests may be multiplexed over HTTP/2 connections if \a allowed is
+    \c true and the server supports it.
+*/
+void FileDownloaderFactory::setHttp2Allowed(bool allowed)
+{
+    FileDownloaderFactory::instance().d->m_http2Allowed = allowed;
+}
+
+/*!
+    Returns the maximum number of parallel HTTP/1 connections opened to a single host.
+    The default is \c 6.
+*/
+int FileDownloaderFactory::maxConnectionsPerHost()
+{
+    return FileDownloaderFactory::instance().d->m_maxConnectionsPerHost;
+}
+
+/*!
+    Sets the maximum number of parallel HTTP/1 connections opened to a single host to
+    \a connections. Values smaller than \c 1 are ignored. Only Qt 6.5 and later allow
+    configuring the connections of a network access manager, with earlier versions the
+    value has no effect on them.
+*/
+void FileDownloaderFactory::setMaxConnectionsPerHost(int connections)
+{
+    if (connections > 0)
+        FileDownloaderFactory::instance().d->m_maxConnectionsPerHost = connections;
+}
+
+/*!
+    Returns the network access manager shared by all downloads started from the calling
+    thread. Sharing the manager keeps connections alive between requests, so consecutive
+    downloads from the same host do not need a new TCP and TLS handshake each.
+
+    QNetworkAccessManager can only be used from the thread it lives in, thus each thread gets
+    its own instance. The instance of the application thread is deleted together with the
+    application object, the others when their thread exits.
+
+    The proxy factory set with setProxyFactory() is applied when the manager is created and
+    again only after it was changed, not for every request.
+*/
+QNetworkAccessManager *FileDownloaderFactory::networkAccessManager()
+{
+    QCoreApplication *const app = QCoreApplication::instance();
+    if (app && QThread::currentThread() == app->thread()) {
+        static QPointer<QNetworkAccessManager> manager;
+        static int generation = -1;
+        if (!manager) {
+            manager = new QNetworkAccessManager(app);
+            generation = -1;
+        }
+        updateProxyFactory(manager, &generation);
+        return manager;
+    }
+
+    static QThreadStorage<QNetworkAccessManager *> managers;
+    static QThreadStorage<int> generations;
+    if (!managers.hasLocalData()) {
+        managers.setLocalData(new QNetworkAccessManager);
+        generations.setLocalData(-1);
+    }
+    updateProxyFactory(managers.localData(), &generations.localData());
+    return managers.localData();
+}
+
+/*!
+    \internal
+
+    Sets a copy of the current proxy factory on \a manager, unless \a generation shows that the
+    manager already uses it.
+*/
+void FileDownloaderFactory::updateProxyFactory(QNetworkAccessManager *manager, int *generation)
+{
+    FileDownloaderFactoryData *const data = FileDownloaderFactory::instance().d;
+    if (*generation == data->m_factoryGeneration.loadAcquire())
+        return;
+
+    QMutexLocker _(&data->m_factoryMutex);
+    *generation = data->m_factoryGeneration.loadAcquire();
+    manager->setProxyFactory(data->m_factory ? data->m_factory->clone() : 0);
+}
+
+/*!
+    Applies the HTTP/2 and connection limit settings of the factory to \a request.
+*/
+void FileDownloaderFactory::configureRequest(QNetworkRequest *request)
+{
+    const FileDownloaderFactoryData *const data = FileDownloaderFactory::instance().d;
+    request->setAttribute(QNetworkRequest::Http2AllowedAttribute, data->m_http2Allowed);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+    QHttp1Configuration configuration;
+    configuration.setNumberOfConnectionsPerHost(data->m_maxConnectionsPerHost);
+    request->setHttp1Configuration(configuration);
+#endif
+}
+
 /*!
     Destroys the file downloader factory.
 */
@@ -32,6 +32,8 @@
 #include "genericfactory.h"
 #include "updater.h"
 
+#include <QtCore/QAtomicInt>
+#include <QtCore/QMutex>
 #include <QtCore/QStringList>
 #include <QtCore/QUrl>
 
@@ -39,6 +41,8 @@
 
 QT_BEGIN_NAMESPACE
 class QObject;
+class QNetworkAccessManager;
+class QNetworkRequest;
 QT_END_NAMESPACE
 
 namespace KDUpdater {
@@ -57,12 +61,20 @@ class KDTOOLS_EXPORT FileDownloaderFactory : public GenericFactory<FileDownloade
 {
     Q_DISABLE_COPY(FileDownloaderFactory)
     struct FileDownloaderFactoryData {
-        FileDownloaderFactoryData() : m_factory(0) {}
+        FileDownloaderFactoryData()
+            : m_http2Allowed(false)
+            , m_maxConnectionsPerHost(6)
+            , m_factory(0)
+        {}
         ~FileDownloaderFactoryData() { delete m_factory; }
 
         bool m_followRedirects;
         bool m_ignoreSslErrors;
+        bool m_http2Allowed;
+        int m_maxConnectionsPerHost;
         QStringList m_supportedSchemes;
+        QMutex m_factoryMutex;
+        QAtomicInt m_factoryGeneration;
         FileDownloaderProxyFactory *m_factory;
     };
 
@@ -86,11 +98,21 @@ public:
     static bool ignoreSslErrors();
     static void setIgnoreSslErrors(bool ignore);
 
+    static bool http2Allowed();
+    static void setHttp2Allowed(bool allowed);
+
+    static int maxConnectionsPerHost();
+    static void setMaxConnectionsPerHost(int connections);
+
+    static QNetworkAccessManager *networkAccessManager();
+    static void configureRequest(QNetworkRequest *request);
+
     static QStringList supportedSchemes();
     static bool isSupportedScheme(const QString &scheme);
 
 private:
     FileDownloaderFactory();
+    static void updateProxyFactory(QNetworkAccessManager *manager, int *generation);
 
 private:
     FileDownloaderFactoryData *d;
@@ -48,12 +48,20 @@ using namespace KDUpdater;
     Returns the package source.
 */
 
+/*!
+    \fn KDUpdater::Update::versionKey() const
+
+    Returns the version of the update, split into its components once when the
+    update was created.
+*/
+
 /*!
    \internal
 */
 Update::Update(const QInstaller::PackageSource &packageSource, const UpdateInfo &updateInfo)
     : m_packageSource(packageSource)
     , m_updateInfo(updateInfo)
+    , m_versionKey(updateInfo.data.value(QLatin1String("Version")).toString())
 {
 }
 
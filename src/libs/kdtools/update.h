@@ -31,6 +31,7 @@
 
 #include "packagesource.h"
 #include "updatesinfo_p.h"
+#include "versionkey.h"
 #include <QVariant>
 
 namespace KDUpdater {
@@ -41,6 +42,7 @@ public:
     QVariant data(const QString &name, const QVariant &defaultValue = QVariant()) const;
 
     QInstaller::PackageSource packageSource() const {return m_packageSource; }
+    VersionKey versionKey() const { return m_versionKey; }
 
 private:
     friend class UpdateFinder;
@@ -49,6 +51,7 @@ private:
 private:
     QInstaller::PackageSource m_packageSource;
     UpdateInfo m_updateInfo;
+    VersionKey m_versionKey;
 };
 
 } // namespace KDUpdater
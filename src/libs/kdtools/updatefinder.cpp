@@ -33,13 +33,14 @@
 #include "filedownloaderfactory.h"
 #include "updatesinfo_p.h"
 #include "localpackagehub.h"
+#include "versionkey.h"
 
 #include "fileutils.h"
 #include "globals.h"
+#include "phasetracer.h"
 
 #include <QCoreApplication>
 #include <QFileInfo>
-#include <QRegularExpression>
 #include <QFutureWatcher>
 
 using namespace KDUpdater;
@@ -112,6 +113,17 @@ void UpdateFinder::setPackageSources(const QSet<PackageSource> &sources)
     m_packageSources = sources;
 }
 
+/*!
+    Sets already parsed \a updatesInfo, keyed by the local path of the \c Updates.xml
+    file they were read from. Matching local package sources reuse the parsed package
+    records instead of parsing the file again. The records are only used by the next
+    run and released afterwards.
+*/
+void UpdateFinder::setParsedUpdatesInfo(const QHash<QString, UpdatesInfo> &updatesInfo)
+{
+    m_parsedUpdatesInfo = updatesInfo;
+}
+
 /*!
    \internal
 
@@ -204,6 +216,8 @@ void UpdateFinder::clear()
 */
 void UpdateFinder::computeUpdates()
 {
+    QInstaller::PhaseTracer::Scope trace("Compute updates");
+
     // Computing updates is done in two stages
     // 1. Downloading Update XML files from all the update sources
     // 2. Parse attributes from Update XML documents to UpdateInfoList
@@ -303,11 +317,19 @@ bool UpdateFinder::downloadUpdateXMLFiles()
             connect(downloader, SIGNAL(downloadAborted(QString)), this, SLOT(slotDownloadDone()));
             m_updatesInfoList.insert(new UpdatesInfo(info.postLoadComponentScript), Data(info, downloader));
         } else {
-            UpdatesInfo *updatesInfo = new UpdatesInfo(info.postLoadComponentScript);
-            updatesInfo->setFileName(QInstaller::pathFromUrl(url));
+            const QString fileName = QInstaller::pathFromUrl(url);
+            const auto parsed = m_parsedUpdatesInfo.constFind(fileName);
+            UpdatesInfo *updatesInfo;
+            if (parsed != m_parsedUpdatesInfo.constEnd()) {
+                updatesInfo = new UpdatesInfo(parsed.value());
+            } else {
+                updatesInfo = new UpdatesInfo(info.postLoadComponentScript);
+                updatesInfo->setFileName(fileName);
+            }
             m_updatesInfoList.insert(updatesInfo, Data(info));
         }
     }
+    m_parsedUpdatesInfo.clear();
 
     // Trigger download of Updates.xml file
     m_downloadCompleteCount = 0;
@@ -342,6 +364,10 @@ bool UpdateFinder::parseUpdateXMLFiles()
                 updatesInfo->setFileName(data.downloader->downloadedFileName());
             }
         }
+        // Already parsed while fetching the repository metadata
+        if (updatesInfo->error() != UpdatesInfo::NotYetReadError)
+            continue;
+
         if (!updatesInfo->fileName().isEmpty()) {
             ParseXmlFilesTask *const task = new ParseXmlFilesTask(updatesInfo);
             m_xmlFileTasks.append(task);
@@ -481,8 +507,9 @@ UpdateFinder::Resolution UpdateFinder::checkPriorityAndVersion(
     if (Update *existingPackage = m_updates.value(name)) {
         // Bingo, package was previously found elsewhere.
 
-        const int match = compareVersion(newPackage.value(QLatin1String("Version")).toString(),
-            existingPackage->data(QLatin1String("Version")).toString());
+        const int match = VersionKey::compare(
+            VersionKey(newPackage.value(QLatin1String("Version")).toString()),
+            existingPackage->versionKey());
 
         if (match > 0) {
             // new package has higher version, use
@@ -594,87 +621,7 @@ void UpdateFinder::slotDownloadDone()
 int KDUpdater::compareVersion(const QString &v1, const QString &v2)
 {
     // For tests refer VersionCompareFnTest testcase.
-
-    // Check for equality
-    if (v1 == v2)
-        return 0;
-
-    // Split version components across ".", "-" or "_"
-    static const QRegularExpression regex(QLatin1String( "\\.|-|_"));
-    QStringList v1_comps = v1.split(regex);
-    QStringList v2_comps = v2.split(regex);
-
-    // Check each component of the version
-    int index = 0;
-    while (true) {
-        bool v1_ok = false;
-        bool v2_ok = false;
-
-        if (index == v1_comps.count() && index < v2_comps.count()) {
-            v2_comps.at(index).toLongLong(&v2_ok);
-            return v2_ok ? -1 : +1;
-        }
-        if (index < v1_comps.count() && index == v2_comps.count()) {
-            v1_comps.at(index).toLongLong(&v1_ok);
-            return v1_ok ? +1 : -1;
-        }
-        if (index >= v1_comps.count() || index >= v2_comps.count())
-            break;
-
-        qlonglong v1_comp = v1_comps.at(index).toLongLong(&v1_ok);
-        qlonglong v2_comp = v2_comps.at(index).toLongLong(&v2_ok);
-
-        if (!v1_ok) {
-            if (v1_comps.at(index) == QLatin1String("x"))
-                return 0;
-        }
-        if (!v2_ok) {
-            if (v2_comps.at(index) == QLatin1String("x"))
-                return 0;
-        }
-        if (!v1_ok && !v2_ok) {
-            // try remove equal start
-            int i = 0;
-            while (i < v1_comps.at(index).size()
-                && i < v2_comps.at(index).size()
-                && v1_comps.at(index).at(i) == v2_comps.at(index).at(i)) {
-                ++i;
-            }
-            if (i > 0) {
-                v1_comps[index] = v1_comps.at(index).mid(i);
-                v2_comps[index] = v2_comps.at(index).mid(i);
-                // compare again
-                continue;
-            }
-        }
-        if (!v1_ok || !v2_ok) {
-            int res = v1_comps.at(index).compare(v2_comps.at(index));
-            if (res == 0) {
-                // v1_comps.at(index) == v2_comps(index)
-                ++index;
-                continue;
-            }
-            return res > 0 ? +1 : -1;
-        }
-
-        if (v1_comp < v2_comp)
-            return -1;
-
-        if (v1_comp > v2_comp)
-            return +1;
-
-        // v1_comp == v2_comp
-        ++index;
-    }
-
-    if (index < v2_comps.count())
-        return +1;
-
-    if (index < v1_comps.count())
-        return -1;
-
-    // Controversial return. I hope this never happens.
-    return 0;
+    return VersionKey::compare(VersionKey(v1), VersionKey(v2));
 }
 
 #include "moc_updatefinder.cpp"
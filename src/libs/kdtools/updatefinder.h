@@ -102,6 +102,7 @@ public:
 
     void setLocalPackageHub(std::weak_ptr<LocalPackageHub> hub);
     void setPackageSources(const QSet<QInstaller::PackageSource> &sources);
+    void setParsedUpdatesInfo(const QHash<QString, UpdatesInfo> &updatesInfo);
 
 private:
     void doRun() override;
@@ -127,6 +128,7 @@ private slots:
 
 private:
     QSet<PackageSource> m_packageSources;
+    QHash<QString, UpdatesInfo> m_parsedUpdatesInfo;
     std::weak_ptr<LocalPackageHub> m_localPackageHub;
     QHash<QString, Update *> m_updates;
 
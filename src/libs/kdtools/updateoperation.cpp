@@ -40,6 +40,8 @@
 #include <QFileInfo>
 #include <QTemporaryFile>
 
+#include <utility>
+
 using namespace KDUpdater;
 
 /*!
@@ -64,6 +66,8 @@ using namespace KDUpdater;
             No error occurred.
     \value  InvalidArguments
             Number of arguments does not match or an invalid argument was set.
+    \value  InvalidXml
+            The operation could not be restored from the XML set with setDeferredXml().
     \value  UserDefinedError
             An error occurred during operation run. Use UpdateOperation::errorString()
             to get the human-readable description of the error that occurred.
@@ -153,6 +157,7 @@ QString UpdateOperation::name() const
 */
 QString UpdateOperation::operationCommand() const
 {
+    loadDeferredXml();
     QString argsStr = m_arguments.join(QLatin1String( " " ));
     return QString::fromLatin1( "%1 %2" ).arg(m_name, argsStr);
 }
@@ -172,6 +177,8 @@ UpdateOperation::OperationGroup UpdateOperation::group() const
 */
 bool UpdateOperation::hasValue(const QString &name) const
 {
+    if (!m_values.contains(name))
+        loadDeferredXml();
     return m_values.contains(name);
 }
 
@@ -180,6 +187,7 @@ bool UpdateOperation::hasValue(const QString &name) const
 */
 void UpdateOperation::clearValue(const QString &name)
 {
+    loadDeferredXml();
     m_values.remove(name);
 }
 
@@ -188,6 +196,8 @@ void UpdateOperation::clearValue(const QString &name)
 */
 QVariant UpdateOperation::value(const QString &name) const
 {
+    if (!m_values.contains(name))
+        loadDeferredXml();
     return m_values.value(name);
 }
 
@@ -196,6 +206,7 @@ QVariant UpdateOperation::value(const QString &name) const
 */
 void UpdateOperation::setValue(const QString &name, const QVariant &value)
 {
+    loadDeferredXml();
     m_values[name] = value;
 }
 
@@ -224,6 +235,7 @@ void UpdateOperation::setGroup(const OperationGroup &group)
 */
 void UpdateOperation::setArguments(const QStringList &args)
 {
+    loadDeferredXml();
     m_arguments = args;
 }
 
@@ -232,6 +244,7 @@ void UpdateOperation::setArguments(const QStringList &args)
 */
 QStringList UpdateOperation::arguments() const
 {
+    loadDeferredXml();
     return m_arguments;
 }
 
@@ -394,6 +407,7 @@ QString UpdateOperation::argumentKeyValue(const QString &key, const QString &def
 */
 QString UpdateOperation::errorString() const
 {
+    loadDeferredXml();
     return m_errorString;
 }
 
@@ -406,6 +420,7 @@ QString UpdateOperation::errorString() const
 */
 int UpdateOperation::error() const
 {
+    loadDeferredXml();
     return m_error;
 }
 
@@ -435,6 +450,7 @@ void UpdateOperation::setError(int error, const QString &errorString)
 */
 void UpdateOperation::clear()
 {
+    loadDeferredXml();
     m_arguments.clear();
 }
 
@@ -537,6 +553,7 @@ bool UpdateOperation::deleteFileNowOrLater(const QString &file, QString *errorSt
 */
 QDomDocument UpdateOperation::toXml() const
 {
+    loadDeferredXml();
     QDomDocument doc;
     QDomElement root = doc.createElement(QLatin1String("operation"));
     doc.appendChild(root);
@@ -606,6 +623,7 @@ QDomDocument UpdateOperation::toXml() const
 */
 bool UpdateOperation::fromXml(const QDomDocument &doc)
 {
+    m_deferredXml.clear();
     QString target = QCoreApplication::applicationDirPath();
     static const QLatin1String relocatable = QLatin1String(QInstaller::scRelocatable);
     // Does not change target on non macOS platforms.
@@ -708,3 +726,47 @@ bool UpdateOperation::fromXml(const QString &xml)
     }
     return fromXml(doc);
 }
+
+/*!
+    Sets the XML representation \a xml of the operation without parsing it. The arguments
+    and values are restored from \a xml the first time they are accessed. Values that are
+    already known, for example from an index of the stored operations, can be passed in
+    \a knownValues and are returned without parsing \a xml.
+
+    If \a xml cannot be restored once it is accessed, the arguments are left empty and
+    error() returns \c InvalidXml.
+
+    \sa deferredXml(), fromXml()
+*/
+void UpdateOperation::setDeferredXml(const QString &xml, const QVariantMap &knownValues)
+{
+    m_deferredXml = xml;
+    for (auto it = knownValues.constBegin(); it != knownValues.constEnd(); ++it)
+        m_values.insert(it.key(), it.value());
+}
+
+/*!
+    Returns the XML representation set with setDeferredXml() if the operation has not
+    been restored from it yet, otherwise returns an empty string.
+*/
+QString UpdateOperation::deferredXml() const
+{
+    return m_deferredXml;
+}
+
+/*!
+    \internal
+*/
+void UpdateOperation::loadDeferredXml() const
+{
+    if (m_deferredXml.isEmpty())
+        return;
+
+    const QString xml = std::exchange(m_deferredXml, QString());
+    UpdateOperation *const self = const_cast<UpdateOperation *>(this);
+    if (!self->fromXml(xml)) {
+        qCWarning(QInstaller::lcInstallerInstallLog) << "Failed to load XML for operation"
+            << name();
+        self->setError(InvalidXml, tr("Cannot restore operation %1 from its XML.").arg(name()));
+    }
+}
@@ -51,6 +51,7 @@ public:
     enum Error {
         NoError = 0,
         InvalidArguments = 1,
+        InvalidXml = 2,
         UserDefinedError = 128
     };
 
@@ -100,6 +101,9 @@ public:
     virtual bool fromXml(const QString &xml);
     virtual bool fromXml(const QDomDocument &doc);
 
+    void setDeferredXml(const QString &xml, const QVariantMap &knownValues = QVariantMap());
+    QString deferredXml() const;
+
     virtual quint64 sizeHint();
 
 protected:
@@ -116,6 +120,9 @@ protected:
     void setRequiresUnreplacedVariables(bool isRequired);
     bool variableReplacement(QString *variableValue);
 
+private:
+    void loadDeferredXml() const;
+
 private:
     QString m_name;
     OperationGroup m_group;
@@ -126,6 +133,7 @@ private:
     QStringList m_delayedDeletionFiles;
     QInstaller::PackageManagerCore *m_core;
     bool m_requiresUnreplacedVariables;
+    mutable QString m_deferredXml;
 };
 
 } // namespace KDUpdater
@@ -41,7 +41,8 @@
 using namespace KDUpdater;
 
 UpdatesInfoData::UpdatesInfoData(const bool postLoadComponentScript)
-     : error(UpdatesInfo::NotYetReadError)
+    : error(UpdatesInfo::NotYetReadError)
+    , containsRepositoryUpdates(false)
     , m_postLoadComponentScript(postLoadComponentScript)
 {
 }
@@ -75,6 +76,13 @@ void UpdatesInfoData::parseFile(const QString &updateXmlFile)
                     applicationVersion = reader.readElementText();
                 } else if (reader.name() == QLatin1String("Checksum")) {
                     checkSha1CheckSum = (reader.readElementText());
+                } else if (reader.name() == QLatin1String("MetadataName")) {
+                    metadataName = reader.readElementText();
+                } else if (reader.name() == QLatin1String("SHA1")) {
+                    metadataSha1 = reader.readElementText();
+                } else if (reader.name() == QLatin1String("RepositoryUpdate")) {
+                    containsRepositoryUpdates = true;
+                    reader.skipCurrentElement();
                 } else if (reader.name() == QLatin1String("PackageUpdate")) {
                     if (!parsePackageUpdateElement(reader, checkSha1CheckSum))
                         return; //error handled in subroutine
@@ -88,6 +96,14 @@ void UpdatesInfoData::parseFile(const QString &updateXmlFile)
         }
     }
 
+    if (reader.hasError()) {
+        error = UpdatesInfo::InvalidXmlError;
+        errorMessage = tr("Parse error in %1 at %2, %3: %4").arg(updateXmlFile,
+            QString::number(reader.lineNumber()), QString::number(reader.columnNumber()),
+            reader.errorString());
+        return;
+    }
+
     if (applicationName.isEmpty()) {
         setInvalidContentError(tr("ApplicationName element is missing."));
         return;
@@ -144,6 +160,10 @@ bool UpdatesInfoData::parsePackageUpdateElement(QXmlStreamReader &reader, const
             else if (m_postLoadComponentScript)
                 postLoad = true;
 
+            // onDemand only applies to scripts that would otherwise be loaded up front.
+            if (!postLoad && attr.value(QLatin1String("onDemand")).toString().toLower() == QInstaller::scTrue)
+                scriptHash.insert(QLatin1String("onDemand"), true);
+
             if (postLoad)
                 scriptHash.insert(QLatin1String("postLoadScript"), reader.readElementText());
             else
@@ -260,6 +280,11 @@ bool UpdatesInfo::isValid() const
     return d->error == NoError;
 }
 
+UpdatesInfo::Error UpdatesInfo::error() const
+{
+    return static_cast<Error>(d->error);
+}
+
 QString UpdatesInfo::errorString() const
 {
     return d->errorMessage;
@@ -270,8 +295,14 @@ void UpdatesInfo::setFileName(const QString &updateXmlFile)
     if (d->updateXmlFile == updateXmlFile)
         return;
 
+    d->error = NotYetReadError;
+    d->errorMessage.clear();
     d->applicationName.clear();
     d->applicationVersion.clear();
+    d->checkSha1CheckSum.clear();
+    d->metadataName.clear();
+    d->metadataSha1.clear();
+    d->containsRepositoryUpdates = false;
     d->updateInfoList.clear();
 
     d->updateXmlFile = updateXmlFile;
@@ -302,6 +333,21 @@ QString UpdatesInfo::checkSha1CheckSum() const
     return d->checkSha1CheckSum;
 }
 
+QString UpdatesInfo::metadataName() const
+{
+    return d->metadataName;
+}
+
+QString UpdatesInfo::metadataSha1() const
+{
+    return d->metadataSha1;
+}
+
+bool UpdatesInfo::containsRepositoryUpdates() const
+{
+    return d->containsRepositoryUpdates;
+}
+
 int UpdatesInfo::updateInfoCount() const
 {
     return d->updateInfoList.count();
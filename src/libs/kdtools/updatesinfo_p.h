@@ -75,6 +75,9 @@ public:
     QString applicationVersion() const;
 
     QString checkSha1CheckSum() const;
+    QString metadataName() const;
+    QString metadataSha1() const;
+    bool containsRepositoryUpdates() const;
 
     int updateInfoCount() const;
     UpdateInfo updateInfo(int index) const;
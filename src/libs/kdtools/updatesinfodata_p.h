@@ -52,6 +52,9 @@ public:
     QString applicationName;
     QString applicationVersion;
     QString checkSha1CheckSum;
+    QString metadataName;
+    QString metadataSha1;
+    bool containsRepositoryUpdates;
     QList<UpdateInfo> updateInfoList;
     bool m_postLoadComponentScript;
 
@@ -0,0 +1,256 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "versionkey.h"
+
+using namespace KDUpdater;
+
+/*!
+    \class KDUpdater::VersionKey
+    \inmodule kdupdater
+    \brief The VersionKey class is a version string that is split into its components once.
+
+    The components of the version are separated by \c{.}, \c{-} or \c{_}. Numeric components
+    are converted to numbers when the key is constructed, so that comparing keys with
+    compare() does not allocate memory. The ordering is the one of compareVersion().
+*/
+
+/*!
+    \fn KDUpdater::VersionKey::VersionKey()
+
+    Constructs an empty version key.
+*/
+
+/*!
+    \fn bool KDUpdater::VersionKey::isEmpty() const
+
+    Returns \c true if the version string is empty.
+*/
+
+/*!
+    \fn QString KDUpdater::VersionKey::toString() const
+
+    Returns the version string the key was constructed from.
+*/
+
+namespace {
+
+enum SegmentOrder {
+    SegmentLess = -1,
+    SegmentEqual = 0,
+    SegmentGreater = 1,
+    SegmentWildcard
+};
+
+bool isSeparator(QChar c)
+{
+    return c == QLatin1Char('.') || c == QLatin1Char('-') || c == QLatin1Char('_');
+}
+
+bool toNumber(QStringView segment, qint64 *number)
+{
+    // Fast path for the common case of plain digits that cannot overflow.
+    if (!segment.isEmpty() && segment.size() <= 18) {
+        qint64 value = 0;
+        bool plainDigits = true;
+        for (const QChar c : segment) {
+            if (c < QLatin1Char('0') || c > QLatin1Char('9')) {
+                plainDigits = false;
+                break;
+            }
+            value = value * 10 + (c.unicode() - '0');
+        }
+        if (plainDigits) {
+            *number = value;
+            return true;
+        }
+    }
+    // Keep the exact semantics of QString::toLongLong() for everything else.
+    bool ok = false;
+    *number = segment.toLongLong(&ok);
+    return ok;
+}
+
+bool isWildcard(QStringView segment)
+{
+    return segment.size() == 1 && segment.at(0) == QLatin1Char('x');
+}
+
+SegmentOrder compareSegments(QStringView s1, bool isNumber1, qint64 number1,
+    QStringView s2, bool isNumber2, qint64 number2)
+{
+    while (true) {
+        if ((!isNumber1 && isWildcard(s1)) || (!isNumber2 && isWildcard(s2)))
+            return SegmentWildcard;
+
+        if (!isNumber1 && !isNumber2) {
+            // try remove equal start
+            qsizetype i = 0;
+            while (i < s1.size() && i < s2.size() && s1.at(i) == s2.at(i))
+                ++i;
+            if (i > 0) {
+                s1 = s1.mid(i);
+                s2 = s2.mid(i);
+                isNumber1 = toNumber(s1, &number1);
+                isNumber2 = toNumber(s2, &number2);
+                continue; // compare again
+            }
+        }
+
+        if (!isNumber1 || !isNumber2) {
+            const int res = s1.compare(s2);
+            if (res == 0)
+                return SegmentEqual;
+            return res > 0 ? SegmentGreater : SegmentLess;
+        }
+
+        if (number1 < number2)
+            return SegmentLess;
+        if (number1 > number2)
+            return SegmentGreater;
+        return SegmentEqual;
+    }
+}
+
+} // namespace
+
+/*!
+    Constructs a version key from \a version.
+*/
+VersionKey::VersionKey(const QString &version)
+    : m_version(version)
+{
+    int start = 0;
+    const int size = int(version.size());
+    for (int i = 0; i <= size; ++i) {
+        if (i < size && !isSeparator(version.at(i)))
+            continue;
+        Segment segment;
+        segment.start = start;
+        segment.length = i - start;
+        segment.isNumber = toNumber(QStringView(version).mid(start, segment.length),
+            &segment.number);
+        m_segments.append(segment);
+        start = i + 1;
+    }
+}
+
+/*!
+    Compares the versions \a v1 and \a v2 and returns \c -1 if \a v1 is lower than \a v2,
+    \c +1 if it is higher, and \c 0 if the versions are equal or match because of an
+    \c x wildcard component.
+
+    \sa compareVersion()
+*/
+int VersionKey::compare(const VersionKey &v1, const VersionKey &v2)
+{
+    if (v1.m_version == v2.m_version)
+        return 0;
+
+    const QStringView view1(v1.m_version);
+    const QStringView view2(v2.m_version);
+    const qsizetype count1 = v1.m_segments.size();
+    const qsizetype count2 = v2.m_segments.size();
+    for (qsizetype index = 0; index < count1 || index < count2; ++index) {
+        if (index == count1)
+            return v2.m_segments.at(index).isNumber ? -1 : +1;
+        if (index == count2)
+            return v1.m_segments.at(index).isNumber ? +1 : -1;
+
+        const Segment &s1 = v1.m_segments.at(index);
+        const Segment &s2 = v2.m_segments.at(index);
+        const SegmentOrder order = compareSegments(view1.mid(s1.start, s1.length), s1.isNumber,
+            s1.number, view2.mid(s2.start, s2.length), s2.isNumber, s2.number);
+        if (order == SegmentWildcard)
+            return 0;
+        if (order != SegmentEqual)
+            return order;
+    }
+    return 0;
+}
+
+/*!
+    \class KDUpdater::VersionRequirement
+    \inmodule kdupdater
+    \brief The VersionRequirement class matches versions against a version requirement.
+
+    A requirement is a version number that can be prefixed by the comparators \c{>},
+    \c{>=}, \c{<}, \c{<=} and \c{=}. The requirement is parsed once, so that matching a
+    version with matches() does not allocate memory.
+*/
+
+/*!
+    \fn KDUpdater::VersionRequirement::VersionRequirement()
+
+    Constructs an empty requirement that only matches an empty version.
+*/
+
+/*!
+    \fn QString KDUpdater::VersionRequirement::version() const
+
+    Returns the version of the requirement without the comparators.
+*/
+
+/*!
+    Constructs a version requirement from \a requirement.
+*/
+VersionRequirement::VersionRequirement(const QString &requirement)
+{
+    qsizetype i = 0;
+    while (i < requirement.size() && (requirement.at(i) == QLatin1Char('<')
+            || requirement.at(i) == QLatin1Char('=') || requirement.at(i) == QLatin1Char('>'))) {
+        ++i;
+    }
+    if (i == 0) {
+        m_version = VersionKey(requirement);
+        return;
+    }
+
+    const QStringView comparator = QStringView(requirement).left(i);
+    m_allowEqual = comparator.contains(QLatin1Char('='));
+    m_allowLess = comparator.contains(QLatin1Char('<'));
+    m_allowMore = comparator.contains(QLatin1Char('>'));
+    m_version = VersionKey(requirement.mid(i));
+}
+
+/*!
+    Returns \c true if \a version matches the requirement.
+*/
+bool VersionRequirement::matches(const VersionKey &version) const
+{
+    if (m_allowEqual && version.toString() == m_version.toString())
+        return true;
+
+    if (m_allowLess && VersionKey::compare(m_version, version) > 0)
+        return true;
+
+    if (m_allowMore && VersionKey::compare(m_version, version) < 0)
+        return true;
+
+    return false;
+}
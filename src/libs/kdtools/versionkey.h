@@ -0,0 +1,81 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#ifndef VERSIONKEY_H
+#define VERSIONKEY_H
+
+#include "kdtoolsglobal.h"
+
+#include <QString>
+#include <QVarLengthArray>
+
+namespace KDUpdater {
+
+class KDTOOLS_EXPORT VersionKey
+{
+public:
+    VersionKey() = default;
+    explicit VersionKey(const QString &version);
+
+    bool isEmpty() const { return m_version.isEmpty(); }
+    QString toString() const { return m_version; }
+
+    static int compare(const VersionKey &v1, const VersionKey &v2);
+
+private:
+    struct Segment
+    {
+        int start;
+        int length;
+        qint64 number;
+        bool isNumber;
+    };
+
+    QString m_version;
+    QVarLengthArray<Segment, 6> m_segments;
+};
+
+class KDTOOLS_EXPORT VersionRequirement
+{
+public:
+    VersionRequirement() = default;
+    explicit VersionRequirement(const QString &requirement);
+
+    QString version() const { return m_version.toString(); }
+    bool matches(const VersionKey &version) const;
+
+private:
+    VersionKey m_version;
+    bool m_allowEqual = true;
+    bool m_allowLess = false;
+    bool m_allowMore = false;
+};
+
+} // namespace KDUpdater
+
+#endif // VERSIONKEY_H
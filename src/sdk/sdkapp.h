@@ -48,6 +48,8 @@
 #include <errors.h>
 #include <loggingutils.h>
 #include <scriptengine.h>
+#include <phasetracer.h>
+#include <scriptprofiler.h>
 
 #include <QApplication>
 #include <QDir>
@@ -82,8 +84,27 @@ public:
 
     virtual ~SDKApp()
     {
-        foreach (const QByteArray &ba, m_resourceMappings)
-            QResource::unregisterResource((const uchar*) ba.data(), QLatin1String(":/metadata"));
+        // Phases and script calls share one trace, written to every requested file.
+        QJsonObject traceExtra;
+        QStringList traceFiles;
+        if (!m_traceFile.isEmpty())
+            traceFiles.append(m_traceFile);
+        if (!m_scriptProfileFile.isEmpty()) {
+            traceExtra.insert(QLatin1String("scriptProfile"),
+                QInstaller::ScriptProfiler::instance().summary());
+            if (m_scriptProfileFile != m_traceFile)
+                traceFiles.append(m_scriptProfileFile);
+        }
+        foreach (const QString &traceFile, traceFiles) {
+            try {
+                QInstaller::PhaseTracer::instance().writeTrace(traceFile, traceExtra);
+            } catch (const QInstaller::Error &e) {
+                qCWarning(QInstaller::lcInstallerInstallLog) << "Cannot write trace file:"
+                    << e.message();
+            }
+        }
+        foreach (const uchar *data, m_registeredResources)
+            QResource::unregisterResource(data, QLatin1String(":/metadata"));
     }
 
     bool notify(QObject *receiver, QEvent *event)
@@ -103,6 +124,12 @@ public:
     bool init(QString &errorMessage) {
         QString appname = qApp->applicationName();
 
+        // Enable tracing first, so that reading the binary content is recorded as well.
+        if (m_parser.isSet(CommandLineOptions::scTraceFileLong)) {
+            m_traceFile = m_parser.value(CommandLineOptions::scTraceFileLong);
+            QInstaller::PhaseTracer::instance().setEnabled(true);
+        }
+
         QFile binary(binaryFile());
     #ifdef Q_OS_WIN
         // On some admin user installations it is possible that the installer.dat
@@ -125,8 +152,11 @@ public:
         QInstaller::ResourceCollectionManager manager;
         QList<QInstaller::OperationBlob> oldOperations;
 
-        QInstaller::BinaryContent::readBinaryContent(&binary, &oldOperations, &manager, &magicMarker,
-            cookie);
+        {
+            QInstaller::PhaseTracer::Scope trace("Read binary content");
+            QInstaller::BinaryContent::readBinaryContent(&binary, &oldOperations, &manager,
+                &magicMarker, cookie);
+        }
         // Usually resources simply get mapped into memory and therefore the file does not need to be
         // kept open during application runtime. Though in case of offline installers we need to access
         // the appended binary content (packages etc.), so we close only in maintenance mode.
@@ -179,8 +209,18 @@ public:
 
         dumpResourceTree();
 
-        SDKApp::registerMetaResources(manager.collectionByName("QResources"));
-        QInstaller::BinaryFormatEngineHandler::instance()->registerResources(manager.collections());
+#ifdef Q_OS_WIN
+        // A mapped file cannot be replaced on Windows, the maintenance tool rewrites its own
+        // data file, so only the installer maps its resources.
+        const bool mapResources = (magicMarker == QInstaller::BinaryContent::MagicInstallerMarker);
+#else
+        const bool mapResources = true;
+#endif
+        {
+            QInstaller::PhaseTracer::Scope trace("Register resources");
+            SDKApp::registerMetaResources(manager.collectionByName("QResources"), mapResources);
+            QInstaller::BinaryFormatEngineHandler::instance()->registerResources(manager.collections());
+        }
 
         const QHash<QString, QString> userArgs = userArguments();
         if (m_parser.isSet(CommandLineOptions::scStartClientLong)) {
@@ -376,6 +416,21 @@ public:
             QInstaller::PackageManagerCore::setMaxConcurrentOperations(count);
         }
 
+        if (m_parser.isSet(CommandLineOptions::scScriptProfileThresholdLong)) {
+            bool isValid;
+            const qint64 threshold = m_parser.value(CommandLineOptions::scScriptProfileThresholdLong)
+                .toLongLong(&isValid);
+            if (!isValid || threshold < 0) {
+                errorMessage = QObject::tr("Invalid value for 'script-profile-threshold'.");
+                return false;
+            }
+            QInstaller::ScriptProfiler::instance().setThreshold(threshold);
+        }
+        if (m_parser.isSet(CommandLineOptions::scScriptProfileLong)) {
+            m_scriptProfileFile = m_parser.value(CommandLineOptions::scScriptProfileLong);
+            QInstaller::PhaseTracer::instance().setEnabled(true, QInstaller::PhaseTracer::Script);
+        }
+
         if (m_parser.isSet(CommandLineOptions::scAcceptLicensesLong))
             m_core->setAutoAcceptLicenses();
 
@@ -519,9 +574,14 @@ public:
         return QString();
     }
 
-    void registerMetaResources(const QInstaller::ResourceCollection &collection)
+    void registerMetaResources(const QInstaller::ResourceCollection &collection, bool mapFromFile)
     {
         foreach (const QSharedPointer<QInstaller::Resource> &resource, collection.resources()) {
+            // Map the resource directly from the file, the pages are only read when
+            // the resource tree is accessed.
+            if (mapFromFile && registerMappedResource(*resource))
+                continue;
+
             const bool isOpen = resource->isOpen();
             if ((!isOpen) && (!resource->open()))
                 continue;
@@ -533,14 +593,43 @@ public:
             if (ba.isEmpty())
                 continue;
 
-            if (QResource::registerResource((const uchar*) ba.data(), QLatin1String(":/metadata")))
+            if (QResource::registerResource((const uchar*) ba.data(), QLatin1String(":/metadata"))) {
                 m_resourceMappings.append(ba);
+                m_registeredResources.append((const uchar*) ba.data());
+            }
 
             if (!isOpen) // If we reach that point, either the resource was opened already...
                 resource->close();           // or we did open it and have to close it again.
         }
     }
 
+    bool registerMappedResource(const QInstaller::Resource &resource)
+    {
+        const Range<qint64> segment = resource.segment();
+        if (segment.length() <= 0)
+            return false;
+
+        QSharedPointer<QFile> file(new QFile(resource.fileName()));
+        if (!file->open(QIODevice::ReadOnly))
+            return false;
+
+        uchar *data = file->map(segment.start(), segment.length());
+        if (!data) {
+            qCDebug(QInstaller::lcInstallerInstallLog) << "Cannot map resource"
+                << resource.name() << "from" << file->fileName() << ":" << file->errorString();
+            return false;
+        }
+
+        if (!QResource::registerResource(data, QLatin1String(":/metadata"))) {
+            file->unmap(data);
+            return false;
+        }
+        // The mapping stays valid as long as the file is open
+        m_mappedResourceFiles.append(file);
+        m_registeredResources.append(data);
+        return true;
+    }
+
     QStringList repositories(const QString &list) const
     {
         const QStringList items = list.split(QLatin1Char(','), Qt::SkipEmptyParts);
@@ -617,11 +706,15 @@ public:
 
 private:
     QList<QByteArray> m_resourceMappings;
+    QList<QSharedPointer<QFile>> m_mappedResourceFiles;
+    QList<const uchar *> m_registeredResources;
 
 public:
     RunOnceChecker m_runCheck;
     QInstaller::PackageManagerCore *m_core;
     CommandLineParser m_parser;
+    QString m_scriptProfileFile;
+    QString m_traceFile;
 };
 
 #endif  // SDKAPP_H
@@ -0,0 +1,158 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include <archivecache.h>
+#include <fileutils.h>
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QTest>
+
+using namespace QInstaller;
+
+class tst_archivecache : public QObject
+{
+    Q_OBJECT
+
+private:
+    QByteArray createArchive(const QString &fileName, const QByteArray &content)
+    {
+        QFile file(m_downloadPath + QDir::separator() + fileName);
+        if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size())
+            return QByteArray();
+        return QCryptographicHash::hash(content, QCryptographicHash::Sha1).toHex();
+    }
+
+private slots:
+    void init()
+    {
+        m_cachePath = generateTemporaryFileName();
+        m_downloadPath = generateTemporaryFileName();
+        QVERIFY(QDir().mkpath(m_downloadPath));
+    }
+
+    void cleanup()
+    {
+        if (QFileInfo::exists(m_cachePath))
+            QInstaller::removeDirectory(m_cachePath, true);
+        if (QFileInfo::exists(m_downloadPath))
+            QInstaller::removeDirectory(m_downloadPath, true);
+    }
+
+    void testInsertAndLookup()
+    {
+        const QByteArray checksum = createArchive("1.0.0content.7z", "content");
+        QVERIFY(!checksum.isEmpty());
+
+        QString cachedPath;
+        {
+            ArchiveCache cache(m_cachePath);
+            QVERIFY(cache.isValid());
+            QVERIFY(cache.archive(checksum).isEmpty());
+
+            QVERIFY(cache.insertArchive(m_downloadPath + "/1.0.0content.7z", checksum, &cachedPath));
+            QVERIFY(!QFileInfo::exists(m_downloadPath + "/1.0.0content.7z"));
+            QCOMPARE(QFileInfo(cachedPath).fileName(), QLatin1String("1.0.0content.7z"));
+            QCOMPARE(cache.archive(checksum), cachedPath);
+            QCOMPARE(cache.size(), qint64(7));
+        }
+
+        // A new session finds the archive stored by the previous one
+        ArchiveCache cache(m_cachePath);
+        QVERIFY(cache.isValid());
+        const QString archive = cache.archive(checksum);
+        QCOMPARE(QFileInfo(archive).fileName(), QLatin1String("1.0.0content.7z"));
+
+        QFile file(archive);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll(), QByteArray("content"));
+        file.close();
+
+        QVERIFY(cache.clear());
+    }
+
+    void testInsertFailsOnInvalidCache()
+    {
+        const QByteArray checksum = createArchive("1.0.0content.7z", "content");
+
+        ArchiveCache cache;
+        QString cachedPath;
+        QVERIFY(!cache.insertArchive(m_downloadPath + "/1.0.0content.7z", checksum, &cachedPath));
+        QVERIFY(QFileInfo::exists(m_downloadPath + "/1.0.0content.7z"));
+        QVERIFY(cachedPath.isEmpty());
+    }
+
+    void testEvictLeastRecentlyUsed()
+    {
+        const QByteArray oldChecksum = createArchive("old.7z", QByteArray(100, 'o'));
+        const QByteArray newChecksum = createArchive("new.7z", QByteArray(100, 'n'));
+        const QByteArray usedChecksum = createArchive("used.7z", QByteArray(100, 'u'));
+
+        {
+            ArchiveCache cache(m_cachePath);
+            QVERIFY(cache.insertArchive(m_downloadPath + "/old.7z", oldChecksum, nullptr));
+            QVERIFY(cache.insertArchive(m_downloadPath + "/new.7z", newChecksum, nullptr));
+            QVERIFY(cache.insertArchive(m_downloadPath + "/used.7z", usedChecksum, nullptr));
+
+            const QDateTime now = QDateTime::currentDateTime();
+            cache.itemByChecksum(oldChecksum)->setLastUsed(now.addDays(-2));
+            cache.itemByChecksum(newChecksum)->setLastUsed(now.addDays(-1));
+            cache.itemByChecksum(usedChecksum)->setLastUsed(now.addDays(-3));
+        }
+
+        ArchiveCache cache(m_cachePath);
+        QCOMPARE(cache.size(), qint64(300));
+        // Archives used in the current session are never evicted
+        QVERIFY(!cache.archive(usedChecksum).isEmpty());
+
+        cache.evict(200);
+        QVERIFY(!cache.itemByChecksum(oldChecksum));
+        QVERIFY(cache.itemByChecksum(newChecksum));
+        QVERIFY(cache.itemByChecksum(usedChecksum));
+        QCOMPARE(cache.size(), qint64(200));
+
+        cache.evict(0);
+        QVERIFY(!cache.itemByChecksum(newChecksum));
+        QVERIFY(cache.itemByChecksum(usedChecksum));
+        QCOMPARE(cache.size(), qint64(100));
+
+        QVERIFY(cache.clear());
+    }
+
+private:
+    QString m_cachePath;
+    QString m_downloadPath;
+};
+
+QTEST_MAIN(tst_archivecache)
+
+#include "tst_archivecache.moc"
@@ -0,0 +1,3 @@
+include(../../qttest.pri)
+
+SOURCES += tst_binarydelta.cpp
@@ -0,0 +1,174 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include <binarydelta.h>
+#include <errors.h>
+#include <fileutils.h>
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QTest>
+
+using namespace QInstaller;
+
+class tst_binarydelta : public QObject
+{
+    Q_OBJECT
+
+private:
+    QString writeFile(const QString &fileName, const QByteArray &content)
+    {
+        QFile file(m_path + QDir::separator() + fileName);
+        if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size())
+            return QString();
+        return file.fileName();
+    }
+
+    QByteArray randomData(qint64 size, quint32 seed)
+    {
+        QRandomGenerator generator(seed);
+        QByteArray data(size, Qt::Uninitialized);
+        for (qint64 i = 0; i < size; ++i)
+            data[i] = char(generator.bounded(256));
+        return data;
+    }
+
+private slots:
+    void init()
+    {
+        m_path = generateTemporaryFileName();
+        QVERIFY(QDir().mkpath(m_path));
+    }
+
+    void cleanup()
+    {
+        QInstaller::removeDirectory(m_path, true);
+    }
+
+    void testRoundTrip_data()
+    {
+        QTest::addColumn<QByteArray>("base");
+        QTest::addColumn<QByteArray>("target");
+
+        const QByteArray data = randomData(512 * 1024, 1);
+        QByteArray inserted = data;
+        inserted.insert(200 * 1024, randomData(3000, 2));
+        QByteArray modified = data;
+        modified.replace(100 * 1024, 10, QByteArray(10, 'x'));
+
+        QTest::newRow("identical") << data << data;
+        QTest::newRow("inserted") << data << inserted;
+        QTest::newRow("modified") << data << modified;
+        QTest::newRow("truncated") << data << data.left(300 * 1024);
+        QTest::newRow("unrelated") << data << randomData(100 * 1024, 3);
+        QTest::newRow("empty base") << QByteArray() << data;
+        QTest::newRow("empty target") << data << QByteArray();
+
+        // Files are read in blocks of 1 MiB, chunks and inserts span the block boundaries.
+        const QByteArray large = randomData(3 * 1024 * 1024 + 100, 7);
+        QByteArray largeInserted = large;
+        largeInserted.insert(1024 * 1024 - 10, randomData(3000, 8));
+        QTest::newRow("larger than a block") << large << largeInserted;
+        QTest::newRow("unrelated larger than a block") << data << large;
+    }
+
+    void testRoundTrip()
+    {
+        QFETCH(QByteArray, base);
+        QFETCH(QByteArray, target);
+
+        const QString baseFile = writeFile("base.7z", base);
+        const QString targetFile = writeFile("target.7z", target);
+        const QString deltaFile = m_path + "/target.7z.delta";
+        const QString resultFile = m_path + "/result.7z";
+
+        BinaryDelta::create(baseFile, targetFile, deltaFile);
+        const QByteArray checksum = BinaryDelta::apply(baseFile, deltaFile, resultFile);
+
+        QCOMPARE(checksum, QCryptographicHash::hash(target, QCryptographicHash::Sha1).toHex());
+        QFile result(resultFile);
+        QVERIFY(result.open(QIODevice::ReadOnly));
+        QCOMPARE(result.readAll(), target);
+    }
+
+    void testDeltaIsSmall()
+    {
+        const QByteArray base = randomData(1024 * 1024, 4);
+        QByteArray target = base;
+        target.insert(500 * 1024, randomData(1000, 5));
+
+        const QString deltaFile = m_path + "/target.7z.delta";
+        BinaryDelta::create(writeFile("base.7z", base), writeFile("target.7z", target), deltaFile);
+        QVERIFY(QFileInfo(deltaFile).size() < 200 * 1024);
+    }
+
+    void testApplyToWrongBase()
+    {
+        const QByteArray base = randomData(100 * 1024, 6);
+        const QString baseFile = writeFile("base.7z", base);
+        QByteArray target = base;
+        target.append(randomData(1024, 7));
+        const QString deltaFile = m_path + "/target.7z.delta";
+        BinaryDelta::create(baseFile, writeFile("target.7z", target), deltaFile);
+
+        // Same size, different content
+        const QString otherFile = writeFile("other.7z", randomData(100 * 1024, 8));
+        try {
+            BinaryDelta::apply(otherFile, deltaFile, m_path + "/result.7z");
+            QFAIL("Applied delta to a base file with different content.");
+        } catch (const Error &) {}
+
+        // Different size
+        const QString shortFile = writeFile("short.7z", base.left(1024));
+        try {
+            BinaryDelta::apply(shortFile, deltaFile, m_path + "/result.7z");
+            QFAIL("Applied delta to a base file with different size.");
+        } catch (const Error &) {}
+    }
+
+    void testApplyInvalidDelta()
+    {
+        const QString baseFile = writeFile("base.7z", randomData(1024, 9));
+        const QString deltaFile = writeFile("target.7z.delta", "not a delta");
+        try {
+            BinaryDelta::apply(baseFile, deltaFile, m_path + "/result.7z");
+            QFAIL("Applied an invalid delta.");
+        } catch (const Error &) {}
+    }
+
+private:
+    QString m_path;
+};
+
+QTEST_MAIN(tst_binarydelta)
+
+#include "tst_binarydelta.moc"
@@ -74,12 +74,14 @@ private slots:
         TestOperation op(QLatin1String("Operation 1"));
         op.setValue(QLatin1String("key"), QLatin1String("Operation 1 value."));
         op.setArguments(QStringList() << QLatin1String("arg1") << QLatin1String("arg2"));
-        m_operations.append(OperationBlob(op.name(), op.toXml().toString()));
+        m_operations.append(OperationBlob(op.name(), op.toXml().toString(),
+            QLatin1String("Component 1")));
 
         op = TestOperation(QLatin1String("Operation 2"));
         op.setValue(QLatin1String("key"), QLatin1String("Operation 2 value."));
         op.setArguments(QStringList() << QLatin1String("arg1") << QLatin1String("arg2"));
-        m_operations.append(OperationBlob(op.name(), op.toXml().toString()));
+        m_operations.append(OperationBlob(op.name(), op.toXml().toString(),
+            QLatin1String("Component 2")));
     }
 
     void findMagicCookieSmallFile()
@@ -168,6 +170,9 @@ private slots:
             QInstaller::appendString(&binary, operation.xml);
         }
         QInstaller::appendInt64(&binary, layout.operationsCount);
+        QInstaller::appendInt64(&binary, BinaryContent::MagicOperationIndexMarker);
+        foreach (const OperationBlob &operation, m_operations)
+            QInstaller::appendString(&binary, operation.component);
         end = binary.pos();
         layout.operationsSegment = Range<qint64>::fromStartAndEnd(start, end);
 
@@ -290,6 +295,10 @@ private slots:
         layout.operationsCount = QInstaller::retrieveInt64(&binary);
         QCOMPARE(layout.operationsCount, m_layout.operationsCount);
 
+        QCOMPARE(QInstaller::retrieveInt64(&binary), BinaryContent::MagicOperationIndexMarker);
+        for (int i = 0; i < layout.operationsCount; ++i)
+            QCOMPARE(m_operations.at(i).component, QInstaller::retrieveString(&binary));
+
         layout.collectionCount = QInstaller::retrieveInt64(&binary);
         QCOMPARE(layout.collectionCount, m_layout.collectionCount);
 
@@ -365,10 +374,23 @@ private slots:
         for (int i = 0; i < collection.resources().count(); ++i)
             QCOMPARE(collection.resources().at(i)->segment(), m_layout.metaResourceSegments.at(i));
 
+        // the meta resources can be mapped directly from the file they are stored in
+        const QSharedPointer<Resource> resource = collection.resources().first();
+        QFile mappedFile(resource->fileName());
+        QInstaller::openForRead(&mappedFile);
+        const uchar *data = mappedFile.map(resource->segment().start(), resource->segment().length());
+        QVERIFY(data);
+        QCOMPARE(resource->open(), true);
+        QCOMPARE(QByteArray(reinterpret_cast<const char *>(data), resource->segment().length()),
+            resource->readAll());
+        resource->close();
+        mappedFile.close();
+
         QCOMPARE(operations.count(), m_operations.count());
         for (int i = 0; i < operations.count(); ++i) {
             QCOMPARE(operations.at(i).name, m_operations.at(i).name);
             QCOMPARE(operations.at(i).xml, m_operations.at(i).xml);
+            QCOMPARE(operations.at(i).component, m_operations.at(i).component);
         }
 
         QCOMPARE(manager.collectionCount(), m_manager.collectionCount());
@@ -427,6 +449,46 @@ private slots:
         QCOMPARE(op.value(QLatin1String("variant_map")).metaType().id(), QMetaType::QVariantMap);
     }
 
+    void testDeferredXmlLoading()
+    {
+        const OperationBlob &blob = m_operations.first();
+
+        TestOperation op(blob.name);
+        QVariantMap knownValues;
+        knownValues.insert(QLatin1String("component"), blob.component);
+        op.setDeferredXml(blob.xml, knownValues);
+
+        // known values do not require parsing
+        QCOMPARE(op.value(QLatin1String("component")).toString(), blob.component);
+        QCOMPARE(op.deferredXml(), blob.xml);
+
+        // any other access restores the operation from its XML
+        QCOMPARE(op.arguments(), QStringList() << QLatin1String("arg1") << QLatin1String("arg2"));
+        QCOMPARE(op.value(QLatin1String("key")).toString(), QLatin1String("Operation 1 value."));
+        QVERIFY(op.deferredXml().isEmpty());
+    }
+
+    void testDeferredXmlMalformed()
+    {
+        const OperationBlob &blob = m_operations.first();
+
+        TestOperation op(blob.name);
+        QVariantMap knownValues;
+        knownValues.insert(QLatin1String("component"), blob.component);
+        const QString xml = blob.xml.left(blob.xml.size() / 2);
+        op.setDeferredXml(xml, knownValues);
+
+        // the XML is stored as is, known values stay accessible
+        QCOMPARE(op.deferredXml(), xml);
+        QCOMPARE(op.value(QLatin1String("component")).toString(), blob.component);
+
+        // the malformed XML is reported once the operation is restored
+        QCOMPARE(op.error(), int(KDUpdater::UpdateOperation::InvalidXml));
+        QVERIFY(!op.errorString().isEmpty());
+        QVERIFY(op.arguments().isEmpty());
+        QVERIFY(op.deferredXml().isEmpty());
+    }
+
     void cleanupTestCase()
     {
         m_manager.clear();
@@ -49,6 +49,8 @@
 #include <QTemporaryFile>
 #include <QUuid>
 #include <QLocalServer>
+#include <QSemaphore>
+#include <QThread>
 
 using namespace QInstaller;
 
@@ -61,6 +63,14 @@ public:
     ~MyRemoteObject() = default;
 
     bool connectToServer() { return RemoteObject::connectToServer(); }
+
+    QList<QVariantList> m_receivedSignals;
+
+protected:
+    void processSignals(const QVariantList &receivedSignals) override
+    {
+        m_receivedSignals.append(receivedSignals);
+    }
 };
 
 class tst_ClientServer : public QObject
@@ -312,6 +322,62 @@ private slots:
         delete object;
     }
 
+    void testSignalsReadWithReply()
+    {
+        // The server sends the reply to a call and a signals packet in a single write, so
+        // that the client receives both while it waits for the reply.
+        const QString socketName = QUuid::createUuid().toString();
+        QSemaphore listening;
+        QScopedPointer<QThread> serverThread(QThread::create([this, socketName, &listening] {
+            QLocalServer server;
+            server.listen(socketName);
+            listening.release();
+            if (!server.waitForNewConnection(30000))
+                return;
+
+            QLocalSocket *socket = server.nextPendingConnection();
+            QByteArray command;
+            QByteArray data;
+            forever {
+                while (!receivePacket(socket, &command, &data)) {
+                    if (!socket->waitForReadyRead(30000))
+                        return;
+                }
+                QByteArray packets;
+                QBuffer buffer(&packets);
+                buffer.open(QIODevice::WriteOnly);
+                if (command == Protocol::Create) {
+                    sendCommand(&buffer, Protocol::Reply, QString::fromLatin1(Protocol::DefaultReply));
+                } else {
+                    sendCommand(&buffer, Protocol::Reply, true);
+                    if (command != Protocol::Authorize) {
+                        sendCommand(&buffer, Protocol::Signals, QVariantList()
+                            << QLatin1String("finished") << 0);
+                    }
+                }
+                socket->write(packets);
+                socket->waitForBytesWritten(30000);
+            }
+        }));
+        serverThread->start();
+        listening.acquire();
+
+        RemoteClient::instance().init(socketName, QLatin1String("SomeKey"), Protocol::Mode::Debug,
+                                      Protocol::StartAs::User);
+        {
+            MyRemoteObject object;
+            QVERIFY(object.connectToServer());
+            QVERIFY(object.callRemoteMethod<bool>(QLatin1String("SignalsAfterReply")));
+
+            // Signals are emitted once control returns to the event loop.
+            QVERIFY(object.m_receivedSignals.isEmpty());
+            QTRY_COMPARE(object.m_receivedSignals.count(), 1);
+            QCOMPARE(object.m_receivedSignals.first(), QVariantList()
+                << QLatin1String("finished") << 0);
+        }
+        QVERIFY(serverThread->wait(30000));
+    }
+
     void testQSettingsWrapper_data()
     {
         QTest::addColumn<QSettings::Format>("format");
@@ -551,10 +617,10 @@ private slots:
             QCOMPARE(int(wrapper.state()), int(QProcessWrapper::NotRunning));
             QCOMPARE(wrapper.readAll().trimmed(), QByteArray("Mega test output!"));
 
-            QTest::qWait(500);
-
+            // Signals are pushed by the server and emitted once control returns to the event loop.
+            QCOMPARE(spy.count(), 0);
+            QTRY_COMPARE(spy2.count(), 1);
             QCOMPARE(spy.count(), 1);
-            QCOMPARE(spy2.count(), 1);
             QList<QVariant> arguments = spy2.takeFirst();
             QCOMPARE(arguments.first().toInt(), 0);
             QCOMPARE(arguments.last().toInt(), int(QProcessWrapper::NormalExit));
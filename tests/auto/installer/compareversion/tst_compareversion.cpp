@@ -27,9 +27,74 @@
 **************************************************************************/
 
 #include "updater.h"
+#include "versionkey.h"
 
+#include <QRegularExpression>
 #include <QTest>
 
+// The former string based implementation, kept as reference for the pre-parsed keys
+static int referenceCompareVersion(const QString &v1, const QString &v2)
+{
+    if (v1 == v2)
+        return 0;
+
+    static const QRegularExpression regex(QLatin1String("\\.|-|_"));
+    QStringList v1_comps = v1.split(regex);
+    QStringList v2_comps = v2.split(regex);
+
+    int index = 0;
+    while (true) {
+        bool v1_ok = false;
+        bool v2_ok = false;
+
+        if (index == v1_comps.count() && index < v2_comps.count()) {
+            v2_comps.at(index).toLongLong(&v2_ok);
+            return v2_ok ? -1 : +1;
+        }
+        if (index < v1_comps.count() && index == v2_comps.count()) {
+            v1_comps.at(index).toLongLong(&v1_ok);
+            return v1_ok ? +1 : -1;
+        }
+        if (index >= v1_comps.count() || index >= v2_comps.count())
+            break;
+
+        qlonglong v1_comp = v1_comps.at(index).toLongLong(&v1_ok);
+        qlonglong v2_comp = v2_comps.at(index).toLongLong(&v2_ok);
+
+        if (!v1_ok && v1_comps.at(index) == QLatin1String("x"))
+            return 0;
+        if (!v2_ok && v2_comps.at(index) == QLatin1String("x"))
+            return 0;
+        if (!v1_ok && !v2_ok) {
+            int i = 0;
+            while (i < v1_comps.at(index).size() && i < v2_comps.at(index).size()
+                && v1_comps.at(index).at(i) == v2_comps.at(index).at(i)) {
+                ++i;
+            }
+            if (i > 0) {
+                v1_comps[index] = v1_comps.at(index).mid(i);
+                v2_comps[index] = v2_comps.at(index).mid(i);
+                continue;
+            }
+        }
+        if (!v1_ok || !v2_ok) {
+            int res = v1_comps.at(index).compare(v2_comps.at(index));
+            if (res == 0) {
+                ++index;
+                continue;
+            }
+            return res > 0 ? +1 : -1;
+        }
+
+        if (v1_comp < v2_comp)
+            return -1;
+        if (v1_comp > v2_comp)
+            return +1;
+        ++index;
+    }
+    return 0;
+}
+
 class tst_CompareVersion : public QObject
 {
     Q_OBJECT
@@ -39,6 +104,12 @@ private slots:
     void compareVersionX();
     void compareVersionAll();
     void compareVersionExtra();
+    void compareVersionKey();
+    void versionRequirement_data();
+    void versionRequirement();
+
+    void benchmarkCompareVersion();
+    void benchmarkCompareVersionKey();
 };
 
 void tst_CompareVersion::compareVersion()
@@ -92,6 +163,74 @@ void tst_CompareVersion::compareVersionExtra()
     QCOMPARE(KDUpdater::compareVersion("OpenSSL_1_1_0f", "OpenSSL_1_0_2k"), +1);
 }
 
+void tst_CompareVersion::compareVersionKey()
+{
+    using KDUpdater::VersionKey;
+
+    const QStringList versions = QStringList() << "" << "2" << "2.0" << "2.x" << "2.1"
+        << "2.1-0" << "2.1-201903190747" << "2.0.12.4" << "2.1.10.4" << "2.1.12.x" << "v2.0"
+        << "v2.0-alpha" << "v2.0-beta" << "v2.0-rc1" << "v2.0-rc2" << "v2.0-rc11"
+        << "OpenSSL_1_0_2k" << "OpenSSL_1_1_0f" << "1..2" << "1.+2" << "99999999999999999999";
+
+    // the pre-parsed keys must order exactly like the string based comparison
+    for (const QString &v1 : versions) {
+        for (const QString &v2 : versions) {
+            QCOMPARE(VersionKey::compare(VersionKey(v1), VersionKey(v2)),
+                referenceCompareVersion(v1, v2));
+        }
+    }
+    QCOMPARE(VersionKey::compare(VersionKey("v2.0-rc2"), VersionKey("v2.0-rc11")), -1);
+    QCOMPARE(VersionKey::compare(VersionKey("1.0"), VersionKey()), +1);
+}
+
+void tst_CompareVersion::versionRequirement_data()
+{
+    QTest::addColumn<QString>("version");
+    QTest::addColumn<QString>("requirement");
+    QTest::addColumn<bool>("matches");
+
+    QTest::newRow("plain equal") << "1.0" << "1.0" << true;
+    QTest::newRow("plain other") << "1.1" << "1.0" << false;
+    QTest::newRow("equal") << "1.0" << "=1.0" << true;
+    QTest::newRow("equal is exact") << "1.0" << "=1.x" << false;
+    QTest::newRow("greater") << "1.1" << ">1.0" << true;
+    QTest::newRow("greater same") << "1.0" << ">1.0" << false;
+    QTest::newRow("greater equal") << "1.0" << ">=1.0" << true;
+    QTest::newRow("greater equal lower") << "0.9" << ">=1.0" << false;
+    QTest::newRow("less") << "0.9" << "<1.0" << true;
+    QTest::newRow("less higher") << "1.0.1" << "<1.0" << false;
+    QTest::newRow("less equal") << "1.0" << "<=1.0" << true;
+    QTest::newRow("empty") << "" << "" << true;
+}
+
+void tst_CompareVersion::versionRequirement()
+{
+    QFETCH(QString, version);
+    QFETCH(QString, requirement);
+    QFETCH(bool, matches);
+
+    QCOMPARE(KDUpdater::VersionRequirement(requirement)
+        .matches(KDUpdater::VersionKey(version)), matches);
+}
+
+void tst_CompareVersion::benchmarkCompareVersion()
+{
+    const QString v1 = QLatin1String("5.15.2-202106041125");
+    const QString v2 = QLatin1String("5.15.2-202106041126");
+    QBENCHMARK {
+        KDUpdater::compareVersion(v1, v2);
+    }
+}
+
+void tst_CompareVersion::benchmarkCompareVersionKey()
+{
+    const KDUpdater::VersionKey v1(QLatin1String("5.15.2-202106041125"));
+    const KDUpdater::VersionKey v2(QLatin1String("5.15.2-202106041126"));
+    QBENCHMARK {
+        KDUpdater::VersionKey::compare(v1, v2);
+    }
+}
+
 QTEST_MAIN(tst_CompareVersion)
 
 #include "tst_compareversion.moc"
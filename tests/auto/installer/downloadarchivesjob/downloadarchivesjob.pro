@@ -0,0 +1,13 @@
+include(../../qttest.pri)
+
+QT += network qml
+
+INCLUDEPATH += ../../../benchmarks/shared
+HEADERS += ../../../benchmarks/shared/httptestserver.h
+SOURCES += \
+    tst_downloadarchivesjob.cpp \
+    ../../../benchmarks/shared/httptestserver.cpp
+
+RESOURCES += \
+    settings.qrc \
+    ../shared/config.qrc
@@ -0,0 +1,191 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "../shared/packagemanager.h"
+#include "httptestserver.h"
+
+#include <component.h>
+#include <downloadarchivesjob.h>
+#include <messageboxhandler.h>
+#include <repository.h>
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace QInstaller;
+
+class tst_DownloadArchivesJob : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QByteArray readFile(const QString &fileName)
+    {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly))
+            return QByteArray();
+        return file.readAll();
+    }
+
+    static void writeFile(const QString &fileName, qint64 size, const QDateTime &lastModified)
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(QByteArray(int(size), 'x')), size);
+        QVERIFY(file.setFileTime(lastModified, QFileDevice::FileModificationTime));
+    }
+
+    QStringList partialFiles() const
+    {
+        return QDir(m_partialDownloadDir).entryList(QStringList(QLatin1String("*.part")), QDir::Files);
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QInstaller::init();
+        qInstallMessageHandler(silentTestMessageHandler);
+        // A failed download cancels the job, as if the user closed the installer.
+        MessageBoxHandler::instance()->setAutomaticAnswer(QLatin1String("archiveDownloadError"),
+            QMessageBox::Cancel);
+    }
+
+    void init()
+    {
+        m_installDir.reset(new QTemporaryDir);
+        m_cacheDir.reset(new QTemporaryDir);
+        QVERIFY(m_installDir->isValid() && m_cacheDir->isValid());
+        m_partialDownloadDir = m_cacheDir->path() + QLatin1String("/downloads");
+    }
+
+    void testResumeInNextJob()
+    {
+        const QString archivePath = QLatin1String(":/data/repository/A/1.0.2-1content.7z");
+        const QByteArray archive = readFile(archivePath);
+        const qint64 hashSize = readFile(archivePath + QLatin1String(".sha1")).size();
+        QVERIFY(!archive.isEmpty() && hashSize > 0);
+
+        HttpTestServer::Options options;
+        options.rootDir = QLatin1String(":/data/repository");
+        HttpTestServer metadataServer(options);
+        QVERIFY(metadataServer.start());
+        const QUrl url = metadataServer.url();
+
+        QScopedPointer<PackageManagerCore> core(PackageManager::getPackageManager(m_installDir->path()));
+        core->settings().setLocalCachePath(m_cacheDir->path());
+        core->settings().setDefaultRepositories(QSet<Repository>() << Repository(url, false));
+        QVERIFY(core->fetchRemotePackagesTree());
+        metadataServer.stop();
+
+        Component *component = core->componentByName(QLatin1String("A"));
+        QVERIFY(component);
+        QCOMPARE(component->downloadableArchives().count(), 1);
+        PackageManagerCore::DownloadItem item;
+        item.checkSha1CheckSum = true;
+        item.fileName = QString::fromLatin1("installer://A/%1").arg(component->downloadableArchives().first());
+        item.sourceUrl = QString::fromLatin1("%1/A/%2").arg(url.toString(),
+            component->downloadableArchives().first());
+
+        // The checksum is downloaded, the connection of the archive download drops halfway.
+        options.port = quint16(url.port());
+        options.failEveryNthRequest = 2;
+        options.failureMode = HttpTestServer::DropConnection;
+        {
+            HttpTestServer server(options);
+            QVERIFY(server.start());
+
+            DownloadArchivesJob job(core.data(), QLatin1String("downloadArchivesJob"));
+            job.setAutoDelete(false);
+            job.setArchivesToDownload(QList<PackageManagerCore::DownloadItem>() << item);
+            job.setPartialDownloadDirectory(m_partialDownloadDir);
+            job.start();
+            job.waitForFinished();
+
+            QCOMPARE(job.error(), int(Job::Canceled));
+            QCOMPARE(server.failedRequestCount(), 1);
+        }
+        QCOMPARE(partialFiles().count(), 1);
+        const qint64 partialSize = QFileInfo(m_partialDownloadDir + QLatin1Char('/')
+            + partialFiles().first()).size();
+        QVERIFY(partialSize > 0 && partialSize < archive.size());
+
+        // A new job continues the download where the previous one stopped.
+        options.failEveryNthRequest = 0;
+        HttpTestServer server(options);
+        QVERIFY(server.start());
+
+        QString downloadedFile;
+        DownloadArchivesJob job(core.data(), QLatin1String("downloadArchivesJob"));
+        job.setAutoDelete(false);
+        job.setArchivesToDownload(QList<PackageManagerCore::DownloadItem>() << item);
+        job.setPartialDownloadDirectory(m_partialDownloadDir);
+        connect(&job, &DownloadArchivesJob::fileDownloadReady, this, [&downloadedFile](const QString &path) {
+            downloadedFile = path;
+        });
+        job.start();
+        job.waitForFinished();
+
+        QCOMPARE(job.error(), int(Job::NoError));
+        QCOMPARE(job.numberOfDownloads(), 1);
+        QCOMPARE(server.bytesSent(), hashSize + archive.size() - partialSize);
+        QCOMPARE(readFile(downloadedFile), archive);
+        QVERIFY(partialFiles().isEmpty());
+        QVERIFY(QDir(m_partialDownloadDir).entryList(QDir::Files | QDir::Hidden).isEmpty());
+    }
+
+    void testRemoveStalePartialDownloads()
+    {
+        QVERIFY(QDir().mkpath(m_partialDownloadDir));
+        const QDateTime now = QDateTime::currentDateTime();
+        const QString dir = m_partialDownloadDir + QLatin1Char('/');
+        writeFile(dir + QLatin1String("expired.part"), 10, now.addDays(-8));
+        writeFile(dir + QLatin1String("expired.part.info"), 10, now.addDays(-8));
+        writeFile(dir + QLatin1String("oldest.part"), 100, now.addSecs(-300));
+        writeFile(dir + QLatin1String("oldest.part.info"), 10, now.addSecs(-300));
+        writeFile(dir + QLatin1String("older.part"), 100, now.addSecs(-200));
+        writeFile(dir + QLatin1String("recent.part"), 100, now.addSecs(-100));
+        writeFile(dir + QLatin1String("unrelated.txt"), 10, now.addDays(-8));
+
+        DownloadArchivesJob::removeStalePartialDownloads(m_partialDownloadDir, 7 * 24 * 60 * 60, 250);
+
+        QCOMPARE(QDir(m_partialDownloadDir).entryList(QDir::Files, QDir::Name), QStringList()
+            << QLatin1String("older.part") << QLatin1String("recent.part")
+            << QLatin1String("unrelated.txt"));
+    }
+
+private:
+    QScopedPointer<QTemporaryDir> m_installDir;
+    QScopedPointer<QTemporaryDir> m_cacheDir;
+    QString m_partialDownloadDir;
+};
+
+QTEST_MAIN(tst_DownloadArchivesJob)
+
+#include "tst_downloadarchivesjob.moc"
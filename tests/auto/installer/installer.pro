@@ -45,8 +45,14 @@ SUBDIRS += \
     contentshaupdate \
     componentreplace \
     metadatacache \
+    archivecache \
+    binarydelta \
     contentsha1check \
-    componentalias
+    componentalias \
+    verbosewriter \
+    phasetracer \
+    metaarchiveengine \
+    downloadarchivesjob
 
 CONFIG(libarchive) {
     SUBDIRS += libarchivearchive
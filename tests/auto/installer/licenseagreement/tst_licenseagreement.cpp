@@ -30,6 +30,7 @@
 #include <packagemanagercore.h>
 
 #include <QFile>
+#include <QTemporaryDir>
 #include <QTest>
 
 using namespace KDUpdater;
@@ -56,6 +57,28 @@ private slots:
         QVERIFY(dir.removeRecursively());
         core->deleteLater();
     }
+
+    void testAutoAcceptFromCLIWithMetadataOnDemand()
+    {
+        QTemporaryDir cacheDir;
+        QVERIFY(cacheDir.isValid());
+        QString installDir = QInstaller::generateTemporaryFileName();
+        QVERIFY(QDir().mkpath(installDir));
+        PackageManagerCore *core = PackageManager::getPackageManagerWithInit
+                (installDir, ":///data/repository");
+
+        // The license is available only after the meta data of the component is fetched
+        core->settings().setLocalCachePath(cacheDir.path());
+        core->settings().setFetchMetadataOnDemand(true);
+        core->setAutoAcceptLicenses();
+        core->installDefaultComponentsSilently();
+
+        QFile file(installDir + "/Licenses/gpl3.txt");
+        QVERIFY(file.exists());
+        QDir dir(installDir);
+        QVERIFY(dir.removeRecursively());
+        core->deleteLater();
+    }
 };
 
 QTEST_MAIN(tst_licenseagreement)
@@ -0,0 +1,242 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include <errors.h>
+#include <metaarchiveenginehandler.h>
+
+#include <QDirIterator>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace QInstaller;
+
+static const QLatin1String scComponentName("org.qt.component");
+
+class tst_MetaArchiveEngine : public QObject
+{
+    Q_OBJECT
+
+private:
+    void writeFile(const QString &filePath, const QByteArray &content)
+    {
+        QVERIFY(QDir().mkpath(QFileInfo(filePath).absolutePath()));
+        QFile file(filePath);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(content), qint64(content.size()));
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_tempDir.isValid());
+        m_files.insert(QLatin1String("installscript.qs"), "function Component() {}\n");
+        m_files.insert(QLatin1String("license.txt"), "License text\n");
+        m_files.insert(QLatin1String("de.qm"), QByteArray());
+        m_files.insert(QLatin1String("pages/page.ui"), "<ui version=\"4.0\"/>\n");
+
+        const QString componentDir = m_tempDir.path() + QLatin1Char('/') + scComponentName;
+        for (auto it = m_files.constBegin(); it != m_files.constEnd(); ++it)
+            writeFile(componentDir + QLatin1Char('/') + it.key(), it.value());
+
+        m_archivePath = MetaArchiveEngineHandler::archivePath(m_tempDir.path(), scComponentName);
+        try {
+            MetaArchiveEngineHandler::createArchive(m_archivePath, componentDir);
+        } catch (const Error &error) {
+            QFAIL(qPrintable(error.message()));
+        }
+        QVERIFY(QFileInfo::exists(m_archivePath));
+    }
+
+    void cleanupTestCase()
+    {
+        MetaArchiveEngineHandler::instance()->clear();
+    }
+
+    void testReadArchive()
+    {
+        const MetaArchiveEntries entries = MetaArchiveEngineHandler::readArchive(m_archivePath);
+        QStringList names = entries.keys();
+        QStringList expectedNames = m_files.keys();
+        names.sort();
+        expectedNames.sort();
+        QCOMPARE(names, expectedNames);
+
+        for (auto it = m_files.constBegin(); it != m_files.constEnd(); ++it)
+            QCOMPARE(entries.value(it.key()).length(), qint64(it.value().size()));
+    }
+
+    void testReadFiles()
+    {
+        const QString directory = MetaArchiveEngineHandler::instance()->registerArchive(m_archivePath);
+        QVERIFY(directory.startsWith(QLatin1String("metadata://")));
+        QVERIFY(directory.endsWith(QLatin1Char('/') + scComponentName + QLatin1String(".meta/")));
+
+        QFileInfo directoryInfo(directory);
+        QVERIFY(directoryInfo.exists());
+        QVERIFY(directoryInfo.isDir());
+
+        for (auto it = m_files.constBegin(); it != m_files.constEnd(); ++it) {
+            const QFileInfo fileInfo(QDir(directory), it.key());
+            QVERIFY(fileInfo.exists());
+            QVERIFY(fileInfo.isFile());
+            QVERIFY(fileInfo.isReadable());
+            QCOMPARE(fileInfo.size(), qint64(it.value().size()));
+
+            QFile file(fileInfo.filePath());
+            QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable(file.errorString()));
+            QCOMPARE(file.readAll(), it.value());
+        }
+
+        QVERIFY(QFileInfo(directory + QLatin1String("pages")).isDir());
+        QVERIFY(!QFileInfo::exists(directory + QLatin1String("missing.txt")));
+        QVERIFY(!QFileInfo::exists(QLatin1String("metadata://org.qt.unknown/license.txt")));
+    }
+
+    void testSameComponentName()
+    {
+        // Components with the same name from different repositories
+        const QString otherDir = m_tempDir.path() + QLatin1String("/other");
+        const QString componentDir = otherDir + QLatin1Char('/') + scComponentName;
+        writeFile(componentDir + QLatin1String("/license.txt"), "Other license text\n");
+        const QString archivePath = MetaArchiveEngineHandler::archivePath(otherDir, scComponentName);
+        try {
+            MetaArchiveEngineHandler::createArchive(archivePath, componentDir);
+        } catch (const Error &error) {
+            QFAIL(qPrintable(error.message()));
+        }
+
+        MetaArchiveEngineHandler *const handler = MetaArchiveEngineHandler::instance();
+        const QString directory = handler->registerArchive(m_archivePath);
+        const QString otherDirectory = handler->registerArchive(archivePath);
+        QVERIFY(directory != otherDirectory);
+
+        QFile file(directory + QLatin1String("license.txt"));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll(), m_files.value(QLatin1String("license.txt")));
+        QFile otherFile(otherDirectory + QLatin1String("license.txt"));
+        QVERIFY(otherFile.open(QIODevice::ReadOnly));
+        QCOMPARE(otherFile.readAll(), QByteArray("Other license text\n"));
+    }
+
+    void testListDirectory()
+    {
+        const QString directory = MetaArchiveEngineHandler::instance()->registerArchive(m_archivePath);
+
+        QStringList files;
+        QDirIterator it(directory, QStringList() << QLatin1String("*.qs")
+            << QLatin1String("*.txt"), QDir::Files);
+        while (it.hasNext())
+            files.append(QFileInfo(it.next()).fileName());
+        files.sort();
+        QCOMPARE(files, QStringList() << QLatin1String("installscript.qs")
+            << QLatin1String("license.txt"));
+
+        QCOMPARE(QDir(directory).entryList(QDir::Dirs | QDir::NoDotAndDotDot),
+            QStringList() << QLatin1String("pages"));
+        QCOMPARE(QDir(directory + QLatin1String("pages")).entryList(QDir::Files),
+            QStringList() << QLatin1String("page.ui"));
+    }
+
+    void testReadOnly()
+    {
+        const QString directory = MetaArchiveEngineHandler::instance()->registerArchive(m_archivePath);
+
+        QFile file(directory + QLatin1String("license.txt"));
+        QVERIFY(!file.open(QIODevice::WriteOnly));
+        QVERIFY(!file.open(QIODevice::ReadWrite));
+        QVERIFY(!file.remove());
+        QVERIFY(QFileInfo::exists(file.fileName()));
+    }
+
+    void testInvalidArchive()
+    {
+        const QString archivePath = m_tempDir.path() + QLatin1String("/invalid.meta");
+        writeFile(archivePath, QByteArray(64, 'x'));
+        try {
+            MetaArchiveEngineHandler::readArchive(archivePath);
+            QFAIL("Reading an invalid meta data archive must fail.");
+        } catch (const Error &) {}
+
+        const QString directory = MetaArchiveEngineHandler::instance()->registerArchive(archivePath);
+        QVERIFY(!QFileInfo::exists(directory + QLatin1String("license.txt")));
+    }
+
+    void testExtractArchive()
+    {
+        const QString targetDir = m_tempDir.path() + QLatin1String("/extracted");
+        try {
+            MetaArchiveEngineHandler::extractArchive(m_archivePath, targetDir);
+        } catch (const Error &error) {
+            QFAIL(qPrintable(error.message()));
+        }
+
+        for (auto it = m_files.constBegin(); it != m_files.constEnd(); ++it) {
+            QFile file(targetDir + QLatin1Char('/') + it.key());
+            QVERIFY(file.open(QIODevice::ReadOnly));
+            QCOMPARE(file.readAll(), it.value());
+        }
+    }
+
+    void testExtractArchiveOutsideTarget()
+    {
+        const QString componentDir = m_tempDir.path() + QLatin1String("/escaping/component");
+        writeFile(componentDir + QLatin1String("/zz/escape.txt"), "Escaped\n");
+        const QString archivePath = m_tempDir.path() + QLatin1String("/escaping.meta");
+        try {
+            MetaArchiveEngineHandler::createArchive(archivePath, componentDir);
+        } catch (const Error &error) {
+            QFAIL(qPrintable(error.message()));
+        }
+
+        // Rename the file inside the archive to point to the parent directory
+        QFile file(archivePath);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QByteArray content = file.readAll();
+        QVERIFY(content.contains("zz/escape.txt"));
+        content.replace("zz/escape.txt", "../escape.txt");
+        QVERIFY(file.seek(0));
+        QCOMPARE(file.write(content), qint64(content.size()));
+        file.close();
+
+        const QString targetDir = m_tempDir.path() + QLatin1String("/escaping/target");
+        try {
+            MetaArchiveEngineHandler::extractArchive(archivePath, targetDir);
+            QFAIL("Extracting files outside of the target directory must fail.");
+        } catch (const Error &) {}
+        QVERIFY(!QFileInfo::exists(m_tempDir.path() + QLatin1String("/escaping/escape.txt")));
+    }
+
+private:
+    QTemporaryDir m_tempDir;
+    QString m_archivePath;
+    QHash<QString, QByteArray> m_files;
+};
+
+QTEST_MAIN(tst_MetaArchiveEngine)
+
+#include "tst_metaarchiveengine.moc"
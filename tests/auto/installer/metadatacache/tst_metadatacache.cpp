@@ -269,6 +269,25 @@ private slots:
         QCOMPARE(cache.errorString(), "Cannot initialize cache with empty path.");
     }
 
+    void testInvalidItems()
+    {
+        MetadataCache cache(m_cachePath);
+        QVERIFY(cache.registerItem(new Metadata(":/data/local-temp-repository/")));
+
+        Metadata *metadata = cache.itemByChecksum(m_newMetadataItemChecksum);
+        QVERIFY(metadata);
+        QVERIFY(QFileInfo::exists(metadata->path() + "/metafiles.stamp"));
+        QVERIFY(cache.invalidItems().isEmpty());
+
+        // Removing a verified file must not be hidden by the stamp
+        QFile licenseFile(metadata->path() + "/A/example-license.txt");
+        QInstaller::setDefaultFilePermissions(&licenseFile, QInstaller::NonExecutable);
+        QVERIFY2(licenseFile.remove(), qPrintable(licenseFile.errorString()));
+        QCOMPARE(cache.invalidItems(), QList<Metadata *>() << metadata);
+
+        QVERIFY(cache.clear());
+    }
+
     void testRemoveItemFromCache()
     {
         copyExistingCacheFromResourceTree();
@@ -36,6 +36,8 @@
 #include <packagemanagercore.h>
 #include <progresscoordinator.h>
 
+#include <QRegularExpression>
+#include <QTemporaryDir>
 #include <QTest>
 
 using namespace QInstaller;
@@ -60,6 +62,76 @@ private slots:
         QCOMPARE(metadata.metadata().count(), 1);
     }
 
+    void testParsedUpdatesInfo()
+    {
+        QTemporaryDir cacheDir;
+        QVERIFY(cacheDir.isValid());
+
+        PackageManagerCore core;
+        core.setInstaller();
+        core.settings().setLocalCachePath(cacheDir.path());
+        QSet<Repository> repoList;
+        Repository repo = Repository::fromUserInput(":///data/repository");
+        repoList.insert(repo);
+        core.settings().setDefaultRepositories(repoList);
+        MetadataJob metadata;
+        metadata.setPackageManagerCore(&core);
+        metadata.start();
+        metadata.waitForFinished();
+        QCOMPARE(metadata.metadata().count(), 1);
+
+        // The package records are kept for the update finder
+        const KDUpdater::UpdatesInfo updatesInfo = metadata.metadata().first()->updatesInfo();
+        QVERIFY(updatesInfo.isValid());
+        QVERIFY(!updatesInfo.containsRepositoryUpdates());
+        QCOMPARE(updatesInfo.updateInfoCount(), 1);
+        QCOMPARE(updatesInfo.updateInfo(0).data.value("Name").toString(), QLatin1String("C"));
+    }
+
+    void testFetchMetadataOnDemand()
+    {
+        QTemporaryDir cacheDir;
+        QVERIFY(cacheDir.isValid());
+
+        PackageManagerCore core;
+        core.setInstaller();
+        core.settings().setLocalCachePath(cacheDir.path());
+        core.settings().setFetchMetadataOnDemand(true);
+        QSet<Repository> repoList;
+        Repository repo = Repository::fromUserInput(":///data/repositoryOnDemand");
+        repoList.insert(repo);
+        core.settings().setDefaultRepositories(repoList);
+        MetadataJob metadata;
+        metadata.setAutoDelete(false);   // the job is run again to fetch the component meta data
+        metadata.setPackageManagerCore(&core);
+        metadata.start();
+        metadata.waitForFinished();
+        QCOMPARE(metadata.metadata().count(), 1);
+
+        // Only Updates.xml is fetched, the cached item is still valid
+        Metadata *const cached = metadata.metadata().first();
+        QVERIFY(cached->isMetaFetchDeferred());
+        const QString componentDirectory = cached->path() + QLatin1String("/A");
+        QVERIFY(!QFileInfo::exists(componentDirectory));
+        QVERIFY(cached->isValid());
+
+        metadata.prefetchComponentMetadata(QStringList() << componentDirectory);
+        metadata.addDownloadType(DownloadType::ComponentMetadata);
+        metadata.setComponentMetadataDirectories(QStringList() << componentDirectory);
+        metadata.start();
+        metadata.waitForFinished();
+        QCOMPARE(metadata.error(), int(Job::NoError));
+        QVERIFY(QFileInfo::exists(componentDirectory + QLatin1String("/gpl3.txt")));
+        QVERIFY(cached->isValid());
+
+        // Unknown components are skipped
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Cannot find meta data to fetch for .*"));
+        metadata.setComponentMetadataDirectories(QStringList() << cached->path() + QLatin1String("/B"));
+        metadata.start();
+        metadata.waitForFinished();
+        QCOMPARE(metadata.error(), int(Job::NoError));
+    }
+
     void testRepositoryUpdateActionAdd()
     {
         PackageManagerCore core;
@@ -264,6 +264,87 @@ private slots:
         QCOMPARE(core.requiredDiskSpace(), 250ULL);
     }
 
+    void testTypedComponentValues()
+    {
+        PackageManagerCore core;
+        NamedComponent component(&core, QLatin1String("root"));
+
+        component.setValue(scSortingPriority, QLatin1String("42"));
+        component.setValue(scUncompressedSize, QLatin1String("1000"));
+        component.setValue(scCompressedSize, QLatin1String("100"));
+        component.setValue(scVirtual, QLatin1String("True"));
+        component.setValue(scEssential, scTrue);
+        component.setValue(scRequiresAdminRights, scTrue);
+
+        QCOMPARE(component.sortingPriority(), 42);
+        QCOMPARE(component.uncompressedSize(), 1000ULL);
+        QCOMPARE(component.compressedSize(), 100ULL);
+        QCOMPARE(component.isVirtual(), true);
+        QCOMPARE(component.isEssential(), true);
+        QCOMPARE(component.requiresAdminRights(), true);
+        QCOMPARE(component.value(scSortingPriority), QLatin1String("42"));
+
+        component.setValue(scRequiresAdminRights, scFalse);
+        QCOMPARE(component.requiresAdminRights(), false);
+
+        QCOMPARE(component.removeValue(scSortingPriority), 1);
+        QCOMPARE(component.sortingPriority(), 0);
+        QCOMPARE(component.removeValue(scVirtual), 1);
+        QCOMPARE(component.isVirtual(), false);
+    }
+
+    void testInstallPlan()
+    {
+        QTest::ignoreMessage(QtDebugMsg, "Operations sanity check succeeded.");
+        PackageManagerCore core(QInstaller::BinaryContent::MagicInstallerMarker,
+            QList<QInstaller::OperationBlob>());
+
+        DummyComponent *root = new DummyComponent(&core);
+        root->setValue(scName, "root");
+        root->setValue(scUncompressedSize, QString::number(1000));
+        root->setValue(scCompressedSize, QString::number(100));
+        core.appendRootComponent(root);
+
+        DummyComponent *child1 = new DummyComponent(&core);
+        child1->setValue(scName, "root.child1");
+        child1->setValue(scUncompressedSize, QString::number(1500));
+        child1->setValue(scCompressedSize, QString::number(150));
+        child1->setValue(scRequiresAdminRights, scTrue);
+        root->appendComponent(child1);
+
+        root->setUninstalled();
+        child1->setUninstalled();
+        core.calculateComponentsToInstall();
+
+        QVariantMap plan = core.installPlan();
+        QStringList components = plan.value(QLatin1String("components")).toStringList();
+        components.sort();
+        QCOMPARE(components, QStringList() << "root" << "root.child1");
+        QCOMPARE(plan.value(QLatin1String("uncompressedSize")).toULongLong(), 2500ULL);
+        QCOMPARE(plan.value(QLatin1String("compressedSize")).toULongLong(), 250ULL);
+        QCOMPARE(plan.value(QLatin1String("requiresAdminRights")).toBool(), true);
+
+        // the plan is recalculated after the selection changes
+        child1->setInstalled();
+        core.calculateComponentsToInstall();
+
+        plan = core.installPlan();
+        QCOMPARE(plan.value(QLatin1String("components")).toStringList(), QStringList() << "root");
+        QCOMPARE(plan.value(QLatin1String("uncompressedSize")).toULongLong(), 1000ULL);
+        QCOMPARE(plan.value(QLatin1String("requiresAdminRights")).toBool(), false);
+        QCOMPARE(core.requiredDiskSpace(), 1000ULL);
+
+        // component scripts can change the values the plan is calculated from
+        root->setValue(scUncompressedSize, QString::number(3000));
+        root->setValue(scRequiresAdminRights, scTrue);
+        plan = core.installPlan();
+        QCOMPARE(plan.value(QLatin1String("uncompressedSize")).toULongLong(), 3000ULL);
+        QCOMPARE(plan.value(QLatin1String("requiresAdminRights")).toBool(), true);
+
+        QCOMPARE(root->removeValue(scRequiresAdminRights), 1);
+        QCOMPARE(core.installPlan().value(QLatin1String("requiresAdminRights")).toBool(), false);
+    }
+
     void testDirectoryWritable()
     {
         PackageManagerCore core;
@@ -0,0 +1,162 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include <phasetracer.h>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThread>
+
+using namespace QInstaller;
+
+class tst_PhaseTracer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init()
+    {
+        PhaseTracer::instance().clear();
+    }
+
+    void cleanup()
+    {
+        PhaseTracer::instance().setEnabled(false);
+        PhaseTracer::instance().setEnabled(false, PhaseTracer::Script);
+        PhaseTracer::instance().clear();
+    }
+
+    void testDisabled()
+    {
+        QVERIFY(!PhaseTracer::instance().isEnabled());
+        {
+            PhaseTracer::Scope trace("Disabled phase");
+        }
+        QCOMPARE(PhaseTracer::instance().spanCount(), 0);
+    }
+
+    void testWriteTrace()
+    {
+        PhaseTracer::instance().setEnabled(true);
+        {
+            PhaseTracer::Scope outer("Outer phase");
+            PhaseTracer::Scope inner("Inner phase", QLatin1String("A"));
+        }
+
+        QThread *thread = QThread::create([] {
+            PhaseTracer::Scope trace("Worker phase");
+        });
+        thread->setObjectName(QLatin1String("Worker"));
+        thread->start();
+        QVERIFY(thread->wait());
+        delete thread;
+        QCOMPARE(PhaseTracer::instance().spanCount(), 3);
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString fileName = dir.filePath(QLatin1String("trace.json"));
+        PhaseTracer::instance().writeTrace(fileName);
+
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+
+        QHash<QString, QJsonObject> spans;
+        QHash<int, QString> threadNames;
+        const QJsonArray events = document.object().value(QLatin1String("traceEvents")).toArray();
+        for (const QJsonValue &value : events) {
+            const QJsonObject event = value.toObject();
+            const QString phase = event.value(QLatin1String("ph")).toString();
+            if (phase == QLatin1String("M")) {
+                threadNames.insert(event.value(QLatin1String("tid")).toInt(),
+                    event.value(QLatin1String("args")).toObject().value(QLatin1String("name")).toString());
+            } else {
+                QCOMPARE(phase, QLatin1String("X"));
+                spans.insert(event.value(QLatin1String("name")).toString(), event);
+            }
+        }
+        QCOMPARE(spans.count(), 3);
+        QCOMPARE(threadNames.count(), 2);
+
+        const QJsonObject outer = spans.value(QLatin1String("Outer phase"));
+        const QJsonObject inner = spans.value(QLatin1String("Inner phase"));
+        const QJsonObject worker = spans.value(QLatin1String("Worker phase"));
+        QCOMPARE(inner.value(QLatin1String("args")).toObject().value(QLatin1String("detail")).toString(),
+            QLatin1String("A"));
+        QVERIFY(outer.value(QLatin1String("ts")).toDouble() <= inner.value(QLatin1String("ts")).toDouble());
+        QVERIFY(outer.value(QLatin1String("dur")).toDouble() >= inner.value(QLatin1String("dur")).toDouble());
+        QCOMPARE(outer.value(QLatin1String("tid")), inner.value(QLatin1String("tid")));
+        QVERIFY(outer.value(QLatin1String("tid")) != worker.value(QLatin1String("tid")));
+        QVERIFY(threadNames.value(worker.value(QLatin1String("tid")).toInt())
+            .startsWith(QLatin1String("Worker")));
+    }
+
+    void testCategories()
+    {
+        PhaseTracer &tracer = PhaseTracer::instance();
+        tracer.setEnabled(true, PhaseTracer::Script);
+        QVERIFY(tracer.isEnabled(PhaseTracer::Script));
+        QVERIFY(!tracer.isEnabled(PhaseTracer::Phase));
+        {
+            PhaseTracer::Scope trace("Disabled phase");
+        }
+        tracer.addSpan(PhaseTracer::Script, QLatin1String("createOperations"),
+            QLatin1String("A"), tracer.elapsed(), 1000);
+        QCOMPARE(tracer.spanCount(), 1);
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString fileName = dir.filePath(QLatin1String("trace.json"));
+        QJsonObject extra;
+        extra.insert(QLatin1String("extra"), true);
+        tracer.writeTrace(fileName, extra);
+
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+        QVERIFY(root.value(QLatin1String("extra")).toBool());
+
+        QJsonObject span;
+        const QJsonArray events = root.value(QLatin1String("traceEvents")).toArray();
+        for (const QJsonValue &value : events) {
+            if (value.toObject().value(QLatin1String("ph")).toString() == QLatin1String("X"))
+                span = value.toObject();
+        }
+        QCOMPARE(span.value(QLatin1String("name")).toString(), QLatin1String("createOperations"));
+        QCOMPARE(span.value(QLatin1String("cat")).toString(), QLatin1String("script"));
+    }
+};
+
+QTEST_MAIN(tst_PhaseTracer)
+
+#include "tst_phasetracer.moc"
@@ -29,6 +29,7 @@
 #include "../shared/packagemanager.h"
 #include "../shared/verifyinstaller.h"
 
+#include "component.h"
 #include "repository.h"
 #include "repositorycategory.h"
 #include "settings.h"
@@ -308,6 +309,41 @@ private slots:
         for (const QString unexpectedSetting : unexpectedSettings)
             QVERIFY2(!core->containsValue(unexpectedSetting), "Core contains unexpected value");
     }
+
+    void testOnDemandScriptFromRepository_data()
+    {
+        QTest::addColumn<QString>("installComponent");
+        QTest::addColumn<bool>("scriptEvaluated");
+
+        // component D has onDemand = true in component.xml
+        QTest::newRow("onDemandComponentB") << "B" << false;
+        QTest::newRow("onDemandComponentD") << "D" << true;
+    }
+
+    void testOnDemandScriptFromRepository()
+    {
+        QFETCH(QString, installComponent);
+        QFETCH(bool, scriptEvaluated);
+
+        QString installDir = QInstaller::generateTemporaryFileName();
+        QScopedPointer<PackageManagerCore> core(PackageManager::getPackageManagerWithInit(installDir,
+            ":///data/repository"));
+        QVERIFY(core->fetchRemotePackagesTree());
+
+        Component *component = core->componentByName("D");
+        QVERIFY(component);
+        QVERIFY(component->isScriptOnDemand());
+        QVERIFY(component->isScriptDeferred());
+        QVERIFY(!core->containsValue("componentDKey"));
+
+        // Installing fetches the components again.
+        core->installSelectedComponentsSilently(QStringList() << installComponent);
+        component = core->componentByName("D");
+        QVERIFY(component);
+        QCOMPARE(core->containsValue("componentDKey"), scriptEvaluated);
+        QCOMPARE(component->isScriptDeferred(), !scriptEvaluated);
+        QVERIFY(QDir(installDir).removeRecursively());
+    }
 };
 
 QTEST_MAIN(tst_Repository)
@@ -32,7 +32,9 @@
 #include <updateoperationfactory.h>
 #include <packagemanagercore.h>
 #include <packagemanagergui.h>
+#include <phasetracer.h>
 #include <scriptengine.h>
+#include <scriptprofiler.h>
 
 #include <../unicodeexecutable/stringdata.h>
 
@@ -40,6 +42,10 @@
 #include <QSet>
 #include <QFile>
 #include <QString>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryFile>
 
 using namespace QInstaller;
 
@@ -424,6 +430,59 @@ private slots:
         }
     }
 
+    void profileComponentScript()
+    {
+        ScriptProfiler &profiler = ScriptProfiler::instance();
+        PhaseTracer &tracer = PhaseTracer::instance();
+        profiler.clear();
+        tracer.clear();
+        tracer.setEnabled(true, PhaseTracer::Script);
+
+        try {
+            setExpectedScriptOutput("Component constructor - OK");
+            setExpectedScriptOutput("retranslateUi - OK");
+            m_component->evaluateComponentScript(":///data/component1.qs");
+
+            setExpectedScriptOutput("createOperations - OK");
+            m_component->createOperations();
+            setExpectedScriptOutput("createOperations - OK");
+            m_component->createOperations();
+        } catch (const Error &error) {
+            QFAIL(qPrintable(error.message()));
+        }
+        tracer.setEnabled(false, PhaseTracer::Script);
+
+        QHash<QString, qint64> calls;
+        foreach (const ScriptProfiler::Entry &entry, profiler.entries()) {
+            QCOMPARE(entry.owner, m_component->name());
+            QVERIFY(entry.totalTime >= entry.maxTime);
+            calls.insert(entry.function, entry.calls);
+        }
+        QCOMPARE(calls.value(QLatin1String("<load script>")), 1);
+        // the recursive call from the script is not counted
+        QCOMPARE(calls.value(QLatin1String("createOperations")), 2);
+
+        QTemporaryFile traceFile;
+        QVERIFY(traceFile.open());
+        traceFile.close();
+        QJsonObject extra;
+        extra.insert(QLatin1String("scriptProfile"), profiler.summary());
+        tracer.writeTrace(traceFile.fileName(), extra);
+        QVERIFY(traceFile.open());
+        const QJsonObject trace = QJsonDocument::fromJson(traceFile.readAll()).object();
+        int scriptEvents = 0;
+        foreach (const QJsonValue &event, trace.value(QLatin1String("traceEvents")).toArray()) {
+            if (event.toObject().value(QLatin1String("cat")).toString() == QLatin1String("script"))
+                ++scriptEvents;
+        }
+        QCOMPARE(scriptEvents, calls.value(QLatin1String("<load script>")) + calls.value(QLatin1String("retranslateUi"))
+            + calls.value(QLatin1String("createOperations")));
+        QCOMPARE(trace.value(QLatin1String("scriptProfile")).toArray().count(), calls.count());
+
+        profiler.clear();
+        tracer.clear();
+    }
+
     void loadBrokenComponentScript_data()
     {
         QTest::addColumn<QString>("path");
@@ -129,11 +129,15 @@ void tst_Settings::loadTutorialConfig()
     QCOMPARE(settings.controlScript(), QString());
 
     QCOMPARE(settings.supportsModify(), true);
+    QCOMPARE(settings.allowHttp2(), false);
+    QCOMPARE(settings.maxConnectionsPerHost(), 6);
 }
 
 void tst_Settings::loadFullConfig()
 {
     Settings settings = Settings::fromFileAndPrefix(":///data/full_config.xml", ":///data");
+    QCOMPARE(settings.allowHttp2(), true);
+    QCOMPARE(settings.maxConnectionsPerHost(), 8);
 }
 
 void tst_Settings::loadEmptyConfig()
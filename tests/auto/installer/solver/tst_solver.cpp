@@ -27,10 +27,12 @@
 **************************************************************************/
 
 #include <component.h>
+#include <componentdependencygraph.h>
 #include <graph.h>
 #include <installercalculator.h>
 #include <uninstallercalculator.h>
 #include <componentchecker.h>
+#include <errors.h>
 #include <packagemanagercore.h>
 #include <settings.h>
 
@@ -144,6 +146,58 @@ private slots:
             qPrintable(cycle.first.data()));
     }
 
+    void sortComponentDependencyGraph()
+    {
+        ComponentDependencyGraph graph;
+        graph.build(QStringList() << "A" << "B" << "C" << "D",
+            QList<QStringList>() << (QStringList() << "B" << "C") << (QStringList() << "C")
+                << QStringList() << (QStringList() << "E"));
+
+        const QStringList resolved = graph.sortedNames();
+        QCOMPARE(resolved, QStringList() << "C" << "B" << "A" << "E" << "D");
+    }
+
+    void sortComponentDependencyGraphCycle()
+    {
+        ComponentDependencyGraph graph;
+        graph.build(QStringList() << "A" << "B" << "C",
+            QList<QStringList>() << (QStringList() << "B") << (QStringList() << "C")
+                << (QStringList() << "A"));
+
+        try {
+            graph.sortedNames();
+            QFAIL("Sorted a dependency graph with a cycle.");
+        } catch (const QInstaller::Error &) {}
+    }
+
+    void componentDependencyGraphUpToDate()
+    {
+        PackageManagerCore core;
+        core.setPackageManager();
+        NamedComponent *componentA = new NamedComponent(&core, QLatin1String("A"));
+        NamedComponent *componentB = new NamedComponent(&core, QLatin1String("B"));
+        componentA->addDependency(QLatin1String("B->=1.0.0"));
+        core.appendRootComponent(componentA);
+        core.appendRootComponent(componentB);
+
+        const QList<Component *> components = core.components(PackageManagerCore::ComponentType::All);
+        ComponentDependencyGraph graph;
+        QVERIFY(!graph.isUpToDate(components));
+
+        graph.build(components);
+        QVERIFY(graph.isUpToDate(components));
+        QCOMPARE(graph.sortedNames(), QStringList() << "B" << "A");
+
+        componentB->addDependency(QLatin1String("A"));
+        QVERIFY(!graph.isUpToDate(components));
+
+        graph.build(components);
+        try {
+            graph.sortedNames();
+            QFAIL("Sorted a dependency graph with a cycle.");
+        } catch (const QInstaller::Error &) {}
+    }
+
     void resolveInstaller_data()
     {
         QTest::addColumn<PackageManagerCore *>("core");
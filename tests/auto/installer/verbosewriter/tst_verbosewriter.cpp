@@ -0,0 +1,119 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include <loggingutils.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace QInstaller;
+
+class tst_VerboseWriter : public QObject
+{
+    Q_OBJECT
+
+private:
+    QByteArray readLog(const QString &fileName)
+    {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly))
+            return QByteArray();
+        return file.readAll();
+    }
+
+private slots:
+    void testFlushToLogFile()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString logFileName = dir.filePath(QLatin1String("InstallationLog.txt"));
+
+        VerboseWriter writer;
+        for (int i = 0; i < 5000; ++i)
+            writer.appendLine(QString::fromLatin1("line %1").arg(i));
+        writer.setFileName(logFileName);
+
+        PlainVerboseWriterOutput output;
+        QVERIFY(writer.flush(&output));
+
+        const QByteArray log = readLog(logFileName);
+        QVERIFY(log.startsWith("************************************* Invoked: "));
+        QCOMPARE(log.count('\n'), 5001);
+        QVERIFY(log.contains("\nline 0\n"));
+        QVERIFY(log.endsWith("\nline 4999\n"));
+
+        // the log is written only once
+        writer.appendLine(QLatin1String("after flush"));
+        QVERIFY(writer.flush(&output));
+        QCOMPARE(readLog(logFileName), log);
+    }
+
+    void testNoLogFileName()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        VerboseWriter writer;
+        writer.appendLine(QLatin1String("line"));
+
+        PlainVerboseWriterOutput output;
+        QVERIFY(writer.flush(&output));
+        QVERIFY(QDir(dir.path()).isEmpty());
+    }
+
+    void testLogFileRotation()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString logFileName = dir.filePath(QLatin1String("InstallationLog.txt"));
+
+        QFile oldLog(logFileName);
+        QVERIFY(oldLog.open(QIODevice::WriteOnly));
+        QVERIFY(oldLog.resize(VerboseWriter::MaxLogFileSize));
+        oldLog.close();
+
+        VerboseWriter writer;
+        writer.appendLine(QLatin1String("new run"));
+        writer.setFileName(logFileName);
+
+        PlainVerboseWriterOutput output;
+        QVERIFY(writer.flush(&output));
+
+        QCOMPARE(QFileInfo(logFileName + QLatin1String(".1")).size(), VerboseWriter::MaxLogFileSize);
+        const QByteArray log = readLog(logFileName);
+        QVERIFY(log.startsWith("************************************* Invoked: "));
+        QVERIFY(log.endsWith("\nnew run\n"));
+    }
+};
+
+QTEST_MAIN(tst_VerboseWriter)
+
+#include "tst_verbosewriter.moc"
@@ -0,0 +1,35 @@
+include(../../installerfw.pri)
+
+isEmpty(TEMPLATE):TEMPLATE=app
+QT += testlib network qml
+QT -= gui
+CONFIG += qt warn_on console depend_includepath
+
+DEFINES -= QT_NO_CAST_FROM_ASCII
+# prefix benchmark binary with tst_
+!contains(TARGET, ^tst_.*):TARGET = $$join(TARGET,,"tst_")
+
+INCLUDEPATH += $$PWD/shared
+HEADERS += \
+    $$PWD/shared/benchmarkutils.h \
+    $$PWD/shared/httptestserver.h \
+    $$PWD/shared/syntheticrepository.h
+SOURCES += \
+    $$PWD/shared/benchmarkutils.cpp \
+    $$PWD/shared/httptestserver.cpp \
+    $$PWD/shared/syntheticrepository.cpp
+
+# "make benchmark" runs the benchmarks and stores the results in QtTest's XML and CSV
+# formats, so they can be compared between releases. The results are written to
+# BENCHMARK_RESULTS_DIR, which defaults to the results directory of the build tree.
+isEmpty(BENCHMARK_RESULTS_DIR):BENCHMARK_RESULTS_DIR = $$OUT_PWD/../results
+!exists($$BENCHMARK_RESULTS_DIR):mkpath($$BENCHMARK_RESULTS_DIR)
+BENCHMARK_RESULTS = $$BENCHMARK_RESULTS_DIR/$$TARGET
+
+benchmark.commands = $$shell_path($$OUT_PWD/$$TARGET) \
+    -o $$shell_quote($$shell_path($${BENCHMARK_RESULTS}.xml),xml) \
+    -o $$shell_quote($$shell_path($${BENCHMARK_RESULTS}.csv),csv) \
+    -o -,txt
+QMAKE_EXTRA_TARGETS += benchmark
+
+macx:include(../../no_app_bundle.pri)
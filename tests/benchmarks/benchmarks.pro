@@ -0,0 +1,13 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    repogen \
+    metadatafetch \
+    installercalculator \
+    extract \
+    installation \
+    download \
+    componentscripts
+
+benchmark.CONFIG = recursive
+QMAKE_EXTRA_TARGETS += benchmark
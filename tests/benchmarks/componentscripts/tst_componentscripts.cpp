@@ -0,0 +1,147 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "benchmarkutils.h"
+
+#include <component.h>
+#include <packagemanagercore.h>
+#include <repository.h>
+
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace QInstaller;
+
+class tst_componentscripts : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const BenchmarkUtils::Columns Columns;
+
+    void generateRepository()
+    {
+        SyntheticRepository::Options defaults;
+        defaults.filesPerArchive = 1;
+        defaults.fileSize = 1024;
+        const SyntheticRepository generator(BenchmarkUtils::fetchOptions(Columns, defaults));
+        QString errorString;
+        QVERIFY2(BenchmarkUtils::generateRepository(generator, m_repositoryDir->path(),
+            &errorString), qPrintable(errorString));
+    }
+
+    PackageManagerCore *createCore()
+    {
+        return BenchmarkUtils::createCore(m_installDir->path(), m_cacheDir->path(),
+            Repository::fromUserInput(m_repositoryDir->path()));
+    }
+
+    void addRows()
+    {
+        BenchmarkUtils::addOptionColumns(Columns);
+
+        QTest::newRow("100 components, loaded scripts") << 100 << int(SyntheticRepository::LoadedScript);
+        QTest::newRow("100 components, on demand scripts") << 100 << int(SyntheticRepository::OnDemandScript);
+        QTest::newRow("1000 components, loaded scripts") << 1000 << int(SyntheticRepository::LoadedScript);
+        QTest::newRow("1000 components, on demand scripts") << 1000 << int(SyntheticRepository::OnDemandScript);
+    }
+
+private slots:
+    void initTestCase()
+    {
+        BenchmarkUtils::initTestCase(true);
+    }
+
+    void init()
+    {
+        m_repositoryDir.reset(new QTemporaryDir);
+        m_installDir.reset(new QTemporaryDir);
+        m_cacheDir.reset(new QTemporaryDir);
+        QVERIFY(m_repositoryDir->isValid() && m_installDir->isValid() && m_cacheDir->isValid());
+    }
+
+    void cleanup()
+    {
+        m_repositoryDir.reset();
+        m_installDir.reset();
+        m_cacheDir.reset();
+    }
+
+    void buildComponentTree_data()
+    {
+        addRows();
+    }
+
+    void buildComponentTree()
+    {
+        generateRepository();
+        QScopedPointer<PackageManagerCore> core(createCore());
+        // Fill the local cache, so that the iterations measure loading the components.
+        QVERIFY(core->fetchRemotePackagesTree());
+
+        QBENCHMARK {
+            QVERIFY(core->fetchRemotePackagesTree());
+        }
+    }
+
+    void selectComponent_data()
+    {
+        addRows();
+    }
+
+    void selectComponent()
+    {
+        generateRepository();
+        QScopedPointer<PackageManagerCore> core(createCore());
+        QVERIFY(core->fetchRemotePackagesTree());
+
+        // The last component has the deepest dependency tree, whose scripts are evaluated
+        // once it is selected if they are evaluated on demand.
+        const QList<Component *> components = core->components(PackageManagerCore::ComponentType::Root);
+        components.last()->setCheckState(Qt::Checked);
+        QBENCHMARK_ONCE {
+            QVERIFY(core->fetchComponentsToInstallMetaData());
+        }
+        const QList<Component *> installed = core->orderedComponentsToInstall();
+        QVERIFY(!installed.isEmpty());
+        for (Component *component : installed)
+            QVERIFY(!component->isScriptDeferred());
+    }
+
+private:
+    QScopedPointer<QTemporaryDir> m_repositoryDir;
+    QScopedPointer<QTemporaryDir> m_installDir;
+    QScopedPointer<QTemporaryDir> m_cacheDir;
+};
+
+const BenchmarkUtils::Columns tst_componentscripts::Columns
+    = BenchmarkUtils::ComponentCount | BenchmarkUtils::ComponentScript;
+
+QTEST_MAIN(tst_componentscripts)
+
+#include "tst_componentscripts.moc"
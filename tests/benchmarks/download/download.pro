@@ -0,0 +1,6 @@
+include(../benchmark.pri)
+
+SOURCES += tst_download.cpp
+
+RESOURCES += \
+    ../../auto/installer/shared/config.qrc
@@ -0,0 +1,229 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "benchmarkutils.h"
+#include "httptestserver.h"
+
+#include <component.h>
+#include <downloadarchivesjob.h>
+#include <messageboxhandler.h>
+#include <metadatajob.h>
+#include <packagemanagercore.h>
+#include <repository.h>
+
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace QInstaller;
+
+Q_DECLARE_METATYPE(HttpTestServer::FailureMode)
+
+class tst_download : public QObject
+{
+    Q_OBJECT
+
+private:
+    HttpTestServer::Options serverOptions() const
+    {
+        QFETCH(int, latency);
+        QFETCH(qint64, bytesPerSecond);
+        QFETCH(bool, authenticate);
+        QFETCH(int, failEveryNthRequest);
+        QFETCH(HttpTestServer::FailureMode, failureMode);
+
+        HttpTestServer::Options options;
+        options.rootDir = m_repositoryDir.path();
+        options.latency = latency;
+        options.bytesPerSecond = bytesPerSecond;
+        if (authenticate) {
+            options.userName = QLatin1String("user");
+            options.password = QLatin1String("secret");
+        }
+        options.failEveryNthRequest = failEveryNthRequest;
+        options.failureMode = failureMode;
+        return options;
+    }
+
+    PackageManagerCore *createCore(const QUrl &url, bool authenticate) const
+    {
+        Repository repository(url, false);
+        if (authenticate) {
+            repository.setUsername(QLatin1String("user"));
+            repository.setPassword(QLatin1String("secret"));
+        }
+        return BenchmarkUtils::createCore(m_installDir.path(), m_cacheDir->path(), repository);
+    }
+
+    static void reportThroughput(qint64 bytes, qint64 nsecs)
+    {
+        QTest::setBenchmarkResult(bytes * 1e9 / qMax<qint64>(1, nsecs), QTest::BytesPerSecond);
+    }
+
+    void addMirrorRows()
+    {
+        QTest::addColumn<int>("latency");
+        QTest::addColumn<qint64>("bytesPerSecond");
+        QTest::addColumn<bool>("authenticate");
+        QTest::addColumn<int>("failEveryNthRequest");
+        QTest::addColumn<HttpTestServer::FailureMode>("failureMode");
+
+        QTest::newRow("local mirror") << 0 << qint64(0) << false << 0
+            << HttpTestServer::InternalServerError;
+        QTest::newRow("50 ms latency") << 50 << qint64(0) << false << 0
+            << HttpTestServer::InternalServerError;
+        QTest::newRow("200 ms latency, 4 MiB/s") << 200 << qint64(4 * 1024 * 1024) << false << 0
+            << HttpTestServer::InternalServerError;
+        QTest::newRow("basic authentication") << 0 << qint64(0) << true << 0
+            << HttpTestServer::InternalServerError;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        BenchmarkUtils::initTestCase(true);
+        // Failed downloads are retried instead of asking the user.
+        MessageBoxHandler::instance()->setAutomaticAnswer(QLatin1String("archiveDownloadError"),
+            QMessageBox::Retry);
+
+        QVERIFY(m_repositoryDir.isValid() && m_installDir.isValid());
+        SyntheticRepository::Options options;
+        options.componentCount = ComponentCount;
+        options.filesPerArchive = 4;
+        options.fileSize = 256 * 1024;
+        QString errorString;
+        QVERIFY2(BenchmarkUtils::generateRepository(SyntheticRepository(options),
+            m_repositoryDir.path(), &errorString), qPrintable(errorString));
+    }
+
+    void init()
+    {
+        m_cacheDir.reset(new QTemporaryDir);
+        QVERIFY(m_cacheDir->isValid());
+    }
+
+    void metadataJob_data()
+    {
+        addMirrorRows();
+    }
+
+    void metadataJob()
+    {
+        QFETCH(bool, authenticate);
+
+        HttpTestServer server(serverOptions());
+        QVERIFY(server.start());
+        QScopedPointer<PackageManagerCore> core(createCore(server.url(), authenticate));
+
+        QElapsedTimer timer;
+        timer.start();
+        MetadataJob job;
+        job.setPackageManagerCore(core.data());
+        job.start();
+        job.waitForFinished();
+        const qint64 elapsed = timer.nsecsElapsed();
+
+        QCOMPARE(job.error(), int(Job::NoError));
+        reportThroughput(server.bytesSent(), elapsed);
+    }
+
+    void downloadArchivesJob_data()
+    {
+        addMirrorRows();
+        QTest::newRow("every 5th request fails") << 0 << qint64(0) << false << 5
+            << HttpTestServer::InternalServerError;
+        QTest::newRow("every 5th connection drops") << 0 << qint64(0) << false << 5
+            << HttpTestServer::DropConnection;
+    }
+
+    void downloadArchivesJob()
+    {
+        QFETCH(bool, authenticate);
+        QFETCH(int, failEveryNthRequest);
+
+        HttpTestServer::Options options = serverOptions();
+        // Fetch the metadata from a reliable server, only the archive downloads are measured.
+        options.failEveryNthRequest = 0;
+        HttpTestServer metadataServer(options);
+        QVERIFY(metadataServer.start());
+        QScopedPointer<PackageManagerCore> core(createCore(metadataServer.url(), authenticate));
+        QVERIFY(core->fetchRemotePackagesTree());
+        const QString metadataUrl = metadataServer.url().toString();
+        metadataServer.stop();
+
+        QList<PackageManagerCore::DownloadItem> archives;
+        const QList<Component *> components
+            = core->components(PackageManagerCore::ComponentType::All);
+        for (Component *component : components) {
+            for (const QString &archive : component->downloadableArchives()) {
+                PackageManagerCore::DownloadItem item;
+                item.checkSha1CheckSum = true;
+                item.fileName = QString::fromLatin1("installer://%1/%2").arg(component->name(), archive);
+                item.sourceUrl = QString::fromLatin1("%1/%2/%3").arg(
+                    component->repositoryUrl().toString(), component->name(), archive);
+                archives.append(item);
+            }
+        }
+        QCOMPARE(archives.count(), ComponentCount);
+
+        options.failEveryNthRequest = failEveryNthRequest;
+        HttpTestServer server(options);
+        QVERIFY(server.start());
+        for (PackageManagerCore::DownloadItem &item : archives)
+            item.sourceUrl.replace(metadataUrl, server.url().toString());
+
+        DownloadArchivesJob job(core.data(), QLatin1String("downloadArchivesJob"));
+        job.setArchivesToDownload(archives);
+        connect(&job, &DownloadArchivesJob::fileDownloadReady, this, [](const QString &path) {
+            QFile::remove(path);
+        });
+
+        QElapsedTimer timer;
+        timer.start();
+        job.start();
+        job.waitForFinished();
+        const qint64 elapsed = timer.nsecsElapsed();
+
+        QCOMPARE(job.error(), int(Job::NoError));
+        QCOMPARE(job.numberOfDownloads(), archives.count());
+        if (failEveryNthRequest > 0)
+            QVERIFY(server.failedRequestCount() > 0);
+        reportThroughput(server.bytesSent(), elapsed);
+    }
+
+private:
+    static const int ComponentCount = 20;
+
+    QTemporaryDir m_repositoryDir;
+    QTemporaryDir m_installDir;
+    QScopedPointer<QTemporaryDir> m_cacheDir;
+};
+
+QTEST_MAIN(tst_download)
+
+#include "tst_download.moc"
@@ -0,0 +1,98 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "benchmarkutils.h"
+
+#include <archivefactory.h>
+#include <errors.h>
+
+#include <QDir>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace QInstaller;
+
+class tst_extract : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        BenchmarkUtils::initTestCase();
+    }
+
+    void extract_data()
+    {
+        BenchmarkUtils::addOptionColumns(BenchmarkUtils::FilesPerArchive
+            | BenchmarkUtils::FileSize | BenchmarkUtils::ArchiveFormat);
+
+        QTest::newRow("7z, 1000 small files") << 1000 << qint64(4 * 1024) << "7z";
+        QTest::newRow("7z, 10 large files") << 10 << qint64(8 * 1024 * 1024) << "7z";
+#ifdef IFW_LIBARCHIVE
+        QTest::newRow("zip, 1000 small files") << 1000 << qint64(4 * 1024) << "zip";
+        QTest::newRow("zip, 10 large files") << 10 << qint64(8 * 1024 * 1024) << "zip";
+        QTest::newRow("tar.gz, 10 large files") << 10 << qint64(8 * 1024 * 1024) << "tar.gz";
+        QTest::newRow("tar.xz, 10 large files") << 10 << qint64(8 * 1024 * 1024) << "tar.xz";
+#endif
+    }
+
+    void extract()
+    {
+        const SyntheticRepository::Options options = BenchmarkUtils::fetchOptions(
+            BenchmarkUtils::FilesPerArchive | BenchmarkUtils::FileSize | BenchmarkUtils::ArchiveFormat);
+
+        QTemporaryDir contentDir;
+        QVERIFY(contentDir.isValid());
+        try {
+            SyntheticRepository(options).generateContent(contentDir.filePath(QLatin1String("data")), 0);
+        } catch (const Error &error) {
+            QFAIL(qPrintable(error.message()));
+        }
+
+        const QString archivePath = contentDir.filePath(QLatin1String("content.") + options.archiveFormat);
+        {
+            QScopedPointer<AbstractArchive> archive(ArchiveFactory::instance().create(archivePath));
+            QVERIFY(archive);
+            QVERIFY(archive->open(QIODevice::WriteOnly));
+            QVERIFY2(archive->create(QStringList() << contentDir.filePath(QLatin1String("data"))),
+                qPrintable(archive->errorString()));
+        }
+
+        QBENCHMARK {
+            QTemporaryDir targetDir;
+            QScopedPointer<AbstractArchive> archive(ArchiveFactory::instance().create(archivePath));
+            QVERIFY(archive->open(QIODevice::ReadOnly));
+            QVERIFY2(archive->extract(targetDir.path()), qPrintable(archive->errorString()));
+        }
+    }
+};
+
+QTEST_MAIN(tst_extract)
+
+#include "tst_extract.moc"
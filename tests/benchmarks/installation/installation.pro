@@ -0,0 +1,6 @@
+include(../benchmark.pri)
+
+SOURCES += tst_installation.cpp
+
+RESOURCES += \
+    ../../auto/installer/shared/config.qrc
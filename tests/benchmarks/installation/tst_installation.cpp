@@ -0,0 +1,162 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "benchmarkutils.h"
+
+#include <packagemanagercore.h>
+#include <repository.h>
+
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace QInstaller;
+
+class tst_installation : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const BenchmarkUtils::Columns Columns;
+
+    void generateRepository()
+    {
+        m_generator = SyntheticRepository(BenchmarkUtils::fetchOptions(Columns));
+        QString errorString;
+        QVERIFY2(BenchmarkUtils::generateRepository(m_generator, m_repositoryDir->path(),
+            &errorString), qPrintable(errorString));
+    }
+
+    PackageManagerCore *createCore()
+    {
+        return BenchmarkUtils::createCore(m_installDir->path(), m_cacheDir->path(),
+            Repository::fromUserInput(m_repositoryDir->path()));
+    }
+
+    void install()
+    {
+        QScopedPointer<PackageManagerCore> core(createCore());
+        QCOMPARE(core->installSelectedComponentsSilently(m_generator.componentNames()),
+            PackageManagerCore::Success);
+        core->commitSessionOperations();
+    }
+
+    void addRows()
+    {
+        BenchmarkUtils::addOptionColumns(Columns);
+
+        QTest::newRow("10 components, 100 files each") << 10 << 100;
+        QTest::newRow("100 components, 10 files each") << 100 << 10;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        BenchmarkUtils::initTestCase(true);
+    }
+
+    void init()
+    {
+        m_repositoryDir.reset(new QTemporaryDir);
+        m_installDir.reset(new QTemporaryDir);
+        m_cacheDir.reset(new QTemporaryDir);
+        QVERIFY(m_repositoryDir->isValid() && m_installDir->isValid() && m_cacheDir->isValid());
+    }
+
+    void cleanup()
+    {
+        m_repositoryDir.reset();
+        m_installDir.reset();
+        m_cacheDir.reset();
+    }
+
+    void installAll_data()
+    {
+        addRows();
+    }
+
+    void installAll()
+    {
+        generateRepository();
+
+        QBENCHMARK_ONCE {
+            install();
+        }
+    }
+
+    void uninstallAll_data()
+    {
+        addRows();
+    }
+
+    void uninstallAll()
+    {
+        generateRepository();
+        install();
+
+        QScopedPointer<PackageManagerCore> core(createCore());
+        core->setPackageManager();
+        QBENCHMARK_ONCE {
+            QCOMPARE(core->uninstallComponentsSilently(m_generator.componentNames()),
+                PackageManagerCore::Success);
+        }
+    }
+
+    void maintenanceToolStartup_data()
+    {
+        addRows();
+    }
+
+    void maintenanceToolStartup()
+    {
+        QFETCH(int, componentCount);
+        generateRepository();
+        install();
+
+        // Reading the installed components and fetching the remote metadata is what keeps
+        // the maintenance tool busy before its first page is shown.
+        QBENCHMARK {
+            QScopedPointer<PackageManagerCore> core(createCore());
+            core->setPackageManager();
+            QVERIFY(core->fetchRemotePackagesTree());
+            QCOMPARE(core->localInstalledPackages().count(), componentCount);
+        }
+    }
+
+private:
+    SyntheticRepository m_generator;
+    QScopedPointer<QTemporaryDir> m_repositoryDir;
+    QScopedPointer<QTemporaryDir> m_installDir;
+    QScopedPointer<QTemporaryDir> m_cacheDir;
+};
+
+const BenchmarkUtils::Columns tst_installation::Columns
+    = BenchmarkUtils::ComponentCount | BenchmarkUtils::FilesPerArchive;
+
+QTEST_MAIN(tst_installation)
+
+#include "tst_installation.moc"
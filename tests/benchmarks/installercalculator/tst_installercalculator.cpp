@@ -0,0 +1,99 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "benchmarkutils.h"
+
+#include <installercalculator.h>
+#include <packagemanagercore.h>
+
+#include <QTest>
+
+using namespace QInstaller;
+
+class tst_installercalculator : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const BenchmarkUtils::Columns Columns;
+
+    void addRows()
+    {
+        BenchmarkUtils::addOptionColumns(Columns);
+
+        QTest::newRow("1000 components, fan-out 2") << 1000 << 2;
+        QTest::newRow("1000 components, fan-out 10") << 1000 << 10;
+        QTest::newRow("10000 components, fan-out 2") << 10000 << 2;
+        QTest::newRow("10000 components, fan-out 10") << 10000 << 10;
+    }
+
+private slots:
+    void solveSingleComponent_data()
+    {
+        addRows();
+    }
+
+    void solveSingleComponent()
+    {
+        QScopedPointer<PackageManagerCore> core(BenchmarkUtils::createCore(
+            SyntheticRepository(BenchmarkUtils::fetchOptions(Columns))));
+
+        // The last component has the deepest dependency tree.
+        const QList<Component *> selected = { core->components(PackageManagerCore::ComponentType::Root).last() };
+        QBENCHMARK {
+            InstallerCalculator calc(core.data(), AutoDependencyHash());
+            QVERIFY(calc.solve(selected));
+        }
+    }
+
+    void solveAllComponents_data()
+    {
+        addRows();
+    }
+
+    void solveAllComponents()
+    {
+        QFETCH(int, componentCount);
+        QScopedPointer<PackageManagerCore> core(BenchmarkUtils::createCore(
+            SyntheticRepository(BenchmarkUtils::fetchOptions(Columns))));
+
+        const QList<Component *> selected = core->components(PackageManagerCore::ComponentType::Root);
+        QBENCHMARK {
+            InstallerCalculator calc(core.data(), AutoDependencyHash());
+            QVERIFY(calc.solve(selected));
+            QCOMPARE(calc.resolvedComponents().count(), componentCount);
+        }
+    }
+};
+
+const BenchmarkUtils::Columns tst_installercalculator::Columns
+    = BenchmarkUtils::ComponentCount | BenchmarkUtils::DependencyFanOut;
+
+QTEST_MAIN(tst_installercalculator)
+
+#include "tst_installercalculator.moc"
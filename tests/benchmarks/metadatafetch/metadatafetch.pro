@@ -0,0 +1,3 @@
+include(../benchmark.pri)
+
+SOURCES += tst_metadatafetch.cpp
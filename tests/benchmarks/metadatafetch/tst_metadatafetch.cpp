@@ -0,0 +1,96 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "benchmarkutils.h"
+
+#include <metadatajob.h>
+#include <packagemanagercore.h>
+#include <settings.h>
+
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace QInstaller;
+
+class tst_metadatafetch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        BenchmarkUtils::initTestCase();
+    }
+
+    void fetchFromLocalRepository_data()
+    {
+        BenchmarkUtils::addOptionColumns(BenchmarkUtils::ComponentCount
+            | BenchmarkUtils::DependencyFanOut);
+
+        QTest::newRow("100 components") << 100 << 2;
+        QTest::newRow("1000 components") << 1000 << 2;
+        QTest::newRow("1000 components, fan-out 10") << 1000 << 10;
+    }
+
+    void fetchFromLocalRepository()
+    {
+        SyntheticRepository::Options defaults;
+        defaults.filesPerArchive = 1;
+        defaults.fileSize = 1024;
+        const SyntheticRepository generator(BenchmarkUtils::fetchOptions(
+            BenchmarkUtils::ComponentCount | BenchmarkUtils::DependencyFanOut, defaults));
+
+        QTemporaryDir repositoryDir;
+        QVERIFY(repositoryDir.isValid());
+        QString errorString;
+        QVERIFY2(BenchmarkUtils::generateRepository(generator, repositoryDir.path(), &errorString),
+            qPrintable(errorString));
+
+        PackageManagerCore core;
+        core.setInstaller();
+        QSet<Repository> repoList;
+        repoList.insert(Repository::fromUserInput(repositoryDir.path()));
+        core.settings().setDefaultRepositories(repoList);
+
+        QBENCHMARK {
+            // Start from an empty cache so that every iteration downloads and extracts the metadata.
+            QTemporaryDir cacheDir;
+            core.settings().setLocalCachePath(cacheDir.path());
+
+            MetadataJob job;
+            job.setPackageManagerCore(&core);
+            job.start();
+            job.waitForFinished();
+            QCOMPARE(job.error(), int(Job::NoError));
+        }
+    }
+};
+
+QTEST_MAIN(tst_metadatafetch)
+
+#include "tst_metadatafetch.moc"
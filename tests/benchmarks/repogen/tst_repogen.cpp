@@ -0,0 +1,85 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "benchmarkutils.h"
+
+#include <errors.h>
+
+#include <QTemporaryDir>
+#include <QTest>
+
+class tst_repogen : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        BenchmarkUtils::initTestCase();
+    }
+
+    void generateRepository_data()
+    {
+        BenchmarkUtils::addOptionColumns(BenchmarkUtils::ComponentCount
+            | BenchmarkUtils::FilesPerArchive | BenchmarkUtils::ArchiveFormat);
+
+        QTest::newRow("10 components, 7z") << 10 << 10 << "7z";
+        QTest::newRow("100 components, 7z") << 100 << 10 << "7z";
+        QTest::newRow("1000 components, 7z") << 1000 << 1 << "7z";
+#ifdef IFW_LIBARCHIVE
+        QTest::newRow("100 components, zip") << 100 << 10 << "zip";
+        QTest::newRow("100 components, tar.gz") << 100 << 10 << "tar.gz";
+        QTest::newRow("100 components, tar.xz") << 100 << 10 << "tar.xz";
+#endif
+    }
+
+    void generateRepository()
+    {
+        const SyntheticRepository generator(BenchmarkUtils::fetchOptions(
+            BenchmarkUtils::ComponentCount | BenchmarkUtils::FilesPerArchive
+            | BenchmarkUtils::ArchiveFormat));
+
+        QTemporaryDir packagesDir;
+        QTemporaryDir repositoryDir;
+        QVERIFY(packagesDir.isValid() && repositoryDir.isValid());
+
+        try {
+            generator.generatePackages(packagesDir.path());
+            QBENCHMARK_ONCE {
+                generator.generateRepository(packagesDir.path(), repositoryDir.path());
+            }
+        } catch (const QInstaller::Error &error) {
+            QFAIL(qPrintable(error.message()));
+        }
+        QVERIFY(QFileInfo::exists(repositoryDir.filePath(QLatin1String("Updates.xml"))));
+    }
+};
+
+QTEST_MAIN(tst_repogen)
+
+#include "tst_repogen.moc"
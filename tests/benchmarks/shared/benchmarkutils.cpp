@@ -0,0 +1,179 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "benchmarkutils.h"
+#include "../../auto/installer/shared/packagemanager.h"
+
+#include <component.h>
+#include <constants.h>
+#include <errors.h>
+#include <init.h>
+#include <packagemanagercore.h>
+#include <repository.h>
+#include <settings.h>
+
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace QInstaller;
+
+namespace BenchmarkUtils {
+
+/*!
+    \namespace BenchmarkUtils
+    \internal
+
+    Helpers shared by the benchmarks, so that every benchmark sets up its data rows,
+    repositories and package manager cores the same way.
+*/
+
+/*!
+    Initializes the installer library for a benchmark. Debug output is disabled, all
+    output is dropped if \a silent is \c true.
+*/
+void initTestCase(bool silent)
+{
+    QInstaller::init();
+    if (silent)
+        qInstallMessageHandler(silentTestMessageHandler);
+    else
+        QLoggingCategory::setFilterRules(QLatin1String("*.debug=false"));
+}
+
+/*!
+    Adds a data column for each of the SyntheticRepository options in \a columns, in the
+    order of the Column enum.
+*/
+void addOptionColumns(Columns columns)
+{
+    if (columns & ComponentCount)
+        QTest::addColumn<int>("componentCount");
+    if (columns & DependencyFanOut)
+        QTest::addColumn<int>("dependencyFanOut");
+    if (columns & FilesPerArchive)
+        QTest::addColumn<int>("filesPerArchive");
+    if (columns & FileSize)
+        QTest::addColumn<qint64>("fileSize");
+    if (columns & ArchiveFormat)
+        QTest::addColumn<QString>("archiveFormat");
+    if (columns & ComponentScript)
+        QTest::addColumn<int>("componentScript");
+}
+
+/*!
+    Returns \a defaults with the options in \a columns replaced by the values of the
+    current data row. The columns must have been added with addOptionColumns().
+*/
+SyntheticRepository::Options fetchOptions(Columns columns,
+    const SyntheticRepository::Options &defaults)
+{
+    SyntheticRepository::Options options = defaults;
+    if (columns & ComponentCount) {
+        QFETCH(int, componentCount);
+        options.componentCount = componentCount;
+    }
+    if (columns & DependencyFanOut) {
+        QFETCH(int, dependencyFanOut);
+        options.dependencyFanOut = dependencyFanOut;
+    }
+    if (columns & FilesPerArchive) {
+        QFETCH(int, filesPerArchive);
+        options.filesPerArchive = filesPerArchive;
+    }
+    if (columns & FileSize) {
+        QFETCH(qint64, fileSize);
+        options.fileSize = fileSize;
+    }
+    if (columns & ArchiveFormat) {
+        QFETCH(QString, archiveFormat);
+        options.archiveFormat = archiveFormat;
+    }
+    if (columns & ComponentScript) {
+        QFETCH(int, componentScript);
+        options.componentScript = SyntheticRepository::ComponentScript(componentScript);
+    }
+    return options;
+}
+
+/*!
+    Generates the packages of \a generator in a temporary directory and a repository
+    from them in \a repositoryDir. Returns \c false and sets \a errorString on failure.
+*/
+bool generateRepository(const SyntheticRepository &generator, const QString &repositoryDir,
+    QString *errorString)
+{
+    QTemporaryDir packagesDir;
+    if (!packagesDir.isValid()) {
+        *errorString = packagesDir.errorString();
+        return false;
+    }
+    try {
+        generator.generatePackages(packagesDir.path());
+        generator.generateRepository(packagesDir.path(), repositoryDir);
+    } catch (const Error &error) {
+        *errorString = error.message();
+        return false;
+    }
+    return true;
+}
+
+/*!
+    Creates a package manager core with the components of \a generator added as root
+    components, without generating their packages.
+*/
+PackageManagerCore *createCore(const SyntheticRepository &generator)
+{
+    PackageManagerCore *core = new PackageManagerCore;
+    core->setPackageManager();
+    const int count = generator.options().componentCount;
+    for (int i = 0; i < count; ++i) {
+        Component *component = new Component(core);
+        component->setValue(scName, SyntheticRepository::componentName(i));
+        component->setValue(scVersion, QLatin1String("1.0.0"));
+        for (const QString &dependency : generator.dependencies(i))
+            component->addDependency(dependency);
+        core->appendRootComponent(component);
+    }
+    return core;
+}
+
+/*!
+    Creates an installer core that installs to \a targetDir from \a repository and
+    keeps its local cache in \a cacheDir.
+*/
+PackageManagerCore *createCore(const QString &targetDir, const QString &cacheDir,
+    const Repository &repository)
+{
+    PackageManagerCore *core = PackageManager::getPackageManager(targetDir);
+    core->settings().setLocalCachePath(cacheDir);
+    core->settings().setDefaultRepositories(QSet<Repository>() << repository);
+    return core;
+}
+
+} // namespace BenchmarkUtils
@@ -0,0 +1,71 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#ifndef BENCHMARKUTILS_H
+#define BENCHMARKUTILS_H
+
+#include "syntheticrepository.h"
+
+#include <QFlags>
+#include <QString>
+
+namespace QInstaller {
+class PackageManagerCore;
+class Repository;
+}
+
+namespace BenchmarkUtils {
+
+enum Column {
+    ComponentCount = 0x01,
+    DependencyFanOut = 0x02,
+    FilesPerArchive = 0x04,
+    FileSize = 0x08,
+    ArchiveFormat = 0x10,
+    ComponentScript = 0x20
+};
+Q_DECLARE_FLAGS(Columns, Column)
+
+void initTestCase(bool silent = false);
+
+void addOptionColumns(Columns columns);
+SyntheticRepository::Options fetchOptions(Columns columns,
+    const SyntheticRepository::Options &defaults = SyntheticRepository::Options());
+
+bool generateRepository(const SyntheticRepository &generator, const QString &repositoryDir,
+    QString *errorString);
+
+QInstaller::PackageManagerCore *createCore(const SyntheticRepository &generator);
+QInstaller::PackageManagerCore *createCore(const QString &targetDir, const QString &cacheDir,
+    const QInstaller::Repository &repository);
+
+} // namespace BenchmarkUtils
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(BenchmarkUtils::Columns)
+
+#endif // BENCHMARKUTILS_H
@@ -0,0 +1,367 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "httptestserver.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+/*!
+    \class HttpTestServer
+    \internal
+
+    A minimal HTTP/1.1 server for download tests and benchmarks. It serves the files
+    below a root directory from its own thread and can simulate slow or unreliable
+    mirrors: every request can be delayed, the response bodies can be throttled to a
+    fixed bandwidth, and every n-th request can fail. The server supports GET, HEAD,
+    single byte ranges and basic authentication. Every response closes the connection.
+*/
+
+static const qint64 ChunkSize = 64 * 1024;
+static const int ThrottleInterval = 20; // ms
+
+class HttpTestConnection : public QObject
+{
+public:
+    HttpTestConnection(QTcpSocket *socket, const HttpTestServer::Options &options,
+            HttpTestServer::Statistics *statistics)
+        : QObject(socket)
+        , m_socket(socket)
+        , m_options(options)
+        , m_statistics(statistics)
+    {
+        connect(socket, &QTcpSocket::readyRead, this, &HttpTestConnection::onReadyRead);
+        connect(socket, &QTcpSocket::bytesWritten, this, &HttpTestConnection::onBytesWritten);
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(&m_throttleTimer, &QTimer::timeout, this, [this] {
+            writeChunk(qMax<qint64>(1, m_options.bytesPerSecond * ThrottleInterval / 1000));
+        });
+    }
+
+private:
+    void onReadyRead()
+    {
+        if (m_requestComplete) {
+            m_socket->readAll();
+            return;
+        }
+        m_request += m_socket->readAll();
+        const int end = m_request.indexOf("\r\n\r\n");
+        if (end < 0) {
+            if (m_request.size() > ChunkSize)
+                m_socket->abort();
+            return;
+        }
+        m_requestComplete = true;
+
+        const QList<QByteArray> lines = m_request.left(end).split('\n');
+        const QList<QByteArray> requestLine = lines.value(0).trimmed().split(' ');
+        QHash<QByteArray, QByteArray> headers;
+        for (int i = 1; i < lines.count(); ++i) {
+            const int colon = lines.at(i).indexOf(':');
+            if (colon > 0)
+                headers.insert(lines.at(i).left(colon).trimmed().toLower(), lines.at(i).mid(colon + 1).trimmed());
+        }
+
+        QTimer::singleShot(m_options.latency, this, [this, requestLine, headers] {
+            respond(requestLine.value(0), requestLine.value(1), headers);
+        });
+    }
+
+    void respond(const QByteArray &method, const QByteArray &target,
+        const QHash<QByteArray, QByteArray> &headers)
+    {
+        const int number = ++m_statistics->requestCount;
+        if (m_options.failEveryNthRequest > 0 && number % m_options.failEveryNthRequest == 0) {
+            ++m_statistics->failedRequestCount;
+            if (m_options.failureMode == HttpTestServer::InternalServerError) {
+                sendResponse(500, "Internal Server Error");
+                return;
+            }
+            m_dropConnection = true;
+        }
+
+        if (!m_options.userName.isEmpty()) {
+            const QByteArray credentials = QString(m_options.userName + QLatin1Char(':')
+                + m_options.password).toUtf8().toBase64();
+            if (headers.value("authorization") != "Basic " + credentials) {
+                sendResponse(401, "Unauthorized", "WWW-Authenticate: Basic realm=\"HttpTestServer\"\r\n");
+                return;
+            }
+        }
+
+        if (method != "GET" && method != "HEAD") {
+            sendResponse(405, "Method Not Allowed", "Allow: GET, HEAD\r\n");
+            return;
+        }
+
+        const int query = target.indexOf('?');
+        const QString path = QDir::cleanPath(QUrl::fromPercentEncoding(target.left(query)));
+        if (!path.startsWith(QLatin1Char('/')) || path.contains(QLatin1String(".."))) {
+            sendResponse(400, "Bad Request");
+            return;
+        }
+
+        m_file.setFileName(m_options.rootDir + path);
+        if (!QFileInfo(m_file).isFile() || !m_file.open(QIODevice::ReadOnly)) {
+            sendResponse(404, "Not Found");
+            return;
+        }
+
+        const qint64 size = m_file.size();
+        qint64 first = 0;
+        qint64 last = size - 1;
+        QByteArray extraHeaders = "Accept-Ranges: bytes\r\n";
+        int status = 200;
+        const QByteArray range = headers.value("range");
+        if (!range.isEmpty()) {
+            if (!parseRange(range, size, &first, &last)) {
+                sendResponse(416, "Range Not Satisfiable", "Content-Range: bytes */"
+                    + QByteArray::number(size) + "\r\n");
+                return;
+            }
+            status = 206;
+            extraHeaders += "Content-Range: bytes " + QByteArray::number(first) + '-'
+                + QByteArray::number(last) + '/' + QByteArray::number(size) + "\r\n";
+        }
+
+        m_remaining = last - first + 1;
+        writeHeader(status, status == 206 ? "Partial Content" : "OK", m_remaining, extraHeaders);
+        if (method == "HEAD" || m_remaining == 0) {
+            finish();
+            return;
+        }
+
+        m_file.seek(first);
+        // A dropped connection delivers the first half of the body only.
+        if (m_dropConnection)
+            m_remaining /= 2;
+        if (m_options.bytesPerSecond > 0)
+            m_throttleTimer.start(ThrottleInterval);
+        else
+            writeChunk(ChunkSize);
+    }
+
+    static bool parseRange(const QByteArray &range, qint64 size, qint64 *first, qint64 *last)
+    {
+        if (!range.startsWith("bytes=") || range.contains(','))
+            return false;
+        const QByteArray spec = range.mid(6).trimmed();
+        const int dash = spec.indexOf('-');
+        if (dash < 0)
+            return false;
+
+        bool ok = true;
+        if (dash == 0) {
+            // Suffix range: the last n bytes of the file.
+            const qint64 length = spec.mid(1).toLongLong(&ok);
+            if (!ok || length <= 0)
+                return false;
+            *first = qMax<qint64>(0, size - length);
+            *last = size - 1;
+            return size > 0;
+        }
+
+        *first = spec.left(dash).toLongLong(&ok);
+        if (!ok)
+            return false;
+        *last = size - 1;
+        if (dash < spec.size() - 1) {
+            *last = qMin(spec.mid(dash + 1).toLongLong(&ok), size - 1);
+            if (!ok)
+                return false;
+        }
+        return *first < size && *first <= *last;
+    }
+
+    void onBytesWritten()
+    {
+        if (!m_throttleTimer.isActive() && m_remaining > 0 && m_socket->bytesToWrite() < ChunkSize)
+            writeChunk(ChunkSize);
+    }
+
+    void writeChunk(qint64 maxSize)
+    {
+        if (m_finished)
+            return;
+        const QByteArray data = m_file.read(qMin(maxSize, m_remaining));
+        if (data.isEmpty()) {
+            finish();
+            return;
+        }
+        m_socket->write(data);
+        m_remaining -= data.size();
+        m_statistics->bytesSent += data.size();
+        if (m_remaining == 0)
+            finish();
+    }
+
+    void writeHeader(int status, const QByteArray &reason, qint64 contentLength,
+        const QByteArray &extraHeaders = QByteArray())
+    {
+        QByteArray header = "HTTP/1.1 " + QByteArray::number(status) + ' ' + reason + "\r\n"
+            "Content-Type: application/octet-stream\r\n"
+            "Content-Length: " + QByteArray::number(contentLength) + "\r\n"
+            "Connection: close\r\n" + extraHeaders + "\r\n";
+        m_socket->write(header);
+    }
+
+    void sendResponse(int status, const QByteArray &reason,
+        const QByteArray &extraHeaders = QByteArray())
+    {
+        writeHeader(status, reason, reason.size(), extraHeaders);
+        m_socket->write(reason);
+        finish();
+    }
+
+    void finish()
+    {
+        if (m_finished)
+            return;
+        m_finished = true;
+        m_throttleTimer.stop();
+        m_file.close();
+        if (m_dropConnection) {
+            m_socket->flush();
+            m_socket->abort();
+        } else {
+            m_socket->disconnectFromHost();
+        }
+    }
+
+private:
+    QTcpSocket *m_socket;
+    const HttpTestServer::Options m_options;
+    HttpTestServer::Statistics *m_statistics;
+
+    QByteArray m_request;
+    bool m_requestComplete = false;
+    bool m_dropConnection = false;
+    bool m_finished = false;
+
+    QFile m_file;
+    qint64 m_remaining = 0;
+    QTimer m_throttleTimer;
+};
+
+class HttpTestListener : public QTcpServer
+{
+public:
+    HttpTestListener(const HttpTestServer::Options &options, HttpTestServer::Statistics *statistics)
+        : m_options(options)
+        , m_statistics(statistics)
+    {}
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override
+    {
+        QTcpSocket *socket = new QTcpSocket(this);
+        if (!socket->setSocketDescriptor(socketDescriptor)) {
+            delete socket;
+            return;
+        }
+        new HttpTestConnection(socket, m_options, m_statistics);
+    }
+
+private:
+    const HttpTestServer::Options m_options;
+    HttpTestServer::Statistics *m_statistics;
+};
+
+
+/*!
+    Creates a server for the files below the root directory in \a options with
+    \a parent. Call start() to start listening.
+*/
+HttpTestServer::HttpTestServer(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_listener(nullptr)
+    , m_port(0)
+{
+    m_thread.setObjectName(QLatin1String("HttpTestServer"));
+}
+
+HttpTestServer::~HttpTestServer()
+{
+    stop();
+}
+
+/*!
+    Starts listening on the port set in the options of the local host, or on a free
+    port if it is \c 0. Returns \c true on success.
+*/
+bool HttpTestServer::start()
+{
+    if (m_listener)
+        return true;
+
+    m_listener = new HttpTestListener(m_options, &m_statistics);
+    m_listener->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_listener, &QObject::deleteLater);
+    m_thread.start();
+
+    bool listening = false;
+    QMetaObject::invokeMethod(m_listener, [this, &listening] {
+        listening = m_listener->listen(QHostAddress::LocalHost, m_options.port);
+        m_port = m_listener->serverPort();
+    }, Qt::BlockingQueuedConnection);
+
+    if (!listening)
+        stop();
+    return listening;
+}
+
+/*!
+    Stops the server and closes all open connections.
+*/
+void HttpTestServer::stop()
+{
+    if (!m_thread.isRunning())
+        return;
+    m_thread.quit();
+    m_thread.wait();
+    m_listener = nullptr;
+    m_port = 0;
+}
+
+/*!
+    Returns the base URL of the server, or an empty URL if the server is not running.
+*/
+QUrl HttpTestServer::url() const
+{
+    if (!m_port)
+        return QUrl();
+    return QUrl(QString::fromLatin1("http://127.0.0.1:%1").arg(m_port));
+}
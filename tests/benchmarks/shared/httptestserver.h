@@ -0,0 +1,89 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#ifndef HTTPTESTSERVER_H
+#define HTTPTESTSERVER_H
+
+#include <QObject>
+#include <QThread>
+#include <QUrl>
+
+#include <atomic>
+
+class HttpTestListener;
+
+class HttpTestServer : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(HttpTestServer)
+
+public:
+    enum FailureMode {
+        InternalServerError,
+        DropConnection
+    };
+
+    struct Options
+    {
+        QString rootDir;
+        quint16 port = 0;
+        int latency = 0;
+        qint64 bytesPerSecond = 0;
+        QString userName;
+        QString password;
+        int failEveryNthRequest = 0;
+        FailureMode failureMode = InternalServerError;
+    };
+
+    struct Statistics
+    {
+        std::atomic<int> requestCount { 0 };
+        std::atomic<int> failedRequestCount { 0 };
+        std::atomic<qint64> bytesSent { 0 };
+    };
+
+    explicit HttpTestServer(const Options &options, QObject *parent = nullptr);
+    ~HttpTestServer() override;
+
+    bool start();
+    void stop();
+
+    QUrl url() const;
+    int requestCount() const { return m_statistics.requestCount; }
+    int failedRequestCount() const { return m_statistics.failedRequestCount; }
+    qint64 bytesSent() const { return m_statistics.bytesSent; }
+
+private:
+    Options m_options;
+    Statistics m_statistics;
+    QThread m_thread;
+    HttpTestListener *m_listener;
+    quint16 m_port;
+};
+
+#endif // HTTPTESTSERVER_H
@@ -0,0 +1,183 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#include "syntheticrepository.h"
+
+#include <errors.h>
+#include <fileio.h>
+#include <repositorygen.h>
+
+#include <QDir>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+using namespace QInstaller;
+
+/*!
+    \class SyntheticRepository
+    \internal
+
+    Generates package directories and repositories of configurable size for the
+    benchmarks. The generated content depends only on the options, so two runs
+    with the same options produce identical repositories.
+*/
+
+SyntheticRepository::SyntheticRepository(const Options &options)
+    : m_options(options)
+{
+}
+
+/*!
+    Returns the name of the component at \a index.
+*/
+QString SyntheticRepository::componentName(int index)
+{
+    return QString::fromLatin1("benchmark.component%1").arg(index, 5, 10, QLatin1Char('0'));
+}
+
+/*!
+    Returns the names of all generated components.
+*/
+QStringList SyntheticRepository::componentNames() const
+{
+    QStringList names;
+    names.reserve(m_options.componentCount);
+    for (int i = 0; i < m_options.componentCount; ++i)
+        names.append(componentName(i));
+    return names;
+}
+
+/*!
+    Returns the dependencies of the component at \a index. A component only depends
+    on components with a lower index, which keeps the dependency graph acyclic.
+*/
+QStringList SyntheticRepository::dependencies(int index) const
+{
+    QStringList result;
+    for (int i = 1; i <= m_options.dependencyFanOut && index > 0; ++i) {
+        const QString dependency = componentName((index * 7 + i * 13) % index);
+        if (!result.contains(dependency))
+            result.append(dependency);
+    }
+    return result;
+}
+
+/*!
+    Writes the data files of the component at \a index to \a targetDir.
+*/
+void SyntheticRepository::generateContent(const QString &targetDir, int index) const
+{
+    if (!QDir().mkpath(targetDir))
+        throw Error(QString::fromLatin1("Cannot create directory \"%1\".").arg(targetDir));
+
+    // Restricting the random bytes to a small alphabet keeps the data compressible.
+    static const char alphabet[] = "abcdefghijklmnop";
+    QRandomGenerator generator(quint32(index) + 1);
+    QByteArray data(m_options.fileSize, Qt::Uninitialized);
+    for (int i = 0; i < m_options.filesPerArchive; ++i) {
+        for (char &c : data)
+            c = alphabet[generator.bounded(16)];
+
+        QFile file(QString::fromLatin1("%1/file%2.txt").arg(targetDir).arg(i));
+        openForWrite(&file);
+        blockingWrite(&file, data);
+    }
+}
+
+/*!
+    Creates a package directory for every component below \a packagesDir, in the layout
+    expected by repogen.
+*/
+void SyntheticRepository::generatePackages(const QString &packagesDir) const
+{
+    for (int i = 0; i < m_options.componentCount; ++i) {
+        const QString name = componentName(i);
+        const QString metaDir = QString::fromLatin1("%1/%2/meta").arg(packagesDir, name);
+        if (!QDir().mkpath(metaDir))
+            throw Error(QString::fromLatin1("Cannot create directory \"%1\".").arg(metaDir));
+
+        QFile packageXml(metaDir + QLatin1String("/package.xml"));
+        openForWrite(&packageXml);
+        QByteArray xml = "<?xml version=\"1.0\"?>\n<Package>\n"
+            "    <DisplayName>" + name.toUtf8() + "</DisplayName>\n"
+            "    <Description>Synthetic benchmark component</Description>\n"
+            "    <Version>1.0.0</Version>\n"
+            "    <ReleaseDate>2024-01-01</ReleaseDate>\n";
+        const QStringList dependencies = this->dependencies(i);
+        if (!dependencies.isEmpty())
+            xml += "    <Dependencies>" + dependencies.join(QLatin1Char(',')).toUtf8() + "</Dependencies>\n";
+        if (m_options.componentScript == LoadedScript)
+            xml += "    <Script>installscript.qs</Script>\n";
+        else if (m_options.componentScript == OnDemandScript)
+            xml += "    <Script onDemand=\"true\">installscript.qs</Script>\n";
+        xml += "</Package>\n";
+        blockingWrite(&packageXml, xml);
+
+        if (m_options.componentScript != NoScript) {
+            QFile script(metaDir + QLatin1String("/installscript.qs"));
+            openForWrite(&script);
+            blockingWrite(&script, QByteArray("function Component()\n"
+                "{\n"
+                "    component.setValue(\"BenchmarkValue\", component.name);\n"
+                "}\n"
+                "\n"
+                "Component.prototype.createOperations = function()\n"
+                "{\n"
+                "    component.createOperations();\n"
+                "}\n"));
+        }
+
+        generateContent(QString::fromLatin1("%1/%2/data").arg(packagesDir, name), i);
+    }
+}
+
+/*!
+    Runs repogen on \a packagesDir and writes the repository to \a repositoryDir. The
+    content archives use the configured archive format.
+*/
+void SyntheticRepository::generateRepository(const QString &packagesDir,
+    const QString &repositoryDir) const
+{
+    if (!QDir().mkpath(repositoryDir))
+        throw Error(QString::fromLatin1("Cannot create directory \"%1\".").arg(repositoryDir));
+
+    QInstallerTools::RepositoryInfo info;
+    info.packages << packagesDir;
+    info.repositoryDir = repositoryDir;
+
+    QStringList filteredPackages;
+    QInstallerTools::PackageInfoVector packages = QInstallerTools::collectPackages(info,
+        &filteredPackages, QInstallerTools::Exclude, false, QStringList());
+
+    QTemporaryDir tmpMetaDir;
+    if (!tmpMetaDir.isValid())
+        throw Error(QString::fromLatin1("Cannot create temporary directory."));
+    QInstallerTools::createRepository(info, &packages, tmpMetaDir.path(), true, false,
+        m_options.archiveFormat);
+}
@@ -0,0 +1,70 @@
+/**************************************************************************
+**
+** Copyright (C) 2024 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Installer Framework.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+**************************************************************************/
+
+#ifndef SYNTHETICREPOSITORY_H
+#define SYNTHETICREPOSITORY_H
+
+#include <QString>
+#include <QStringList>
+
+class SyntheticRepository
+{
+public:
+    enum ComponentScript {
+        NoScript,
+        LoadedScript,
+        OnDemandScript
+    };
+
+    struct Options
+    {
+        int componentCount = 100;
+        int dependencyFanOut = 2;
+        int filesPerArchive = 10;
+        qint64 fileSize = 16 * 1024;
+        QString archiveFormat = QLatin1String("7z");
+        ComponentScript componentScript = NoScript;
+    };
+
+    explicit SyntheticRepository(const Options &options = Options());
+
+    Options options() const { return m_options; }
+
+    static QString componentName(int index);
+    QStringList componentNames() const;
+    QStringList dependencies(int index) const;
+
+    void generateContent(const QString &targetDir, int index) const;
+    void generatePackages(const QString &packagesDir) const;
+    void generateRepository(const QString &packagesDir, const QString &repositoryDir) const;
+
+private:
+    Options m_options;
+};
+
+#endif // SYNTHETICREPOSITORY_H
@@ -3,3 +3,6 @@ TEMPLATE = subdirs
 SUBDIRS = \
         auto \
         downloadspeed
+
+# The benchmarks take long to run, build them with "qmake CONFIG+=benchmarks".
+benchmarks: SUBDIRS += benchmarks
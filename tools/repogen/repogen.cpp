@@ -191,6 +191,19 @@ int main(int argc, char** argv)
                 }
                 repoInfo.repositoryPackages.append(args.first());
                 args.removeFirst();
+            } else if (args.first() == QLatin1String("--delta-from")) {
+                args.removeFirst();
+                if (args.isEmpty()) {
+                    return printErrorAndUsageAndExit(QCoreApplication::translate("QInstaller",
+                        "Error: Delta repository parameter missing argument"));
+                }
+
+                if (!QFileInfo::exists(args.first())) {
+                    return printErrorAndUsageAndExit(QCoreApplication::translate("QInstaller",
+                        "Error: Delta repository not found at the specified location"));
+                }
+                repoInfo.deltaRepositories.append(QInstallerTools::makePathAbsolute(args.first()));
+                args.removeFirst();
             } else if (args.first() == QLatin1String("--ignore-translations")
                 || args.first() == QLatin1String("--ignore-invalid-packages")) {
                     args.removeFirst();